@@ -2,6 +2,10 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 
 // Brilliant little def provided by Mingye Wang 
 //     (https://stackoverflow.com/questions/5867834/assert-with-message)
@@ -31,7 +35,7 @@ void test_add_to_empty_list() {
     
     printf("passed.\n");
 
-    list->teardown(list);
+    list->teardown_keep(list);
 }
 
 void test_insert_at_specific_index() {
@@ -50,6 +54,8 @@ void test_insert_at_specific_index() {
     assertmsg(*(int*)list->get(list, 1) == 20, "Second element is incorrect.");
 
     printf("passed.\n");
+
+    list->teardown_keep(list);
 }
 
 void test_insert_at_head() {
@@ -68,6 +74,8 @@ void test_insert_at_head() {
     assertmsg(*(int*)list->get(list, 1) == 10, "Second element should be 10.");
 
     printf("passed.\n");
+
+    list->teardown_keep(list);
 }
 
 void test_insert_at_end() {
@@ -86,6 +94,8 @@ void test_insert_at_end() {
     assertmsg(*(int*)list->get(list, 1) == 20, "Second element should be 20.");
 
     printf("passed.\n");
+
+    list->teardown_keep(list);
 }
 
 void test_invalid_index_access() {
@@ -99,31 +109,29 @@ void test_invalid_index_access() {
     assertmsg(list->get_or_default(list, 1, NULL) == NULL, "Should return default value for index out of bounds.");
 
     printf("passed.\n");
+
+    list->teardown_keep(list);
 }
 
 void test_delete_by_index() {
     printf("Running test_delete_by_index...");
 
     struct LinkedList* list = createLinkedList();
-    struct LinkedList* list2 = createLinkedList();
 
     int data1[] = {10};
+    add_copy(list, data1);
 
-    list2->add_copy(list2, data1);
-
-    list->add_copy(list, list2);
-
-    printf("Length : %d\n",get_type(list, 0, LinkedList)->length);
-
-    // int data2 = 20;
-    // add_auto(list, &data2);
+    int data2[] = {20};
+    add_copy(list, data2);
 
     list->delete(list, 0);  // Delete element at index 0
 
-    assertmsg(list->length == 0, "List length should be 1 after deletion.");
+    assertmsg(list->length == 1, "List length should be 1 after deletion.");
     assertmsg(*(int*)list->get(list, 0) == 20, "First element should be 20 after deletion.");
 
     printf("passed.\n");
+
+    list->teardown(list);
 }
 
 void test_delete_last_element() {
@@ -137,12 +145,14 @@ void test_delete_last_element() {
     int data2 = 20;
     list->add(list, &data2);
 
-    list->delete(list, 1);  // Delete last element
+    list->delete_keep(list, 1);  // Delete last element (stack data)
 
     assertmsg(list->length == 1, "List length should be 1 after deleting last element.");
     assertmsg(*(int*)list->get(list, 0) == 10, "Last remaining element should be 10.");
 
     printf("passed.\n");
+
+    list->teardown_keep(list);
 }
 
 void test_teardown() {
@@ -150,8 +160,9 @@ void test_teardown() {
 
     struct LinkedList* list = createLinkedList();
 
-    int data = 10;
-    list->add(list, &data);
+    int* data = malloc(sizeof(int));
+    *data = 10;
+    list->add(list, data);
 
     list->teardown(list);  // Teardown and free memory
 
@@ -160,6 +171,1931 @@ void test_teardown() {
     printf("passed.\n");
 }
 
+void test_add_after_deleting_tail() {
+    printf("Running test_add_after_deleting_tail...");
+
+    struct LinkedList* list = createLinkedList();
+
+    int data[] = {10, 20, 30, 40};
+
+    list->add(list, &data[0]);
+    list->add(list, &data[1]);
+    list->add(list, &data[2]);
+
+    list->delete_keep(list, 2);  // Delete last element (the tail)
+    list->add(list, &data[3]);            // Should link after 20, not 30
+
+    assertmsg(list->length == 3, "List length should be 3 after re-adding.");
+    assertmsg(*(int*)list->get(list, 2) == 40, "Last element should be 40.");
+    assertmsg(list->tail->next == NULL, "Tail should be the last node.");
+
+    // Empty the list entirely, then make sure adding still works
+    while(list->length > 0)
+        list->delete_keep(list, 0);
+
+    assertmsg(list->head == NULL && list->tail == NULL, "Empty list should have no head or tail.");
+
+    list->insert(list, 0, &data[0]);  // Insert at index == length
+    list->add(list, &data[1]);
+
+    assertmsg(*(int*)list->get(list, 1) == 20, "Second element should be 20.");
+    assertmsg(list->tail->contents == &data[1], "Tail should hold the last added element.");
+
+    printf("passed.\n");
+
+    list->teardown_keep(list);
+}
+
+void test_pooled_list() {
+    printf("Running test_pooled_list...");
+
+    struct LinkedList* list = createLinkedListWithPool(2);
+
+    // Add more nodes than fit in the first slab
+    for(int i = 0; i < 10; i++) {
+        int* data = malloc(sizeof(int));
+        *data = i;
+        list->add(list, data);
+    }
+
+    assertmsg(list->length == 10, "List length should be 10 after adding.");
+    assertmsg(*(int*)list->get(list, 9) == 9, "Last element should be 9.");
+
+    // A deleted node should be reused by the next insertion
+    struct Node* deleted = list->head;
+    list->delete(list, 0);
+
+    int* data = malloc(sizeof(int));
+    *data = 42;
+    list->insert(list, 3, data);
+
+    assertmsg(list->pool->free_list == NULL, "Deleted node should have been reused.");
+    assertmsg(list->head->next->next->next == deleted, "Inserted node should reuse the deleted node.");
+    assertmsg(*(int*)list->get(list, 3) == 42, "Inserted element should be 42.");
+
+    printf("passed.\n");
+
+    list->teardown(list);
+}
+
+void test_shared_pool() {
+    printf("Running test_shared_pool...");
+
+    NodePool pool = createNodePool(sizeof(struct Node), 4);
+
+    struct LinkedList* list1 = createLinkedListFromPool(pool);
+    struct LinkedList* list2 = createLinkedListFromPool(pool);
+
+    int data[] = {10, 20, 30};
+
+    list1->add(list1, &data[0]);
+    list2->add(list2, &data[1]);
+    list1->add(list1, &data[2]);
+
+    assertmsg(pool->references == 3, "Pool should be referenced by both lists and its creator.");
+
+    // Tearing down one list gives its nodes back to the shared pool
+    list1->teardown_keep(list1);
+
+    assertmsg(pool->references == 2, "Pool should lose a reference on list teardown.");
+    assertmsg(pool->free_list != NULL, "Nodes of a torn down list should be released to the pool.");
+    assertmsg(*(int*)list2->get(list2, 0) == 20, "Other list should be unaffected.");
+
+    pool->teardown(pool);
+
+    list2->add(list2, &data[0]);
+    assertmsg(*(int*)list2->get(list2, 1) == 10, "Pool should outlive its creator's reference.");
+
+    printf("passed.\n");
+
+    list2->teardown_keep(list2);
+}
+
+void test_unrolled_list() {
+    printf("Running test_unrolled_list...");
+
+    UnrolledList list = createUnrolledList(4);
+
+    // Keep a plain array alongside the list to check it against
+    int data[64];
+    int expected[64];
+    int length = 0;
+
+    for(int i = 0; i < 64; i++)
+        data[i] = i;
+
+    // Add to the end, then insert at the front and the middle so that
+    // full nodes have to be split
+    for(int i = 0; i < 20; i++) {
+        list->add(list, &data[i]);
+        expected[length++] = i;
+    }
+
+    for(int i = 20; i < 40; i++) {
+        int index = (i % 2 == 0) ? 0 : length / 2;
+
+        list->insert(list, index, &data[i]);
+
+        memmove(&expected[index + 1], &expected[index], (length - index) * sizeof(int));
+        expected[index] = i;
+        length++;
+    }
+
+    // Delete from the middle and the end so that nodes have to be merged
+    // and freed
+    for(int i = 0; i < 25; i++) {
+        int index = (i % 3 == 0) ? length - 1 : length / 3;
+
+        list->delete_keep(list, index);
+
+        memmove(&expected[index], &expected[index + 1], (length - index - 1) * sizeof(int));
+        length--;
+    }
+
+    assertmsg(list->length == length, "List length should match the number of contents.");
+
+    for(int i = 0; i < length; i++)
+        assertmsg(*(int*)list->get(list, i) == expected[i], "Contents should be in insertion order.");
+
+    assertmsg(list->get_or_default(list, length, NULL) == NULL, "Should return default value for index out of bounds.");
+
+    // The tail should still be the last node after all of the splits and
+    // merges
+    list->add(list, &data[63]);
+    assertmsg(list->tail->next == NULL, "Tail should be the last node.");
+    assertmsg(*(int*)list->get(list, length) == 63, "Added element should be last.");
+
+    printf("passed.\n");
+
+    list->teardown_keep(list);
+}
+
+void test_vector() {
+    printf("Running test_vector...");
+
+    Vector vector = createVector();
+
+    int data[] = {10, 20, 30, 40};
+
+    vector->add(vector, &data[0]);
+    vector->add(vector, &data[2]);
+    vector->insert(vector, 1, &data[1]);   // Insert in the middle
+    vector->insert(vector, 5, &data[3]);   // Insert past the end
+
+    assertmsg(vector->length == 6, "Vector length should be 6 after inserting past the end.");
+    assertmsg(*(int*)vector->get(vector, 1) == 20, "Second element should be 20.");
+    assertmsg(*(int*)vector->get(vector, 2) == 30, "Third element should be 30.");
+    assertmsg(vector->get(vector, 4) == NULL, "Gap should be filled with NULL.");
+    assertmsg(*(int*)vector->get(vector, 5) == 40, "Last element should be 40.");
+
+    vector->delete_keep(vector, 0);
+    vector->delete_keep(vector, 2);
+
+    assertmsg(vector->length == 4, "Vector length should be 4 after deleting.");
+    assertmsg(*(int*)vector->get(vector, 0) == 20, "First element should be 20 after deleting.");
+    assertmsg(vector->get_or_default(vector, 4, NULL) == NULL, "Should return default value for index out of bounds.");
+
+    vector->reserve(vector, 100);
+    assertmsg(vector->capacity >= 100, "Vector should have room for 100 after reserving.");
+
+    vector->shrink_to_fit(vector);
+    assertmsg(vector->capacity == 4, "Vector capacity should match its length after shrinking.");
+
+    printf("passed.\n");
+
+    vector->teardown_keep(vector);
+}
+
+void test_string_hash_map() {
+    printf("Running test_string_hash_map...");
+
+    HashMap map = createStringHashMap();
+
+    char* keys[] = {"apple", "banana", "cherry", "date", "elderberry"};
+
+    for(int i = 0; i < 5; i++) {
+        int* value = malloc(sizeof(int));
+        *value = i;
+        map->put(map, strdup(keys[i]), value);
+    }
+
+    assertmsg(map->length == 5, "Map length should be 5 after putting.");
+    assertmsg(*(int*)map->get(map, "cherry") == 2, "Value of cherry should be 2.");
+    assertmsg(map->get(map, "fig") == NULL, "Should return NULL for missing key.");
+
+    // Replacing a value frees the old key and value
+    int* value = malloc(sizeof(int));
+    *value = 42;
+    map->put(map, strdup("banana"), value);
+
+    assertmsg(map->length == 5, "Map length should not change when replacing.");
+    assertmsg(*(int*)map->get(map, "banana") == 42, "Value of banana should be replaced.");
+
+    assertmsg(map->remove(map, "apple") == 1, "Removing a key should succeed.");
+    assertmsg(map->remove(map, "apple") == 0, "Removing a missing key should fail.");
+    assertmsg(map->get_or_default(map, "apple", keys[0]) == keys[0], "Should return default value for removed key.");
+    assertmsg(*(int*)map->get(map, "elderberry") == 4, "Other keys should be unaffected by removal.");
+
+    printf("passed.\n");
+
+    map->teardown(map);
+}
+
+void test_int_hash_map() {
+    printf("Running test_int_hash_map...");
+
+    HashMap map = createIntHashMap();
+
+    int values[1000];
+
+    // Put enough keys that the table has to grow several times
+    for(int i = 0; i < 1000; i++) {
+        values[i] = i * 3;
+        map->put(map, int_key(i * 7919), &values[i]);
+    }
+
+    // Remove every other key, which shifts back the entries after them
+    for(int i = 0; i < 1000; i += 2)
+        map->remove_keep(map, int_key(i * 7919));
+
+    assertmsg(map->length == 500, "Map length should be 500 after removing.");
+
+    for(int i = 0; i < 1000; i++) {
+        if(i % 2 == 0)
+            assertmsg(map->get(map, int_key(i * 7919)) == NULL, "Removed keys should be missing.");
+        else
+            assertmsg(*(int*)map->get(map, int_key(i * 7919)) == i * 3, "Remaining keys should keep their values.");
+    }
+
+    map->reserve(map, 10000);
+    assertmsg(map->capacity >= 10000, "Map should have room for 10000 keys after reserving.");
+    assertmsg(*(int*)map->get(map, int_key(999 * 7919)) == 999 * 3, "Keys should survive reserving.");
+
+    printf("passed.\n");
+
+    map->teardown_keep(map);
+}
+
+void add_to_sum(void* contents, void* sum) {
+    *(int*)sum += *(int*)contents;
+}
+
+void test_iterator() {
+    printf("Running test_iterator...");
+
+    struct LinkedList* list = createLinkedList();
+
+    // The contents are on the stack, so the list must never free them
+    list->auto_free = 0;
+
+    int data[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    for(int i = 0; i < 10; i++)
+        list->add(list, &data[i]);
+
+    // Remove the even numbers and insert a copy after every odd number in
+    // a single pass
+    struct ListIterator it = list->begin(list);
+
+    while(it.has_next(&it)) {
+        int* contents = it.next(&it);
+
+        if(*contents % 2 == 0) {
+            it.remove_current(&it);
+        }
+        else {
+            it.insert_after_current(&it, contents);
+            it.next(&it);  // Skip over the inserted copy
+        }
+    }
+
+    int expected[] = {1, 1, 3, 3, 5, 5, 7, 7, 9, 9};
+
+    assertmsg(list->length == 10, "List length should be 10 after iterating.");
+    assertmsg(it.index == 9, "Iterator should end at the last index.");
+    assertmsg(list->tail->contents == &data[9], "Tail should be the inserted copy of 9.");
+
+    it = list->begin(list);
+    for(int i = 0; it.has_next(&it); i++)
+        assertmsg(*(int*)it.next(&it) == expected[i], "Contents should match after removing and inserting.");
+
+    // Inserting before the first call to next inserts at the head
+    it = list->begin(list);
+    it.insert_after_current(&it, &data[0]);
+    assertmsg(*(int*)it.next(&it) == 0, "Inserted node should be returned next.");
+    assertmsg(list->head->contents == &data[0], "Inserted node should be the head.");
+
+    int sum = 0;
+    list_foreach(list, add_to_sum, &sum);
+    assertmsg(sum == 50, "Sum over list_foreach should be 50.");
+
+    printf("passed.\n");
+
+    list->teardown_keep(list);
+}
+
+void test_bulk_operations() {
+    printf("Running test_bulk_operations...");
+
+    struct LinkedList* list = createLinkedListWithPool(4);
+    struct LinkedList* other = createLinkedListFromPool(list->pool);
+
+    int data[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    void* contents[10];
+
+    for(int i = 0; i < 10; i++)
+        contents[i] = &data[i];
+
+    list->add_many(list, contents, 4);          // 0 1 2 3
+    other->add_many(other, contents + 4, 3);    // 4 5 6
+
+    list->extend(list, other);                  // 0 1 2 3 4 5 6
+
+    assertmsg(list->length == 7 && other->length == 0, "Extend should move every node.");
+    assertmsg(list->tail->contents == &data[6], "Tail should be the last moved node.");
+
+    other->add_many(other, contents + 7, 3);    // 7 8 9
+    list->splice(list, 2, other);               // 0 1 7 8 9 2 3 4 5 6
+
+    assertmsg(list->length == 10 && other->length == 0, "Splice should move every node.");
+    assertmsg(*(int*)list->get(list, 2) == 7 && *(int*)list->get(list, 5) == 2, "Splice should insert at the index.");
+
+    list->auto_free = 0;
+
+    list->delete_range(list, 1, 4);  // 0 9 2 3 4 5 6
+    list->delete_range(list, 5, 7);  // 0 9 2 3 4
+
+    int expected[] = {0, 9, 2, 3, 4};
+
+    assertmsg(list->length == 5, "List length should be 5 after deleting ranges.");
+    for(int i = 0; i < 5; i++)
+        assertmsg(*(int*)list->get(list, i) == expected[i], "Contents should match after deleting ranges.");
+
+    assertmsg(list->tail->contents == &data[4] && list->tail->next == NULL, "Tail should be moved back by delete_range.");
+    assertmsg(list->delete_range(list, 3, 6) == 0, "Deleting a range past the end should fail.");
+
+    printf("passed.\n");
+
+    other->teardown_keep(other);
+    list->teardown_keep(list);
+}
+
+#define STRESS_THREADS 4
+#define STRESS_ADDS 500
+#define STRESS_DELETES 250
+
+// Contents shared by every thread in the stress test (these are never
+// freed, so readers can safely look at contents that were just deleted)
+int stress_data[STRESS_ADDS];
+
+void* stress_adder(void* list_pointer) {
+    ConcurrentList list = list_pointer;
+
+    for(int i = 0; i < STRESS_ADDS; i++) {
+
+        // Mix adding at the end with inserting at the front
+        if(i % 2 == 0)
+            list->add(list, &stress_data[i]);
+        else
+            list->insert(list, 0, &stress_data[i]);
+    }
+
+    return NULL;
+}
+
+void* stress_deleter(void* list_pointer) {
+    ConcurrentList list = list_pointer;
+
+    // Keep deleting the front node, retrying while the list is empty
+    for(int deleted = 0; deleted < STRESS_DELETES; ) {
+        if(list->delete_keep(list, 0))
+            deleted++;
+        else
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+void* stress_reader(void* list_pointer) {
+    ConcurrentList list = list_pointer;
+
+    int default_value = -1;
+
+    for(int i = 0; i < 2000; i++) {
+        int* data = list->get_or_default(list, i % 64, &default_value);
+
+        assertmsg(data == &default_value || (data >= stress_data && data < stress_data + STRESS_ADDS), "Readers should only see valid contents.");
+        assertmsg(*data == -1 || *data == data - stress_data, "Readers should only see valid contents.");
+    }
+
+    return NULL;
+}
+
+void test_concurrent_list_stress() {
+    printf("Running test_concurrent_list_stress...");
+
+    ConcurrentList list = createConcurrentList();
+
+    for(int i = 0; i < STRESS_ADDS; i++)
+        stress_data[i] = i;
+
+    pthread_t adders[STRESS_THREADS];
+    pthread_t readers[STRESS_THREADS];
+    pthread_t deleter;
+
+    for(int i = 0; i < STRESS_THREADS; i++) {
+        pthread_create(&adders[i], NULL, stress_adder, list);
+        pthread_create(&readers[i], NULL, stress_reader, list);
+    }
+
+    pthread_create(&deleter, NULL, stress_deleter, list);
+
+    for(int i = 0; i < STRESS_THREADS; i++) {
+        pthread_join(adders[i], NULL);
+        pthread_join(readers[i], NULL);
+    }
+
+    pthread_join(deleter, NULL);
+
+    int expected_length = STRESS_THREADS * STRESS_ADDS - STRESS_DELETES;
+
+    assertmsg(list->length == expected_length, "List length should account for every add and delete.");
+
+    // Count the nodes by hand to make sure none were lost or duplicated
+    int num_nodes = 0;
+    for(struct ConcurrentNode* node = list->head.next; node != NULL; node = node->next)
+        num_nodes++;
+
+    assertmsg(num_nodes == expected_length, "Number of linked nodes should match the list length.");
+
+    printf("passed.\n");
+
+    list->teardown_keep(list);
+}
+
+#define QUEUE_THREADS 4
+#define QUEUE_ITEMS 5000
+
+// Contents shared by every producer, and the number of times each was
+// dequeued by a consumer
+int queue_data[QUEUE_THREADS * QUEUE_ITEMS];
+_Atomic int queue_seen[QUEUE_THREADS * QUEUE_ITEMS];
+_Atomic int queue_consumed;
+
+void* queue_producer(void* queue_pointer) {
+    LockFreeQueue queue = queue_pointer;
+
+    static _Atomic int next_producer = 0;
+    int producer = next_producer++;
+
+    for(int i = 0; i < QUEUE_ITEMS; i++)
+        queue->enqueue(queue, &queue_data[producer * QUEUE_ITEMS + i]);
+
+    return NULL;
+}
+
+void* queue_consumer(void* queue_pointer) {
+    LockFreeQueue queue = queue_pointer;
+
+    // Items from a single producer must come out in the order they went in
+    int last_seen[QUEUE_THREADS];
+    for(int i = 0; i < QUEUE_THREADS; i++)
+        last_seen[i] = -1;
+
+    while(queue_consumed < QUEUE_THREADS * QUEUE_ITEMS) {
+        int* data = queue->dequeue(queue);
+
+        if(data == NULL) {
+            sched_yield();
+            continue;
+        }
+
+        queue_consumed++;
+        queue_seen[*data]++;
+
+        int producer = *data / QUEUE_ITEMS;
+        assertmsg(*data > last_seen[producer], "Items from one producer should be dequeued in order.");
+        last_seen[producer] = *data;
+    }
+
+    return NULL;
+}
+
+void test_lock_free_queue() {
+    printf("Running test_lock_free_queue...");
+
+    LockFreeQueue queue = createLockFreeQueue();
+
+    for(int i = 0; i < QUEUE_THREADS * QUEUE_ITEMS; i++)
+        queue_data[i] = i;
+
+    pthread_t producers[QUEUE_THREADS];
+    pthread_t consumers[QUEUE_THREADS];
+
+    for(int i = 0; i < QUEUE_THREADS; i++) {
+        pthread_create(&producers[i], NULL, queue_producer, queue);
+        pthread_create(&consumers[i], NULL, queue_consumer, queue);
+    }
+
+    for(int i = 0; i < QUEUE_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+
+    for(int i = 0; i < QUEUE_THREADS * QUEUE_ITEMS; i++)
+        assertmsg(queue_seen[i] == 1, "Every item should be dequeued exactly once.");
+
+    assertmsg(queue->length == 0, "Queue should be empty after consuming every item.");
+    assertmsg(queue->dequeue(queue) == NULL, "Dequeuing from an empty queue should return NULL.");
+
+    // Items left in the queue are freed on teardown
+    int* data = malloc(sizeof(int));
+    queue->enqueue(queue, data);
+
+    printf("passed.\n");
+
+    queue->teardown(queue);
+}
+
+void test_doubly_linked_list() {
+    printf("Running test_doubly_linked_list...");
+
+    DoublyLinkedList list = createDoublyLinkedList();
+
+    int data[] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+    // Use it as a deque : 2 1 0 3 4
+    list->add(list, &data[0]);
+    list->push_front(list, &data[1]);
+    list->push_front(list, &data[2]);
+    list->add(list, &data[3]);
+    list->add(list, &data[4]);
+
+    // Insert close to the tail and close to the head : 2 5 1 0 3 6 4
+    list->insert(list, 4, &data[6]);
+    list->insert(list, 1, &data[5]);
+
+    int expected[] = {2, 5, 1, 0, 3, 6, 4};
+
+    assertmsg(list->length == 7, "List length should be 7 after inserting.");
+    for(int i = 0; i < 7; i++)
+        assertmsg(*(int*)list->get(list, i) == expected[i], "Contents should match from either end.");
+
+    // Delete close to the tail : 2 5 1 0 3 4
+    list->delete_keep(list, 5);
+    assertmsg(*(int*)list->get(list, 5) == 4 && *(int*)list->get(list, 4) == 3, "Delete should link around the node.");
+
+    assertmsg(*(int*)list->pop_back(list) == 4, "pop_back should return the last element.");
+    assertmsg(*(int*)list->pop_front(list) == 2, "pop_front should return the first element.");
+    assertmsg(list->length == 4, "List length should be 4 after popping.");
+    assertmsg(list->head->prev == NULL && list->tail->next == NULL, "Head and tail should be the ends of the list.");
+
+    while(list->length > 0)
+        list->pop_back(list);
+
+    assertmsg(list->head == NULL && list->tail == NULL, "Empty list should have no head or tail.");
+    assertmsg(list->pop_front(list) == NULL, "Popping from an empty list should return NULL.");
+    assertmsg(list->get_or_default(list, 0, NULL) == NULL, "Should return default value for index out of bounds.");
+
+    printf("passed.\n");
+
+    list->teardown_keep(list);
+}
+
+void test_inline_nodes() {
+    printf("Running test_inline_nodes...");
+
+    // Plain and pooled lists both keep inline nodes out of the pool
+    LinkedList lists[] = {createLinkedList(), createLinkedListWithPool(4)};
+
+    for(int l = 0; l < 2; l++) {
+        LinkedList list = lists[l];
+
+        for(long long i = 0; i < 8; i++)
+            list->add_inline(list, &i, sizeof(i));
+
+        // Mix in some nodes which point at their contents
+        int* heap_data = malloc(sizeof(int));
+        *heap_data = 100;
+        list->insert(list, 4, heap_data);
+
+        int data[] = {1, 2, 3};
+        add_copy(list, data);
+
+        long long value = 0;
+        assertmsg(list->length == 10 && list->inline_nodes == 9, "Inline nodes should be counted.");
+        assertmsg(list->get_inline(list, 7, &value, sizeof(value)) && value == 6, "get_inline should copy the inline contents out.");
+        assertmsg(*(int*)list->get(list, 4) == 100, "Nodes which do not store their contents inline should be unaffected.");
+        assertmsg(((int*)list->get(list, 9))[2] == 3, "add_copy should copy the whole array inline.");
+        assertmsg(!list->get_inline(list, 10, &value, sizeof(value)), "get_inline should fail for index out of bounds.");
+
+        // The contents of inline nodes are freed with the node, whether or
+        // not they are auto freed
+        list->delete(list, 0);
+        list->delete_keep(list, 0);
+        list->delete_range(list, 0, 2);
+
+        struct ListIterator it = list->begin(list);
+        it.next(&it);
+        it.remove_current(&it);
+
+        assertmsg(list->length == 5 && list->inline_nodes == 5, "Deleting inline nodes should update the count.");
+        assertmsg(list->get_inline(list, 0, &value, sizeof(value)) && value == 4, "Deletes should unlink inline nodes.");
+
+        // Spliced inline nodes now belong to the other list
+        LinkedList other = l == 0 ? createLinkedList() : createLinkedListFromPool(list->pool);
+        long long extra = 42;
+        other->add_inline(other, &extra, sizeof(extra));
+        list->extend(list, other);
+        other->teardown(other);
+
+        assertmsg(list->inline_nodes == 6, "Spliced inline nodes should be counted.");
+
+        // (the pooled list still has to visit its inline nodes to free them)
+        if(l == 0)
+            list->teardown(list);
+        else
+            list->teardown_keep(list);
+    }
+
+    // Other lists copy the contents, and free the copies like other contents
+    Vector vector = createVector();
+    int data[] = {7, 8};
+    add_copy(vector, data);
+    assertmsg(((int*)vector->get(vector, 0))[1] == 8, "add_copy should copy into a vector.");
+    vector->teardown(vector);
+
+    printf("passed.\n");
+}
+
+int compare_ints(void* a, void* b) {
+    return *(int*)a - *(int*)b;
+}
+
+void test_skip_list() {
+    printf("Running test_skip_list...");
+
+    SkipList list = createSkipList(compare_ints);
+
+    // Insert values out of order (with duplicates), keeping a sorted copy
+    // of them to check against
+    static int values[1000];
+    int sorted[1000];
+
+    for(int i = 0; i < 1000; i++) {
+        values[i] = (i * 7919) % 500;
+
+        int j = i;
+        while(j > 0 && sorted[j - 1] > values[i]) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = values[i];
+
+        list->insert_sorted(list, &values[i]);
+    }
+
+    assertmsg(list->length == 1000, "List length should be 1000 after inserting.");
+    for(int i = 0; i < 1000; i++)
+        assertmsg(*(int*)list->get(list, i) == sorted[i], "Contents should be sorted, and found by index.");
+
+    // Equal contents keep the order they were inserted in
+    assertmsg(list->get(list, 0) == &values[0] && list->get(list, 1) == &values[500], "Equal contents should stay in insertion order.");
+
+    int present = 250, missing = 1000;
+    assertmsg(list->find(list, &present) == 500, "find should return the index of the first equal node.");
+    assertmsg(list->find(list, &missing) == -1, "find should return -1 for missing contents.");
+
+    // Delete from the front, middle and back, checking every index
+    int length = 1000;
+    for(int round = 0; round < 600; round++) {
+        int index = (round * 31) % length;
+
+        list->delete_keep(list, index);
+
+        for(int i = index; i < length - 1; i++)
+            sorted[i] = sorted[i + 1];
+        length--;
+    }
+
+    assertmsg(list->length == length, "List length should shrink after deleting.");
+    for(int i = 0; i < length; i++)
+        assertmsg(*(int*)list->get(list, i) == sorted[i], "Contents should stay sorted after deleting.");
+
+    assertmsg(list->delete(list, length) == 0, "Deleting out of bounds should fail.");
+    assertmsg(list->get_or_default(list, length, NULL) == NULL, "Should return default value for index out of bounds.");
+
+    list->teardown_keep(list);
+
+    // Contents are freed on delete and teardown by default
+    list = createSkipList(compare_ints);
+    for(int i = 0; i < 100; i++) {
+        int* value = malloc(sizeof(int));
+        *value = 100 - i;
+        list->insert_sorted(list, value);
+    }
+    list->delete(list, 0);
+    assertmsg(*(int*)list->get(list, 0) == 2, "Deleting the first node should leave the next smallest.");
+
+    printf("passed.\n");
+
+    list->teardown(list);
+}
+
+void* square(void* contents, void* ctx) {
+    long long* result = malloc(sizeof(long long));
+    *result = (long long) *(int*)contents * *(int*)contents + *(int*)ctx;
+    return result;
+}
+
+int is_multiple(void* contents, void* ctx) {
+    return *(int*)contents % *(int*)ctx == 0;
+}
+
+void* sum(void* left, void* right, void* ctx) {
+    return int_key((long long) left + (long long) right);
+}
+
+// Applies the affine map a * x + b (mod 65521) stored in left, and then the
+// one stored in right. This is associative, but the order of the maps
+// matters.
+void* compose_affine(void* left, void* right, void* ctx) {
+    long long a1 = (long long) left >> 32, b1 = (long long) left & 0xffffffff;
+    long long a2 = (long long) right >> 32, b2 = (long long) right & 0xffffffff;
+
+    return int_key((a1 * a2 % 65521) << 32 | (a2 * b1 + b2) % 65521);
+}
+
+void test_parallel_operations() {
+    printf("Running test_parallel_operations...");
+
+    static int data[10000];
+
+    LinkedList list = createLinkedList();
+    for(int i = 0; i < 10000; i++) {
+        data[i] = i;
+        list->add(list, &data[i]);
+    }
+
+    int one = 1, three = 3;
+
+    int thread_counts[] = {1, 3, 8, 64};
+
+    for(int t = 0; t < 4; t++) {
+        int num_threads = thread_counts[t];
+
+        LinkedList squares = list_parallel_map(list, square, &one, num_threads);
+        assertmsg(squares->length == 10000, "Map should produce one result per node.");
+
+        struct ListIterator it = squares->begin(squares);
+        for(long long i = 0; it.has_next(&it); i++)
+            assertmsg(*(long long*)it.next(&it) == i * i + 1, "Map results should be in order.");
+        assertmsg(squares->tail != NULL && *(long long*)squares->tail->contents == 9999LL * 9999 + 1, "Map should set the tail.");
+
+        LinkedList multiples = list_parallel_filter(list, is_multiple, &three, num_threads);
+        assertmsg(multiples->length == 3334, "Filter should keep every multiple of 3.");
+
+        it = multiples->begin(multiples);
+        for(int i = 0; it.has_next(&it); i += 3)
+            assertmsg(it.next(&it) == &data[i], "Filter should keep the original contents, in order.");
+
+        LinkedList values = createLinkedList();
+        for(long long i = 0; i < 10000; i++)
+            values->add(values, int_key(i));
+
+        long long total = (long long) list_parallel_reduce(values, sum, int_key(5), NULL, num_threads);
+        assertmsg(total == 5 + 9999LL * 10000 / 2, "Reduce should combine every node.");
+        values->teardown_keep(values);
+
+        squares->teardown(squares);
+        multiples->teardown_keep(multiples);
+    }
+
+    // Chunks are combined in order, so an order dependent (but associative)
+    // function gives the same result as combining one node at a time
+    LinkedList maps = createLinkedList();
+    void* expected = int_key(1LL << 32);
+    for(long long i = 0; i < 1000; i++) {
+        void* map = int_key((i % 7 + 2) << 32 | i % 11);
+        maps->add(maps, map);
+        expected = compose_affine(expected, map, NULL);
+    }
+    assertmsg(list_parallel_reduce(maps, compose_affine, int_key(1LL << 32), NULL, 4) == expected, "Reduce should combine chunks in order.");
+    maps->teardown_keep(maps);
+
+    // Empty lists give empty results
+    LinkedList empty = createLinkedList();
+    LinkedList mapped = list_parallel_map(empty, square, &one, 4);
+    assertmsg(mapped->length == 0 && mapped->head == NULL, "Mapping an empty list should give an empty list.");
+    assertmsg(list_parallel_reduce(empty, sum, int_key(7), NULL, 4) == int_key(7), "Reducing an empty list should give the initial value.");
+    mapped->teardown(mapped);
+    empty->teardown(empty);
+
+    printf("passed.\n");
+
+    list->teardown_keep(list);
+}
+
+struct SortRecord {
+    int key;
+    int order;
+};
+
+int compare_records(void* a, void* b) {
+    return ((struct SortRecord*)a)->key - ((struct SortRecord*)b)->key;
+}
+
+void test_sort() {
+    printf("Running test_sort...");
+
+    static struct SortRecord records[2000];
+
+    for(int mode = 0; mode < 2; mode++) {
+        int lengths[] = {0, 1, 2, 17, 2000};
+
+        for(int l = 0; l < 5; l++) {
+            LinkedList list = createLinkedList();
+
+            for(int i = 0; i < lengths[l]; i++) {
+                records[i].key = (i * 7919) % 37;
+                records[i].order = i;
+                list->add(list, &records[i]);
+            }
+
+            if(mode == 0)
+                list->sort(list, compare_records);
+            else
+                list->sort_via_array(list, compare_records);
+
+            assertmsg(list->length == lengths[l], "Sorting should keep every node.");
+
+            struct SortRecord* previous = NULL;
+            int count = 0;
+
+            for(Node node = list->head; node != NULL; node = node->next) {
+                struct SortRecord* current = node->contents;
+
+                if(previous != NULL) {
+                    assertmsg(previous->key <= current->key, "Contents should be sorted.");
+                    if(previous->key == current->key)
+                        assertmsg(previous->order < current->order, "Sorting should be stable.");
+                }
+
+                previous = current;
+                count++;
+            }
+
+            assertmsg(count == lengths[l], "Sorted list should have every node linked.");
+            assertmsg(list->tail == NULL ? lengths[l] == 0 : list->tail->contents == previous && list->tail->next == NULL, "Tail should be the last sorted node.");
+
+            // The list still works after sorting
+            list->add(list, &records[0]);
+            assertmsg(list->get(list, lengths[l]) == &records[0], "Adding after sorting should add to the end.");
+
+            list->teardown_keep(list);
+        }
+    }
+
+    // Lists with inline nodes are sorted by relinking
+    LinkedList list = createLinkedList();
+    for(int i = 0; i < 100; i++) {
+        struct SortRecord record = {100 - i, i};
+        list->add_inline(list, &record, sizeof(record));
+    }
+    list->sort_via_array(list, compare_records);
+    assertmsg(((struct SortRecord*)list->get(list, 0))->key == 1, "Inline contents should be sorted.");
+
+    printf("passed.\n");
+
+    list->teardown(list);
+}
+
+size_t string_size(void* contents) {
+    return strlen(contents) + 1;
+}
+
+void test_serialization() {
+    printf("Running test_serialization...");
+
+    char* words[] = {"alpha", "beta", NULL, "gamma", "a much longer string than the others", ""};
+
+    LinkedList list = createLinkedList();
+    for(int i = 0; i < 6; i++)
+        list->add(list, words[i]);
+
+    FILE* file = tmpfile();
+    int fd = fileno(file);
+
+    assertmsg(list_serialize(list, fd, string_size), "Serializing should succeed.");
+
+    LinkedList loaded = list_deserialize(fd);
+    assertmsg(loaded != NULL && loaded->length == 6, "Loaded list should have every node.");
+
+    for(int i = 0; i < 6; i++) {
+        char* contents = loaded->get(loaded, i);
+
+        if(words[i] == NULL)
+            assertmsg(contents == NULL, "NULL contents should be loaded as NULL.");
+        else
+            assertmsg(strcmp(contents, words[i]) == 0 && (long long) contents % 8 == 0, "Contents should be loaded, and aligned.");
+    }
+
+    // Contents in the mapping are never freed, but other contents are
+    ((char*) loaded->get(loaded, 0))[0] = 'A';
+    loaded->delete(loaded, 1);
+    loaded->delete(loaded, 1);
+    loaded->add(loaded, strdup("delta"));
+    loaded->sort_via_array(loaded, (int (*)(void*, void*)) strcmp);
+    assertmsg(strcmp(loaded->get(loaded, 0), "") == 0 && strcmp(loaded->get(loaded, 1), "Alpha") == 0, "Loaded contents should be writable, and sortable.");
+
+    // Moving the nodes to another list moves the mapping too
+    LinkedList other = createLinkedListFromPool(loaded->pool);
+    other->extend(other, loaded);
+    assertmsg(other->mapping != NULL && loaded->mapping == NULL, "The mapping should move with the contents.");
+
+    loaded->teardown(loaded);
+    other->teardown(other);
+
+    // Files which are not lists, or which are cut short, are not loaded
+    assertmsg(ftruncate(fd, 40) == 0, "Truncating should succeed.");
+    assertmsg(list_deserialize(fd) == NULL, "Loading a truncated file should fail.");
+
+    assertmsg(ftruncate(fd, 0) == 0 && pwrite(fd, "not a list file!", 16, 0) == 16, "Writing should succeed.");
+    assertmsg(list_deserialize(fd) == NULL, "Loading a file which is not a list should fail.");
+
+    fclose(file);
+
+    printf("passed.\n");
+
+    list->teardown_keep(list);
+}
+
+void test_list_stats() {
+    printf("Running test_list_stats...");
+
+    LinkedList list = createLinkedList();
+
+    static int data[] = {1, 2, 3, 4};
+    long long inline_data = 5;
+
+    list->add(list, &data[0]);
+    list->add(list, &data[1]);
+    list->add(list, &data[2]);
+    list->insert(list, 1, &data[3]);
+    list->get(list, 3);
+    list->get_or_default(list, 10, NULL);
+    list->add_inline(list, &inline_data, sizeof(inline_data));
+    list->delete_keep(list, 2);
+
+    struct ListStats stats = list_get_stats(list);
+
+    #ifdef DS_STATS
+        assertmsg(stats.adds == 4 && stats.inserts == 1 && stats.gets == 2 && stats.deletes == 1, "Operations should be counted by type.");
+        // (get reads the tail directly, and insert leaves the finger on the
+        // new node, so only delete walks from the head, past one node)
+        assertmsg(stats.nodes_traversed == 1, "Nodes walked past should be counted.");
+        assertmsg(stats.mallocs == 5 && stats.frees == 1, "Calls to malloc and free should be counted.");
+        assertmsg(stats.bytes_allocated == 5 * sizeof(struct Node) + sizeof(inline_data), "Bytes allocated should be counted.");
+        assertmsg(stats.peak_length == 5, "The longest length should be kept.");
+    #else
+        assertmsg(stats.adds == 0 && stats.nodes_traversed == 0 && stats.mallocs == 0 && stats.peak_length == 0, "Stats should be 0 when they are not kept.");
+    #endif
+
+    // The dump is one JSON object holding every count
+    char dump[512];
+    FILE* stream = fmemopen(dump, sizeof(dump), "w");
+    assertmsg(list_dump_stats(list, stream), "Dumping stats should succeed.");
+    fclose(stream);
+
+    char expected[64];
+    snprintf(expected, sizeof(expected), "\"peak_length\": %lld}", stats.peak_length);
+    assertmsg(dump[0] == '{' && strstr(dump, "\"adds\": ") != NULL && strstr(dump, expected) != NULL, "Dump should be a JSON object of the counts.");
+
+    printf("passed.\n");
+
+    list->teardown_keep(list);
+}
+
+// Wraps the stdlib allocator, counting the memory it hands out and takes back
+struct CountingAllocator {
+    long long allocs;
+    long long frees;
+};
+
+void* counting_alloc(void* ctx, size_t size) {
+    ((struct CountingAllocator*) ctx)->allocs++;
+    return malloc(size);
+}
+
+void counting_free(void* ctx, void* pointer) {
+    ((struct CountingAllocator*) ctx)->frees++;
+    free(pointer);
+}
+
+#define ALLOCATOR_THREADS 4
+#define ALLOCATOR_ADDS 2000
+
+void* allocator_worker(void* list_pointer) {
+    ConcurrentList list = (ConcurrentList) list_pointer;
+
+    for(int i = 0; i < ALLOCATOR_ADDS; i++) {
+        list->add(list, NULL);
+
+        // Deleted nodes go into this thread's cache, and are reused by
+        // its next adds
+        if(i % 2 == 1)
+            list->delete_keep(list, 0);
+    }
+
+    return NULL;
+}
+
+void test_allocators() {
+    printf("Running test_allocators...");
+
+    // Every structure should get all of its memory from its allocator, and
+    // give all of it back when torn down
+    struct CountingAllocator counts = {0, 0};
+    struct Allocator counting = {counting_alloc, counting_free, NULL, NULL, &counts};
+
+    static int data[] = {5, 3, 8, 1, 9, 2};
+
+    LinkedList list = createLinkedListWithAllocator(&counting);
+    UnrolledList unrolled = createUnrolledListWithAllocator(4, &counting);
+    Vector vector = createVectorWithAllocator(&counting);
+    HashMap map = createHashMapWithAllocator(hash_int, equals_int, &counting);
+    DoublyLinkedList doubly = createDoublyLinkedListWithAllocator(&counting);
+    SkipList skip = createSkipListWithAllocator(compare_ints, &counting);
+
+    for(int i = 0; i < 6; i++) {
+        list->add(list, &data[i]);
+        unrolled->add(unrolled, &data[i]);
+        vector->add(vector, &data[i]);
+        map->put(map, int_key(i), &data[i]);
+        doubly->add(doubly, &data[i]);
+        skip->insert_sorted(skip, &data[i]);
+    }
+
+    list->add_inline(list, &data[0], sizeof(int));
+    list->delete_keep(list, 0);
+    list->sort_via_array(list, compare_ints);
+    unrolled->delete_keep(unrolled, 0);
+    vector->shrink_to_fit(vector);
+    doubly->pop_front(doubly);
+    skip->delete_keep(skip, 0);
+
+    assertmsg(*(int*) list->get(list, 0) == 1 && *(int*) vector->get(vector, 5) == 2, "Structures should work the same with any allocator.");
+    assertmsg(*(int*) skip->get(skip, 0) == 2 && *(int*) map->get(map, int_key(3)) == 1, "Structures should work the same with any allocator.");
+    assertmsg(counts.allocs > 0 && counts.frees > 0, "Structures should allocate from their allocator.");
+
+    list->teardown_keep(list);
+    unrolled->teardown_keep(unrolled);
+    vector->teardown_keep(vector);
+    map->teardown_keep(map);
+    doubly->teardown_keep(doubly);
+    skip->teardown_keep(skip);
+
+    assertmsg(counts.allocs == counts.frees, "Torn down structures should give back all of their memory.");
+
+    // A bump allocator frees everything at once, so its structures don't
+    // need to be torn down
+    Allocator bump = createBumpAllocator(256);
+
+    LinkedList bump_list = createLinkedListWithAllocator(bump);
+    Vector bump_vector = createVectorWithAllocator(bump);
+
+    for(int i = 0; i < 1000; i++) {
+        bump_list->add(bump_list, &data[i % 6]);
+        bump_vector->add(bump_vector, &data[i % 6]);
+    }
+
+    // Bigger than a block
+    long long big[64] = {0};
+    big[63] = 42;
+    bump_list->add_inline(bump_list, big, sizeof(big));
+
+    assertmsg(bump_list->length == 1001 && bump_vector->length == 1000, "Structures should grow on a bump allocator.");
+    assertmsg(*(int*) bump_vector->get(bump_vector, 999) == data[999 % 6], "Vectors should keep their contents when grown on a bump allocator.");
+    assertmsg(((long long*) bump_list->get(bump_list, 1000))[63] == 42, "Allocations bigger than a block should get a block of their own.");
+
+    bump->teardown(bump);
+
+    // Memory freed to a caching allocator is reused by the same thread
+    Allocator caching = createCachingAllocator();
+
+    void* first = caching->alloc(caching->ctx, 24);
+    caching->free(caching->ctx, first);
+    void* second = caching->alloc(caching->ctx, 32);
+
+    assertmsg(first == second, "Freed memory should be reused for the same size.");
+
+    caching->free(caching->ctx, second);
+
+    // Caching allocators are thread safe, so they can be shared
+    ConcurrentList concurrent = createConcurrentListWithAllocator(caching);
+
+    pthread_t workers[ALLOCATOR_THREADS];
+
+    for(int i = 0; i < ALLOCATOR_THREADS; i++)
+        pthread_create(&workers[i], NULL, allocator_worker, concurrent);
+
+    for(int i = 0; i < ALLOCATOR_THREADS; i++)
+        pthread_join(workers[i], NULL);
+
+    assertmsg(concurrent->length == ALLOCATOR_THREADS * ALLOCATOR_ADDS / 2, "Concurrent lists should work on a caching allocator.");
+
+    concurrent->teardown_keep(concurrent);
+    caching->teardown(caching);
+
+    printf("passed.\n");
+}
+
+void test_ownership() {
+    printf("Running test_ownership...");
+
+    // Lists free the contents they delete, unless told to keep them
+    LinkedList list = createLinkedList();
+
+    for(int i = 0; i < 4; i++) {
+        int* contents = malloc(sizeof(int));
+        *contents = i;
+        list->add(list, contents);
+    }
+
+    int* kept = list->get(list, 0);
+    list->delete_keep(list, 0);
+    list->delete(list, 0);
+
+    assertmsg(*kept == 0 && list->length == 2, "delete_keep should leave the contents to the caller.");
+    free(kept);
+
+    // insert_copy works out the size from the contents, and inserts at the
+    // index it is given
+    struct { int x; int y; } point = {7, 8};
+    insert_copy(list, 1, &point, sizeof(point));
+    assertmsg(list->get(list, 1) != &point && ((int*) list->get(list, 1))[1] == 8, "insert_copy should insert a copy at the index.");
+
+    int pair[] = {5, 6};
+    add_copy(list, pair);
+    assertmsg(((int*) list->get(list, 3))[1] == 6, "add_copy should copy sizeof(contents) bytes by default.");
+
+    int* owned = list->get(list, 0);
+    list->auto_free = 0;
+    list->delete(list, 0);
+    free(owned);
+
+    list->auto_free = 1;
+    list->teardown(list);
+
+    // The policy is the same for every structure
+    Vector vector = createVector();
+    vector->auto_free = 0;
+
+    static int data[] = {1, 2, 3};
+    for(int i = 0; i < 3; i++)
+        vector->add(vector, &data[i]);
+
+    vector->delete(vector, 0);
+    assertmsg(*(int*) vector->get(vector, 0) == 2, "Vectors should keep contents when auto_free is off.");
+
+    vector->teardown(vector);
+
+    // Hash maps keep values they don't own
+    HashMap map = createStringHashMap();
+    map->free_values = 0;
+
+    char* key = malloc(4);
+    strcpy(key, "abc");
+    map->put(map, key, &data[0]);
+
+    char* replacement = malloc(4);
+    strcpy(replacement, "abc");
+    map->put(map, replacement, &data[1]);
+
+    assertmsg(map->get(map, "abc") == &data[1], "Putting a key again should replace its value.");
+
+    map->teardown(map);
+
+    printf("passed.\n");
+}
+
+DS_DEFINE_LIST(int32, int32_t)
+
+struct Point {
+    double x;
+    double y;
+};
+
+DS_DEFINE_LIST(point, struct Point)
+
+void test_typed_list() {
+    printf("Running test_typed_list...");
+
+    int32_list list = int32_list_create();
+    assertmsg(list != NULL && list->length == 0, "Failed to create an empty typed list.");
+
+    for(int i = 0; i < 100; i++)
+        assertmsg(int32_list_add(list, i), "Failed to add to a typed list.");
+
+    assertmsg(list->length == 100 && list->capacity >= 100, "Typed list length should be 100.");
+
+    for(int i = 0; i < 100; i++)
+        assertmsg(int32_list_get(list, i) == i && list->values[i] == i, "Typed list values out of order.");
+
+    assertmsg(int32_list_get_or_default(list, 100, -1) == -1, "Out of range get should give the default.");
+    assertmsg(!int32_list_set(list, 100, 0), "Out of range set should fail.");
+    assertmsg(!int32_list_insert(list, 101, 0), "Out of range insert should fail.");
+    assertmsg(!int32_list_delete(list, -1), "Out of range delete should fail.");
+
+    assertmsg(int32_list_insert(list, 0, -1), "Failed to insert at the head of a typed list.");
+    assertmsg(int32_list_insert(list, 50, -2), "Failed to insert in the middle of a typed list.");
+    assertmsg(int32_list_insert(list, list->length, -3), "Failed to insert at the end of a typed list.");
+    assertmsg(list->length == 103, "Typed list length should be 103 after inserting.");
+    assertmsg(list->values[0] == -1 && list->values[1] == 0, "Insert at head misplaced values.");
+    assertmsg(list->values[50] == -2 && list->values[51] == 49, "Insert in middle misplaced values.");
+    assertmsg(list->values[102] == -3 && list->values[101] == 99, "Insert at end misplaced values.");
+
+    assertmsg(int32_list_delete(list, 102) && int32_list_delete(list, 50) && int32_list_delete(list, 0), "Failed to delete from a typed list.");
+    assertmsg(int32_list_set(list, 10, 1000) && int32_list_get(list, 10) == 1000, "Failed to set a typed list value.");
+    int32_list_set(list, 10, 10);
+
+    int32_t more[] = {100, 101, 102};
+    assertmsg(int32_list_add_many(list, more, 3), "Failed to add many to a typed list.");
+
+    long sum = 0;
+
+    for(int i = 0; i < list->length; i++)
+        sum += list->values[i];
+
+    assertmsg(list->length == 103 && sum == 4950 + 303, "Typed list sum is wrong.");
+
+    assertmsg(int32_list_shrink_to_fit(list) && list->capacity == list->length, "Shrink to fit should drop unused room.");
+    assertmsg(int32_list_reserve(list, 1000) && list->capacity == 1000 && list->values[102] == 102, "Reserve should keep values.");
+
+    int32_list_teardown(list);
+
+    Allocator bump = createBumpAllocator(4096);
+    point_list points = point_list_create_with_allocator(bump);
+
+    for(int i = 0; i < 20; i++)
+        point_list_add(points, (struct Point) {i, -i});
+
+    assertmsg(points->length == 20 && point_list_get(points, 19).y == -19, "Struct typed list values are wrong.");
+
+    point_list_teardown(points);
+    bump->teardown(bump);
+
+    printf("passed.\n");
+}
+
+// Checks that get finds the same values as a plain array, in ascending order
+// (so each get walks on from the last) and then in descending order (so each
+// get walks from the head)
+int finger_list_matches(LinkedList list, int* expected, int length) {
+    if(list->length != length)
+        return 0;
+
+    for(int i = 0; i < length; i++) {
+        if(*(int*) list->get(list, i) != expected[i])
+            return 0;
+    }
+
+    for(int i = length - 1; i >= 0; i--) {
+        if(*(int*) list->get_or_default(list, i, NULL) != expected[i])
+            return 0;
+    }
+
+    return 1;
+}
+
+void test_finger() {
+    printf("Running test_finger...");
+
+    LinkedList list = createLinkedList();
+    list->auto_free = 0;
+
+    static int data[100];
+    int expected[200];
+    int length = 0;
+
+    for(int i = 0; i < 100; i++) {
+        data[i] = i;
+        list->add(list, &data[i]);
+        expected[length++] = i;
+    }
+
+    assertmsg(finger_list_matches(list, expected, length), "Gets should find every node.");
+
+    // Inserts and deletes before, at and after the finger keep indices right
+    list->get(list, 50);
+    list->insert(list, 10, &data[7]);
+    memmove(&expected[11], &expected[10], (length - 10) * sizeof(int));
+    expected[10] = 7;
+    length++;
+
+    assertmsg(*(int*) list->get(list, 50) == expected[50], "Insert before the finger should shift it.");
+    assertmsg(finger_list_matches(list, expected, length), "Insert before the finger should keep indices right.");
+
+    list->get(list, 60);
+    list->delete(list, 60);
+    memmove(&expected[60], &expected[61], (length - 61) * sizeof(int));
+    length--;
+
+    assertmsg(*(int*) list->get(list, 60) == expected[60], "Delete at the finger should move it back.");
+    assertmsg(finger_list_matches(list, expected, length), "Delete at the finger should keep indices right.");
+
+    list->get(list, 5);
+    list->delete(list, 0);
+    memmove(&expected[0], &expected[1], (length - 1) * sizeof(int));
+    length--;
+
+    assertmsg(*(int*) list->get(list, 4) == expected[4], "Delete at the head should clear the finger.");
+    assertmsg(finger_list_matches(list, expected, length), "Delete at the head should keep indices right.");
+
+    list->get(list, 40);
+    list->delete_range(list, 20, 50);
+    memmove(&expected[20], &expected[50], (length - 50) * sizeof(int));
+    length -= 30;
+
+    assertmsg(finger_list_matches(list, expected, length), "Delete range over the finger should keep indices right.");
+
+    // Ascending inserts each start from the node inserted before
+    for(int i = 0; i < 30; i++) {
+        list->insert(list, 20 + i, &data[20 + i]);
+        memmove(&expected[21 + i], &expected[20 + i], (length - 20 - i) * sizeof(int));
+        expected[20 + i] = 20 + i;
+        length++;
+    }
+
+    assertmsg(finger_list_matches(list, expected, length), "Ascending inserts should land in order.");
+
+    // Relinking the list through an iterator clears the finger
+    list->get(list, 90);
+    struct ListIterator iterator = list->begin(list);
+
+    while(iterator.has_next(&iterator)) {
+        if(*(int*) iterator.next(&iterator) % 2 == 0)
+            iterator.remove_current(&iterator);
+    }
+
+    int odd_length = 0;
+
+    for(int i = 0; i < length; i++) {
+        if(expected[i] % 2 != 0)
+            expected[odd_length++] = expected[i];
+    }
+
+    assertmsg(finger_list_matches(list, expected, odd_length), "Gets after removing through an iterator should be right.");
+
+    list->teardown(list);
+
+    printf("passed.\n");
+}
+
+void test_ring_deque() {
+    printf("Running test_ring_deque...");
+
+    RingDeque deque = createRingDeque();
+    assertmsg(deque != NULL && deque->length == 0, "Failed to create an empty ring deque.");
+    assertmsg(deque->pop_front(deque) == NULL && deque->pop_back(deque) == NULL, "Popping an empty deque should give NULL.");
+
+    deque->auto_free = 0;
+
+    static int data[100];
+
+    for(int i = 0; i < 100; i++)
+        data[i] = i;
+
+    // Push to both ends, so that the contents wrap around the array as it
+    // grows
+    for(int i = 50; i < 100; i++)
+        deque->push_back(deque, &data[i]);
+
+    for(int i = 49; i >= 0; i--)
+        deque->push_front(deque, &data[i]);
+
+    assertmsg(deque->length == 100 && deque->capacity == 128, "Ring deque capacity should be a power of two.");
+
+    for(int i = 0; i < 100; i++)
+        assertmsg(*(int*) deque->get(deque, i) == i, "Ring deque should keep its order across wraps.");
+
+    assertmsg(deque->get_or_default(deque, 100, NULL) == NULL, "Out of range get should give the default.");
+
+    assertmsg(*(int*) deque->pop_front(deque) == 0 && *(int*) deque->pop_back(deque) == 99, "Pops should come from each end.");
+
+    // Bulk pops and pushes copy across the end of the array
+    void* popped[100];
+
+    assertmsg(deque->pop_n(deque, popped, 40) == 40, "Pop n should pop n contents.");
+
+    for(int i = 0; i < 40; i++)
+        assertmsg(*(int*) popped[i] == i + 1, "Pop n should keep order.");
+
+    void* pushed[80];
+
+    for(int i = 0; i < 80; i++)
+        pushed[i] = &data[i];
+
+    assertmsg(deque->push_n(deque, pushed, 80) && deque->length == 138, "Push n should push every contents.");
+    assertmsg(deque->capacity == 256, "Push n should grow to the next power of two.");
+
+    for(int i = 0; i < 58; i++)
+        assertmsg(*(int*) deque->get(deque, i) == i + 41, "Contents before push n should stay in order.");
+
+    for(int i = 0; i < 80; i++)
+        assertmsg(*(int*) deque->get(deque, 58 + i) == i, "Push n should keep order.");
+
+    assertmsg(deque->pop_n(deque, popped, 100) == 100 && deque->pop_n(deque, popped, 100) == 38, "Pop n should stop when the deque runs out.");
+    assertmsg(deque->length == 0 && *(int*) popped[37] == 79, "Pop n should empty the deque.");
+
+    deque->teardown(deque);
+
+    // Contents left in the deque are freed on teardown
+    deque = createRingDeque();
+
+    for(int i = 0; i < 20; i++) {
+        int* value = malloc(sizeof(int));
+        *value = i;
+        deque->push_front(deque, value);
+    }
+
+    free(deque->pop_back(deque));
+
+    deque->teardown(deque);
+
+    printf("passed.\n");
+}
+
+void test_priority_queue() {
+    printf("Running test_priority_queue...");
+
+    static int data[200];
+
+    for(int arity = 2; arity <= 5; arity++) {
+        PriorityQueue queue = createPriorityQueue(compare_ints, arity);
+        queue->auto_free = 0;
+
+        assertmsg(queue->pop(queue) == NULL && queue->peek(queue) == NULL, "An empty priority queue should give NULL.");
+
+        int handles[200];
+
+        // Push the values in a scrambled order
+        for(int i = 0; i < 200; i++) {
+            data[i] = (i * 37) % 200;
+            assertmsg(queue->push(queue, &data[i], &handles[i]), "Failed to push onto a priority queue.");
+        }
+
+        assertmsg(*(int*) queue->peek(queue) == 0 && queue->length == 200, "Peek should give the smallest contents.");
+
+        // Lower a few of the biggest values below everything else
+        data[199] = -3;
+        data[198] = -2;
+        data[150] = -1;
+
+        assertmsg(queue->decrease_key(queue, handles[150]), "Failed to decrease a key.");
+        assertmsg(queue->decrease_key(queue, handles[198]), "Failed to decrease a key.");
+        assertmsg(queue->decrease_key(queue, handles[199]), "Failed to decrease a key.");
+
+        assertmsg(*(int*) queue->pop(queue) == -3 && *(int*) queue->pop(queue) == -2 && *(int*) queue->pop(queue) == -1, "Decreased keys should be popped first.");
+
+        assertmsg(!queue->decrease_key(queue, handles[199]), "Popped handles should not be in use.");
+        assertmsg(!queue->decrease_key(queue, 1000), "Unknown handles should not be in use.");
+
+        int previous = -1000;
+
+        while(queue->length > 0) {
+            int value = *(int*) queue->pop(queue);
+            assertmsg(value >= previous, "Priority queue should pop in order.");
+            previous = value;
+        }
+
+        // Popped handles are given out again
+        int handle;
+        queue->push(queue, &data[0], &handle);
+        assertmsg(handle >= 0 && handle < 200, "Handles should be reused.");
+
+        queue->teardown(queue);
+    }
+
+    // Heapify from an array, on top of what is already in the queue
+    PriorityQueue queue = createPriorityQueue(compare_ints, 4);
+    queue->auto_free = 0;
+
+    void* contents[100];
+    int handles[100];
+
+    for(int i = 0; i < 100; i++) {
+        data[i] = 100 - i;
+        contents[i] = &data[i];
+    }
+
+    queue->push(queue, &data[50], NULL);
+    assertmsg(queue->heapify(queue, contents, 100, handles) && queue->length == 101, "Failed to heapify an array.");
+
+    data[10] = 0;
+    assertmsg(queue->decrease_key(queue, handles[10]) && *(int*) queue->peek(queue) == 0, "Heapified handles should work.");
+
+    for(int previous = -1; queue->length > 0; ) {
+        int value = *(int*) queue->pop(queue);
+        assertmsg(value >= previous, "Heapified queue should pop in order.");
+        previous = value;
+    }
+
+    // Heapify from a list, which is left as it was
+    LinkedList list = createLinkedList();
+    list->auto_free = 0;
+
+    for(int i = 0; i < 100; i++)
+        list->add(list, &data[(i * 13) % 100]);
+
+    assertmsg(queue->heapify_list(queue, list, NULL) && queue->length == 100 && list->length == 100, "Failed to heapify a list.");
+
+    for(int previous = -1; queue->length > 0; ) {
+        int value = *(int*) queue->pop(queue);
+        assertmsg(value >= previous, "Queue heapified from a list should pop in order.");
+        previous = value;
+    }
+
+    list->teardown(list);
+    queue->teardown(queue);
+
+    // Contents left in the queue are freed on teardown
+    queue = createPriorityQueue(compare_ints, 3);
+
+    for(int i = 0; i < 20; i++) {
+        int* value = malloc(sizeof(int));
+        *value = 20 - i;
+        queue->push(queue, value, NULL);
+    }
+
+    free(queue->pop(queue));
+
+    queue->teardown(queue);
+
+    printf("passed.\n");
+}
+
+int compare_int_keys(void* a, void* b) {
+    long long key1 = (long long) a;
+    long long key2 = (long long) b;
+
+    return (key1 > key2) - (key1 < key2);
+}
+
+int compare_strings(void* a, void* b) {
+    return strcmp((char*) a, (char*) b);
+}
+
+// Checks that every node under a B+tree node has its keys in order, and
+// between the bounds given by its parents, and returns the depth of its
+// leaves (or -1 if they are not all at the same depth)
+int check_btree_node(struct BTreeNode* node, long long low, long long high, int is_root) {
+    if(!is_root && node->num_keys < (node->is_leaf ? BTREE_NODE_KEYS / 2 : (BTREE_NODE_KEYS - 1) / 2))
+        return -1;
+
+    for(int i = 0; i < node->num_keys; i++) {
+        long long key = (long long) node->keys[i];
+
+        if(key < low || key >= high || (i > 0 && key <= (long long) node->keys[i - 1]))
+            return -1;
+    }
+
+    if(node->is_leaf)
+        return 0;
+
+    struct BTreeInternal* internal = (struct BTreeInternal*) node;
+    int depth = -1;
+
+    for(int i = 0; i <= node->num_keys; i++) {
+        long long child_low = i == 0 ? low : (long long) node->keys[i - 1];
+        long long child_high = i == node->num_keys ? high : (long long) node->keys[i];
+
+        int child_depth = check_btree_node(internal->children[i], child_low, child_high, 0);
+
+        if(child_depth < 0 || (depth >= 0 && child_depth != depth))
+            return -1;
+
+        depth = child_depth;
+    }
+
+    return depth + 1;
+}
+
+void test_btree_map() {
+    printf("Running test_btree_map...");
+
+    BTreeMap map = createBTreeMap(compare_int_keys);
+    map->free_keys = 0;
+    map->free_values = 0;
+
+    static int values[4000];
+    static char present[4000];
+
+    // Put and remove keys in a scrambled order, checking the tree as it goes
+    for(int i = 0; i < 4000; i++) {
+        int key = (int) (i * 2654435761LL % 4000);
+
+        values[key] = key * 3;
+        assertmsg(map->put(map, int_key(key), &values[key]), "Failed to put a key into a B+tree map.");
+        present[key] = 1;
+    }
+
+    assertmsg(map->length == 4000 && !map->root->is_leaf, "B+tree map should hold every key.");
+    assertmsg(check_btree_node(map->root, 0, 4000, 1) >= 2, "B+tree should stay balanced while growing.");
+
+    for(int i = 0; i < 3000; i++) {
+        int key = (int) (i * 40503LL % 4000);
+
+        assertmsg(map->remove_keep(map, int_key(key)), "Failed to remove a key from a B+tree map.");
+        present[key] = 0;
+
+        if(i % 500 == 0)
+            assertmsg(check_btree_node(map->root, 0, 4000, 1) >= 0, "B+tree should stay balanced while shrinking.");
+    }
+
+    assertmsg(!map->remove_keep(map, int_key(-1)), "Removing a missing key should fail.");
+    assertmsg(map->length == 1000, "B+tree map length should follow removals.");
+    assertmsg(check_btree_node(map->root, 0, 4000, 1) >= 0, "B+tree should stay balanced after removals.");
+
+    for(int key = 0; key < 4000; key++) {
+        if(present[key])
+            assertmsg(*(int*) map->get(map, int_key(key)) == key * 3, "Remaining keys should keep their values.");
+        else
+            assertmsg(map->get_or_default(map, int_key(key), &values[0]) == &values[0], "Removed keys should be missing.");
+    }
+
+    // Ranges walk the leaves in either direction, and stop at their bounds
+    struct BTreeIterator it = map->range(map, int_key(1000), int_key(2999));
+    int previous = 999;
+    int count = 0;
+
+    while(it.has_next(&it)) {
+        int* value = it.next(&it);
+        int key = (int) (long long) it.key;
+
+        assertmsg(key > previous && key <= 2999 && present[key] && *value == key * 3, "Range should be in order.");
+
+        previous = key;
+        count++;
+    }
+
+    int expected_count = 0;
+
+    for(int key = 1000; key <= 2999; key++)
+        expected_count += present[key];
+
+    assertmsg(count == expected_count, "Range should hold every key between its bounds.");
+
+    it = map->range_reverse(map, int_key(1000), int_key(2999));
+    previous = 3000;
+
+    for(count = 0; it.has_next(&it); count++) {
+        it.next(&it);
+        assertmsg((long long) it.key < previous && (long long) it.key >= 1000, "Reverse range should be in order.");
+        previous = (int) (long long) it.key;
+    }
+
+    assertmsg(count == expected_count, "Reverse range should hold every key between its bounds.");
+
+    it = map->begin(map);
+    for(count = 0; it.has_next(&it); count++)
+        it.next(&it);
+
+    assertmsg(count == 1000, "Iterating over the whole map should see every key.");
+
+    it = map->begin_reverse(map);
+    assertmsg(it.has_next(&it) && *(int*) it.next(&it) == 3 * (int) (long long) it.key, "Reverse iteration should start at the biggest key.");
+
+    it = map->range(map, int_key(5000), int_key(6000));
+    assertmsg(!it.has_next(&it), "Range past every key should be empty.");
+
+    map->teardown(map);
+
+    // Bulk loading packs sorted keys into leaves
+    for(int size = 0; size < 600; size += 37) {
+        map = createBTreeMap(compare_int_keys);
+        map->free_keys = 0;
+        map->free_values = 0;
+
+        void* keys[600];
+        void* bulk_values[600];
+
+        for(int i = 0; i < size; i++) {
+            keys[i] = int_key(2 * i);
+            bulk_values[i] = &values[i];
+        }
+
+        assertmsg(map->bulk_load(map, keys, bulk_values, size) && map->length == size, "Failed to bulk load a B+tree map.");
+        assertmsg(check_btree_node(map->root, 0, 2 * size, 1) >= 0, "Bulk loaded B+tree should be balanced.");
+
+        for(int i = 0; i < size; i++)
+            assertmsg(map->get(map, int_key(2 * i)) == &values[i] && map->get(map, int_key(2 * i + 1)) == NULL, "Bulk loaded keys should be found.");
+
+        map->put(map, int_key(1), &values[0]);
+        map->remove_keep(map, int_key(0));
+        assertmsg(check_btree_node(map->root, 0, 2 * size + 2, 1) >= 0, "Bulk loaded B+tree should stay balanced.");
+
+        map->teardown(map);
+    }
+
+    // Owned keys may be copied into internal nodes, so replacing or
+    // removing them must not leave those copies dangling
+    map = createBTreeMap(compare_strings);
+
+    for(int round = 0; round < 2; round++) {
+        for(int i = 0; i < 500; i++) {
+            char* key = malloc(8);
+            int* value = malloc(sizeof(int));
+
+            snprintf(key, 8, "%05d", i);
+            *value = i + round;
+
+            map->put(map, key, value);
+        }
+    }
+
+    assertmsg(map->length == 500 && *(int*) map->get(map, "00250") == 251, "Putting owned keys again should replace them.");
+
+    for(int i = 0; i < 500; i += 2) {
+        char key[8];
+        snprintf(key, 8, "%05d", i);
+        assertmsg(map->remove(map, key), "Failed to remove an owned key.");
+    }
+
+    assertmsg(map->length == 250 && map->get(map, "00250") == NULL && *(int*) map->get(map, "00251") == 252, "Owned keys should be removed.");
+
+    map->teardown(map);
+
+    printf("passed.\n");
+}
+
+struct RadixVisit {
+    int count;
+    int in_order;
+    unsigned char previous[64];
+    int previous_length;
+};
+
+// Checks that prefix_foreach hands over keys in byte order
+void visit_radix_key(void* key, int key_length, void* value, void* ctx) {
+    struct RadixVisit* visit = ctx;
+
+    int shorter = key_length < visit->previous_length ? key_length : visit->previous_length;
+    int order = memcmp(visit->previous, key, shorter);
+
+    if(visit->count > 0 && (order > 0 || (order == 0 && visit->previous_length >= key_length)))
+        visit->in_order = 0;
+
+    memcpy(visit->previous, key, key_length);
+    visit->previous_length = key_length;
+    visit->count++;
+}
+
+void test_radix_tree() {
+    printf("Running test_radix_tree...");
+
+    RadixTree tree = createRadixTree();
+    tree->free_values = 0;
+
+    static int values[3000];
+    char key[64];
+
+    // Keys share prefixes of every length, including ones longer than the
+    // part of a prefix a node stores
+    for(int i = 0; i < 3000; i++) {
+        int length = snprintf(key, sizeof(key), "%s%d", i % 3 == 0 ? "the/quick/brown/fox/" : "k", i);
+
+        values[i] = i;
+        assertmsg(tree->put(tree, key, length, &values[i]), "Failed to put a key into a radix tree.");
+    }
+
+    assertmsg(tree->length == 3000, "Radix tree should hold every key.");
+
+    for(int i = 0; i < 3000; i++) {
+        int length = snprintf(key, sizeof(key), "%s%d", i % 3 == 0 ? "the/quick/brown/fox/" : "k", i);
+
+        assertmsg(tree->get(tree, key, length) == &values[i], "Radix tree keys should keep their values.");
+        assertmsg(tree->get(tree, key, length - 1) == NULL || i >= 10, "Prefixes of keys should not be found.");
+    }
+
+    assertmsg(tree->get(tree, "the/quick/brown/cat/3", 21) == NULL, "Keys differing past the stored prefix should not be found.");
+    assertmsg(tree->get_or_default(tree, "x", 1, &values[1]) == &values[1], "Missing keys should give the default.");
+
+    // Prefix queries visit every key under the prefix, in order
+    struct RadixVisit visit = {0, 1};
+
+    assertmsg(tree->prefix_foreach(tree, "k1", 2, visit_radix_key, &visit) == visit.count, "Prefix query should count its keys.");
+    assertmsg(visit.in_order && visit.count == 742, "Prefix query should visit keys starting with the prefix in order.");
+
+    visit = (struct RadixVisit) {0, 1};
+    assertmsg(tree->prefix_foreach(tree, "the/quick/brown/fox/2", 21, visit_radix_key, &visit) == 369 && visit.in_order, "Prefix query should work through long prefixes.");
+
+    visit = (struct RadixVisit) {0, 1};
+    assertmsg(tree->prefix_foreach(tree, "the/quick/brown/cow", 19, visit_radix_key, &visit) == 0, "Prefix query should check skipped prefix bytes.");
+
+    visit = (struct RadixVisit) {0, 1};
+    assertmsg(tree->prefix_foreach(tree, "", 0, visit_radix_key, &visit) == 3000 && visit.in_order, "Empty prefix should visit every key.");
+
+    // Removing keys shrinks and merges nodes, without losing the others
+    for(int i = 0; i < 3000; i += 2) {
+        int length = snprintf(key, sizeof(key), "%s%d", i % 3 == 0 ? "the/quick/brown/fox/" : "k", i);
+
+        assertmsg(tree->remove(tree, key, length), "Failed to remove a key from a radix tree.");
+    }
+
+    assertmsg(!tree->remove(tree, "k0", 2) && !tree->remove(tree, "the", 3), "Removing a missing key should fail.");
+    assertmsg(tree->length == 1500, "Radix tree length should follow removals.");
+
+    for(int i = 0; i < 3000; i++) {
+        int length = snprintf(key, sizeof(key), "%s%d", i % 3 == 0 ? "the/quick/brown/fox/" : "k", i);
+
+        assertmsg(tree->get(tree, key, length) == (i % 2 == 0 ? NULL : &values[i]), "Only removed keys should be missing.");
+    }
+
+    visit = (struct RadixVisit) {0, 1};
+    assertmsg(tree->prefix_foreach(tree, "", 0, visit_radix_key, &visit) == 1500 && visit.in_order, "Removals should keep keys in order.");
+
+    tree->teardown(tree);
+
+    // Keys which are prefixes of each other, binary keys, and the empty key
+    tree = createRadixTree();
+    tree->free_values = 0;
+
+    assertmsg(tree->put(tree, "abc", 3, &values[3]) && tree->put(tree, "a", 1, &values[1]) && tree->put(tree, "ab", 2, &values[2]), "Failed to put prefix keys.");
+    assertmsg(tree->put(tree, "", 0, &values[0]) && tree->length == 4, "Failed to put the empty key.");
+
+    int match_length = -1;
+
+    assertmsg(tree->longest_prefix(tree, "abcdef", 6, &match_length) == &values[3] && match_length == 3, "Longest prefix should be the longest key.");
+    assertmsg(tree->longest_prefix(tree, "abd", 3, &match_length) == &values[2] && match_length == 2, "Longest prefix should stop where the key leaves the tree.");
+    assertmsg(tree->longest_prefix(tree, "b", 1, &match_length) == &values[0] && match_length == 0, "The empty key is a prefix of every key.");
+
+    tree->remove(tree, "", 0);
+    assertmsg(tree->longest_prefix(tree, "b", 1, NULL) == NULL, "Keys with no prefix in the tree should have no match.");
+
+    tree->remove(tree, "ab", 2);
+    assertmsg(tree->longest_prefix(tree, "abd", 3, &match_length) == &values[1] && match_length == 1, "Longest prefix should skip removed keys.");
+
+    // A node with a child for every byte grows to a Node256, and shrinks
+    // back down as its children are removed
+    unsigned char binary[2] = {'z', 0};
+
+    for(int i = 0; i < 256; i++) {
+        binary[1] = i;
+        tree->put(tree, binary, 2, &values[i]);
+    }
+
+    struct RadixNode** z = &tree->root;
+    assertmsg((*z)->type == RADIX_NODE4, "Root should branch on the first byte.");
+
+    z = ((struct RadixNode4*) *z)->children[1] != NULL && ((struct RadixNode4*) *z)->keys[1] == 'z' ? &((struct RadixNode4*) *z)->children[1] : NULL;
+    assertmsg(z != NULL && (*z)->type == RADIX_NODE256, "A node with 256 children should be a Node256.");
+
+    for(int i = 0; i < 256; i++) {
+        binary[1] = i;
+        assertmsg(tree->get(tree, binary, 2) == &values[i], "Binary keys should be found.");
+    }
+
+    for(int i = 255; i >= 2; i--) {
+        binary[1] = i;
+        assertmsg(tree->remove(tree, binary, 2), "Failed to remove a binary key.");
+
+        if(i == 30)
+            assertmsg((*z)->type == RADIX_NODE48, "Small Node256 should shrink to a Node48.");
+        else if(i == 10)
+            assertmsg((*z)->type == RADIX_NODE16, "Small Node48 should shrink to a Node16.");
+    }
+
+    assertmsg((*z)->type == RADIX_NODE4 && (*z)->num_children == 2, "Small Node16 should shrink to a Node4.");
+
+    binary[1] = 1;
+    tree->remove(tree, binary, 2);
+    assertmsg((*z)->type == RADIX_LEAF, "A node with one leaf left should be replaced by it.");
+
+    tree->teardown(tree);
+
+    // Values owned by the tree are freed when replaced, removed, or torn down
+    tree = createRadixTree();
+
+    for(int round = 0; round < 2; round++) {
+        for(int i = 0; i < 100; i++) {
+            int length = snprintf(key, sizeof(key), "value/%d", i);
+            int* value = malloc(sizeof(int));
+
+            *value = i + round;
+            tree->put(tree, key, length, value);
+        }
+    }
+
+    assertmsg(tree->length == 100 && *(int*) tree->get(tree, "value/50", 8) == 51, "Putting owned values again should replace them.");
+    assertmsg(tree->remove(tree, "value/50", 8) && tree->get(tree, "value/50", 8) == NULL, "Failed to remove an owned value.");
+
+    tree->teardown(tree);
+
+    printf("passed.\n");
+}
+
 int main(int argc, char** argv) {
     test_create_empty_list();
     test_add_to_empty_list();
@@ -170,6 +2106,32 @@ int main(int argc, char** argv) {
     test_delete_by_index();
     test_delete_last_element();
     test_teardown();
+    test_add_after_deleting_tail();
+    test_pooled_list();
+    test_shared_pool();
+    test_unrolled_list();
+    test_vector();
+    test_string_hash_map();
+    test_int_hash_map();
+    test_iterator();
+    test_bulk_operations();
+    test_concurrent_list_stress();
+    test_lock_free_queue();
+    test_doubly_linked_list();
+    test_inline_nodes();
+    test_skip_list();
+    test_parallel_operations();
+    test_sort();
+    test_serialization();
+    test_list_stats();
+    test_allocators();
+    test_ownership();
+    test_typed_list();
+    test_finger();
+    test_ring_deque();
+    test_priority_queue();
+    test_btree_map();
+    test_radix_tree();
     
     return 0;
 }
\ No newline at end of file
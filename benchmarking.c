@@ -0,0 +1,1234 @@
+#include "data_structures.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+// Benchmarks every operation of the data structures in data_structures.h,
+// over list sizes from 10 up to --max-size (10^7 by default), and prints
+// one result per line as CSV (or one object per result as JSON) :
+//
+//     ./benchmarking [--format csv|json] [--max-size N]
+//
+// Each result reports the time and the number of heap allocations and
+// frees per operation. Allocations are counted by linking with
+// -Wl,--wrap=malloc (and friends), which the Makefile's bench target does.
+
+// Every operation runs at most this many times per result
+#define TARGET_OPS 100000
+
+// Operations which traverse the list run few enough times that no more
+// than this many nodes are visited per result
+#define TRAVERSAL_BUDGET 100000000LL
+
+#define THROUGHPUT_OPS 20000
+#define THROUGHPUT_LIST_LENGTH 256
+#define QUEUE_OPS 100000
+#define PARALLEL_LIST_LENGTH 1000000
+
+// Contents shared by every list in the benchmarks (never freed)
+int benchmark_data[THROUGHPUT_LIST_LENGTH];
+
+
+
+// Count every allocation and free made through the heap. The linker
+// redirects calls to malloc() to __wrap_malloc(), and __real_malloc() is
+// the original.
+_Atomic long long num_allocations = 0;
+_Atomic long long num_frees = 0;
+
+void* __real_malloc(size_t);
+void* __real_calloc(size_t, size_t);
+void* __real_realloc(void*, size_t);
+void* __real_aligned_alloc(size_t, size_t);
+void __real_free(void*);
+
+void* __wrap_malloc(size_t size) {
+    num_allocations++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    num_allocations++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+    num_allocations++;
+    return __real_realloc(pointer, size);
+}
+
+void* __wrap_aligned_alloc(size_t alignment, size_t size) {
+    num_allocations++;
+    return __real_aligned_alloc(alignment, size);
+}
+
+void __wrap_free(void* pointer) {
+    if(pointer != NULL)
+        num_frees++;
+
+    __real_free(pointer);
+}
+
+
+
+double seconds_now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Stores the time spent, and allocations made, over one or more timed
+// sections of a benchmark
+struct Measurement {
+    double start;
+    long long start_allocations;
+    long long start_frees;
+
+    double seconds;
+    long long allocations;
+    long long frees;
+    long long ops;
+};
+
+void start_timing(struct Measurement* measurement) {
+    measurement->start_allocations = num_allocations;
+    measurement->start_frees = num_frees;
+    measurement->start = seconds_now();
+}
+
+void stop_timing(struct Measurement* measurement, long long ops) {
+    measurement->seconds += seconds_now() - measurement->start;
+    measurement->allocations += num_allocations - measurement->start_allocations;
+    measurement->frees += num_frees - measurement->start_frees;
+    measurement->ops += ops;
+}
+
+
+
+int output_json = 0;
+int num_results = 0;
+
+void start_results() {
+    if(output_json)
+        printf("[\n");
+    else
+        printf("structure,operation,size,threads,ops,ns_per_op,allocs_per_op,frees_per_op\n");
+}
+
+void finish_results() {
+    if(output_json)
+        printf("\n]\n");
+}
+
+void print_result(const char* structure, const char* operation, long long size, int threads, struct Measurement* measurement) {
+    long long ops = measurement->ops > 0 ? measurement->ops : 1;
+
+    double ns_per_op = measurement->seconds * 1e9 / ops;
+    double allocs_per_op = (double) measurement->allocations / ops;
+    double frees_per_op = (double) measurement->frees / ops;
+
+    if(output_json) {
+        printf("%s  {\"structure\": \"%s\", \"operation\": \"%s\", \"size\": %lld, \"threads\": %d, \"ops\": %lld, \"ns_per_op\": %.2f, \"allocs_per_op\": %.3f, \"frees_per_op\": %.3f}",
+            num_results > 0 ? ",\n" : "", structure, operation, size, threads, ops, ns_per_op, allocs_per_op, frees_per_op);
+    }
+    else {
+        printf("%s,%s,%lld,%d,%lld,%.2f,%.3f,%.3f\n", structure, operation, size, threads, ops, ns_per_op, allocs_per_op, frees_per_op);
+    }
+
+    fflush(stdout);
+    num_results++;
+}
+
+// Returns the number of times to run an operation on a list of a given
+// size, which is at most limit, and at most TRAVERSAL_BUDGET / size
+long long num_ops(long long size, long long limit) {
+    long long ops = TRAVERSAL_BUDGET / size;
+
+    if(ops > limit)
+        ops = limit;
+
+    return ops < 1 ? 1 : ops;
+}
+
+
+
+// Defines a function benchmarking every operation of one of the list
+// structures, which all share the same function pointers. Operations which
+// change the length of the list are run on fresh lists, repeatedly for
+// small lists, so that the list stays close to the size being measured.
+#define DEFINE_LIST_BENCHMARK(function_name, structure_name, list_type, create_list)\
+void function_name(long long size) {\
+    list_type list;\
+    struct Measurement measurement;\
+    \
+    /* Build lists one add at a time, and then tear them down */\
+    struct Measurement teardown_measurement;\
+    memset(&measurement, 0, sizeof(measurement));\
+    memset(&teardown_measurement, 0, sizeof(teardown_measurement));\
+    \
+    for(long long built = 0; built < TARGET_OPS; built += size) {\
+        start_timing(&measurement);\
+        list = create_list;\
+        for(long long i = 0; i < size; i++)\
+            list->add(list, &benchmark_data[0]);\
+        stop_timing(&measurement, size);\
+        \
+        start_timing(&teardown_measurement);\
+        list->teardown_keep(list);\
+        stop_timing(&teardown_measurement, size);\
+    }\
+    \
+    print_result(structure_name, "add", size, 1, &measurement);\
+    print_result(structure_name, "teardown", size, 1, &teardown_measurement);\
+    \
+    /* Build lists of copies of an 8 byte value, one add_inline at a time */\
+    memset(&measurement, 0, sizeof(measurement));\
+    \
+    for(long long built = 0; built < TARGET_OPS; built += size) {\
+        list = create_list;\
+        start_timing(&measurement);\
+        for(long long i = 0; i < size; i++)\
+            list->add_inline(list, &i, sizeof(i));\
+        stop_timing(&measurement, size);\
+        list->teardown(list);\
+    }\
+    \
+    print_result(structure_name, "add_inline", size, 1, &measurement);\
+    \
+    /* Insert and delete at the head, middle and tail */\
+    const char* operations[] = {"insert_head", "insert_middle", "insert_tail", "delete_head", "delete_middle", "delete_tail"};\
+    \
+    for(int operation = 0; operation < 6; operation++) {\
+        int deleting = operation >= 3;\
+        int position = operation % 3;\
+        \
+        long long limit = deleting ? (size + 1) / 2 : size;\
+        long long ops = num_ops(size, limit);\
+        long long repeats = ops == limit ? (TARGET_OPS + ops - 1) / ops : 1;\
+        \
+        memset(&measurement, 0, sizeof(measurement));\
+        \
+        for(long long repeat = 0; repeat < repeats; repeat++) {\
+            list = create_list;\
+            for(long long i = 0; i < size; i++)\
+                list->add(list, &benchmark_data[0]);\
+            \
+            start_timing(&measurement);\
+            for(long long i = 0; i < ops; i++) {\
+                int index = position == 0 ? 0 : position == 1 ? list->length / 2 : list->length - deleting;\
+                \
+                if(deleting)\
+                    list->delete_keep(list, index);\
+                else\
+                    list->insert(list, index, &benchmark_data[0]);\
+            }\
+            stop_timing(&measurement, ops);\
+            \
+            list->teardown_keep(list);\
+        }\
+        \
+        print_result(structure_name, operations[operation], size, 1, &measurement);\
+    }\
+    \
+    /* Get contents spread evenly across the list */\
+    list = create_list;\
+    for(long long i = 0; i < size; i++)\
+        list->add(list, &benchmark_data[0]);\
+    \
+    long long ops = num_ops(size, TARGET_OPS);\
+    \
+    memset(&measurement, 0, sizeof(measurement));\
+    start_timing(&measurement);\
+    for(long long i = 0; i < ops; i++)\
+        list->get(list, (int) (i * 7919 % size));\
+    stop_timing(&measurement, ops);\
+    print_result(structure_name, "get", size, 1, &measurement);\
+    \
+    memset(&measurement, 0, sizeof(measurement));\
+    start_timing(&measurement);\
+    for(long long i = 0; i < ops; i++)\
+        list->get_or_default(list, (int) (i * 7919 % size), NULL);\
+    stop_timing(&measurement, ops);\
+    print_result(structure_name, "get_or_default", size, 1, &measurement);\
+    \
+    list->teardown_keep(list);\
+}
+
+DEFINE_LIST_BENCHMARK(benchmark_linked_list, "linked_list", LinkedList, createLinkedList())
+DEFINE_LIST_BENCHMARK(benchmark_pooled_linked_list, "pooled_linked_list", LinkedList, createLinkedListWithPool(size))
+DEFINE_LIST_BENCHMARK(benchmark_unrolled_list, "unrolled_list", UnrolledList, createUnrolledList(32))
+DEFINE_LIST_BENCHMARK(benchmark_vector, "vector", Vector, createVector())
+DEFINE_LIST_BENCHMARK(benchmark_doubly_linked_list, "doubly_linked_list", DoublyLinkedList, createDoublyLinkedList())
+
+
+
+int compare_benchmark_keys(void* a, void* b) {
+    int key1 = *(int*) a;
+    int key2 = *(int*) b;
+
+    return (key1 > key2) - (key1 < key2);
+}
+
+// Benchmarks a skip list holding keys in a scrambled order, which are kept
+// sorted as they are inserted
+void benchmark_skip_list(long long size) {
+    int* keys = malloc(size * sizeof(int));
+
+    for(long long i = 0; i < size; i++)
+        keys[i] = (int) (i * 2654435761LL % size);
+
+    SkipList list;
+    struct Measurement measurement;
+
+    /* Build lists one insert at a time */
+    memset(&measurement, 0, sizeof(measurement));
+
+    for(long long built = 0; built < TARGET_OPS; built += size) {
+        list = createSkipList(compare_benchmark_keys);
+
+        start_timing(&measurement);
+        for(long long i = 0; i < size; i++)
+            list->insert_sorted(list, &keys[i]);
+        stop_timing(&measurement, size);
+
+        list->teardown_keep(list);
+    }
+
+    print_result("skip_list", "insert_sorted", size, 1, &measurement);
+
+    /* Look up nodes by index and by contents */
+    list = createSkipList(compare_benchmark_keys);
+    for(long long i = 0; i < size; i++)
+        list->insert_sorted(list, &keys[i]);
+
+    memset(&measurement, 0, sizeof(measurement));
+    start_timing(&measurement);
+    for(long long i = 0; i < TARGET_OPS; i++)
+        list->get(list, (int) (i * 7919 % size));
+    stop_timing(&measurement, TARGET_OPS);
+    print_result("skip_list", "get", size, 1, &measurement);
+
+    memset(&measurement, 0, sizeof(measurement));
+    start_timing(&measurement);
+    for(long long i = 0; i < TARGET_OPS; i++)
+        list->find(list, &keys[i * 7919 % size]);
+    stop_timing(&measurement, TARGET_OPS);
+    print_result("skip_list", "find", size, 1, &measurement);
+
+    list->teardown_keep(list);
+
+    /* Delete half of the nodes, from all over the list */
+    long long ops = (size + 1) / 2;
+    long long repeats = (TARGET_OPS + ops - 1) / ops;
+
+    if(ops > TARGET_OPS)
+        ops = TARGET_OPS;
+
+    memset(&measurement, 0, sizeof(measurement));
+
+    for(long long repeat = 0; repeat < repeats; repeat++) {
+        list = createSkipList(compare_benchmark_keys);
+        for(long long i = 0; i < size; i++)
+            list->insert_sorted(list, &keys[i]);
+
+        start_timing(&measurement);
+        for(long long i = 0; i < ops; i++)
+            list->delete_keep(list, (int) (i * 7919 % list->length));
+        stop_timing(&measurement, ops);
+
+        list->teardown_keep(list);
+    }
+
+    print_result("skip_list", "delete", size, 1, &measurement);
+
+    free(keys);
+}
+
+// Orders keys by a hash of the key, which scrambles them
+int compare_scrambled_keys(void* a, void* b) {
+    unsigned int key1 = *(unsigned int*) a * 2654435761u;
+    unsigned int key2 = *(unsigned int*) b * 2654435761u;
+
+    return (key1 > key2) - (key1 < key2);
+}
+
+// Benchmarks sorting a list of keys in a scrambled order, both by relinking
+// the nodes and by sorting an array of the contents. The nodes are first
+// relinked in a scrambled order too, so that they are spread around memory
+// like those of a list which has been changed many times.
+void benchmark_list_sort(long long size) {
+    int* keys = malloc(size * sizeof(int));
+
+    for(long long i = 0; i < size; i++)
+        keys[i] = (int) (i * 2654435761LL % size);
+
+    const char* operations[] = {"sort", "sort_via_array"};
+
+    for(int operation = 0; operation < 2; operation++) {
+        struct Measurement measurement;
+        memset(&measurement, 0, sizeof(measurement));
+
+        for(long long sorted = 0; sorted < TARGET_OPS; sorted += size) {
+            LinkedList list = createLinkedList();
+            for(long long i = 0; i < size; i++)
+                list->add(list, &keys[i]);
+
+            list->sort(list, compare_scrambled_keys);
+
+            start_timing(&measurement);
+            if(operation == 0)
+                list->sort(list, compare_benchmark_keys);
+            else
+                list->sort_via_array(list, compare_benchmark_keys);
+            stop_timing(&measurement, size);
+
+            list->teardown_keep(list);
+        }
+
+        print_result("linked_list", operations[operation], size, 1, &measurement);
+    }
+
+    free(keys);
+}
+
+// Benchmarks a B+tree map holding keys in a scrambled order, built one put
+// at a time and by bulk loading, and then read by point lookups and by
+// ranges of RANGE_LENGTH keys (compared with scanning a LinkedList for the
+// same range)
+#define RANGE_LENGTH 100
+
+void benchmark_btree_map(long long size) {
+    int* keys = malloc(size * sizeof(int));
+    void** sorted_keys = malloc(size * sizeof(void*));
+
+    for(long long i = 0; i < size; i++)
+        keys[i] = (int) (i * 2654435761LL % size);
+
+    BTreeMap map;
+    struct Measurement measurement;
+
+    /* Build maps one put at a time */
+    memset(&measurement, 0, sizeof(measurement));
+
+    for(long long built = 0; built < TARGET_OPS; built += size) {
+        map = createBTreeMap(compare_benchmark_keys);
+
+        start_timing(&measurement);
+        for(long long i = 0; i < size; i++)
+            map->put(map, &keys[i], &keys[i]);
+        stop_timing(&measurement, size);
+
+        map->teardown_keep(map);
+    }
+
+    print_result("btree_map", "put", size, 1, &measurement);
+
+    /* Build maps by bulk loading the keys in order */
+    memset(&measurement, 0, sizeof(measurement));
+
+    for(long long i = 0; i < size; i++)
+        sorted_keys[keys[i]] = &keys[i];
+
+    for(long long built = 0; built < TARGET_OPS; built += size) {
+        map = createBTreeMap(compare_benchmark_keys);
+
+        start_timing(&measurement);
+        map->bulk_load(map, sorted_keys, sorted_keys, (int) size);
+        stop_timing(&measurement, size);
+
+        map->teardown_keep(map);
+    }
+
+    print_result("btree_map", "bulk_load", size, 1, &measurement);
+
+    map = createBTreeMap(compare_benchmark_keys);
+    map->bulk_load(map, sorted_keys, sorted_keys, (int) size);
+
+    /* Look up keys in a scrambled order */
+    memset(&measurement, 0, sizeof(measurement));
+
+    start_timing(&measurement);
+    for(long long i = 0; i < TARGET_OPS; i++)
+        map->get(map, &keys[i % size]);
+    stop_timing(&measurement, TARGET_OPS);
+
+    print_result("btree_map", "get", size, 1, &measurement);
+
+    /* Read ranges of keys, starting from scrambled keys */
+    long long range_ops = num_ops(RANGE_LENGTH, TARGET_OPS);
+    volatile long long sink = 0;
+
+    memset(&measurement, 0, sizeof(measurement));
+
+    start_timing(&measurement);
+    for(long long i = 0; i < range_ops; i++) {
+        int from = keys[i % size];
+        int to = from + RANGE_LENGTH - 1;
+
+        struct BTreeIterator it = map->range(map, &from, &to);
+
+        while(it.has_next(&it))
+            sink += *(int*) it.next(&it);
+    }
+    stop_timing(&measurement, range_ops);
+
+    print_result("btree_map", "range", size, 1, &measurement);
+
+    map->teardown_keep(map);
+
+    /* Read the same ranges by scanning a list */
+    LinkedList list = createLinkedList();
+
+    for(long long i = 0; i < size; i++)
+        list->add(list, &keys[i]);
+
+    long long scan_ops = num_ops(size, TARGET_OPS);
+
+    memset(&measurement, 0, sizeof(measurement));
+
+    start_timing(&measurement);
+    for(long long i = 0; i < scan_ops; i++) {
+        int from = keys[i % size];
+        int to = from + RANGE_LENGTH - 1;
+
+        for(struct Node* node = list->head; node != NULL; node = node->next) {
+            int key = *(int*) node->contents;
+
+            if(key >= from && key <= to)
+                sink += key;
+        }
+    }
+    stop_timing(&measurement, scan_ops);
+
+    print_result("linked_list", "range", size, 1, &measurement);
+
+    list->teardown_keep(list);
+
+    free(sorted_keys);
+    free(keys);
+}
+
+// Adds up the values of the keys visited by a radix tree prefix query
+void sum_radix_value(void* key, int key_length, void* value, void* ctx) {
+    *(long long*) ctx += *(char*) value;
+}
+
+// Benchmarks a radix tree holding size decimal keys of RADIX_KEY_LENGTH
+// digits in a scrambled order, read by point lookups and by prefix queries
+// matching up to 100 keys (compared with scanning a LinkedList for keys
+// with the same prefix)
+#define RADIX_KEY_LENGTH 8
+#define RADIX_PREFIX_LENGTH (RADIX_KEY_LENGTH - 2)
+
+void benchmark_radix_tree(long long size) {
+    char* keys = malloc(size * (RADIX_KEY_LENGTH + 1));
+
+    for(long long i = 0; i < size; i++) {
+        char digits[32];
+
+        snprintf(digits, sizeof(digits), "%0*lld", RADIX_KEY_LENGTH, i * 2654435761LL % size);
+        memcpy(keys + i * (RADIX_KEY_LENGTH + 1), digits, RADIX_KEY_LENGTH + 1);
+    }
+
+    RadixTree tree;
+    struct Measurement measurement;
+
+    /* Build trees one put at a time */
+    memset(&measurement, 0, sizeof(measurement));
+
+    for(long long built = 0; built < TARGET_OPS; built += size) {
+        tree = createRadixTree();
+
+        start_timing(&measurement);
+        for(long long i = 0; i < size; i++) {
+            char* key = keys + i * (RADIX_KEY_LENGTH + 1);
+            tree->put(tree, key, RADIX_KEY_LENGTH, key);
+        }
+        stop_timing(&measurement, size);
+
+        if(built + size < TARGET_OPS)
+            tree->teardown_keep(tree);
+    }
+
+    print_result("radix_tree", "put", size, 1, &measurement);
+
+    /* Look up keys in a scrambled order */
+    memset(&measurement, 0, sizeof(measurement));
+
+    start_timing(&measurement);
+    for(long long i = 0; i < TARGET_OPS; i++)
+        tree->get(tree, keys + (i % size) * (RADIX_KEY_LENGTH + 1), RADIX_KEY_LENGTH);
+    stop_timing(&measurement, TARGET_OPS);
+
+    print_result("radix_tree", "get", size, 1, &measurement);
+
+    /* Find every key sharing all but the last two digits of a key */
+    long long prefix_ops = num_ops(100, TARGET_OPS);
+    volatile long long sink = 0;
+    long long sum = 0;
+
+    memset(&measurement, 0, sizeof(measurement));
+
+    start_timing(&measurement);
+    for(long long i = 0; i < prefix_ops; i++)
+        tree->prefix_foreach(tree, keys + (i % size) * (RADIX_KEY_LENGTH + 1), RADIX_PREFIX_LENGTH, sum_radix_value, &sum);
+    stop_timing(&measurement, prefix_ops);
+
+    sink += sum;
+
+    print_result("radix_tree", "prefix", size, 1, &measurement);
+
+    tree->teardown_keep(tree);
+
+    /* Find the same keys by scanning a list */
+    LinkedList list = createLinkedList();
+
+    for(long long i = 0; i < size; i++)
+        list->add(list, keys + i * (RADIX_KEY_LENGTH + 1));
+
+    long long scan_ops = num_ops(size, TARGET_OPS);
+
+    memset(&measurement, 0, sizeof(measurement));
+
+    start_timing(&measurement);
+    for(long long i = 0; i < scan_ops; i++) {
+        char* prefix = keys + (i % size) * (RADIX_KEY_LENGTH + 1);
+
+        for(struct Node* node = list->head; node != NULL; node = node->next) {
+            if(memcmp(node->contents, prefix, RADIX_PREFIX_LENGTH) == 0)
+                sink += *(char*) node->contents;
+        }
+    }
+    stop_timing(&measurement, scan_ops);
+
+    print_result("linked_list", "prefix", size, 1, &measurement);
+
+    list->teardown_keep(list);
+
+    free(keys);
+}
+
+// Benchmarks a scheduler holding size deadlines, which repeatedly takes the
+// earliest deadline and pushes it back later on, first by scanning a
+// LinkedList for the minimum, and then with binary and 4-ary heaps
+void benchmark_priority_queue(long long size) {
+    int* keys = malloc(size * sizeof(int));
+
+    struct Measurement list_measurement;
+    memset(&list_measurement, 0, sizeof(list_measurement));
+
+    for(long long i = 0; i < size; i++)
+        keys[i] = (int) (i * 2654435761LL % size);
+
+    LinkedList list = createLinkedList();
+
+    for(long long i = 0; i < size; i++)
+        list->add(list, &keys[i]);
+
+    long long list_ops = num_ops(size, TARGET_OPS);
+
+    start_timing(&list_measurement);
+
+    for(long long i = 0; i < list_ops; i++) {
+        struct ListIterator it = list->begin(list);
+
+        int* earliest = it.next(&it);
+        int earliest_index = 0;
+
+        while(it.has_next(&it)) {
+            int* key = it.next(&it);
+
+            if(*key < *earliest) {
+                earliest = key;
+                earliest_index = it.index;
+            }
+        }
+
+        list->delete_keep(list, earliest_index);
+
+        *earliest += (int) size;
+        list->add(list, earliest);
+    }
+
+    stop_timing(&list_measurement, list_ops);
+
+    list->teardown_keep(list);
+
+    print_result("linked_list", "take_earliest", size, 1, &list_measurement);
+
+    for(int arity = 2; arity <= 4; arity += 2) {
+        struct Measurement heapify_measurement;
+        struct Measurement queue_measurement;
+        memset(&heapify_measurement, 0, sizeof(heapify_measurement));
+        memset(&queue_measurement, 0, sizeof(queue_measurement));
+
+        for(long long i = 0; i < size; i++)
+            keys[i] = (int) (i * 2654435761LL % size);
+
+        void** contents = malloc(size * sizeof(void*));
+
+        for(long long i = 0; i < size; i++)
+            contents[i] = &keys[i];
+
+        PriorityQueue queue = createPriorityQueue(compare_benchmark_keys, arity);
+
+        start_timing(&heapify_measurement);
+        queue->heapify(queue, contents, (int) size, NULL);
+        stop_timing(&heapify_measurement, size);
+
+        start_timing(&queue_measurement);
+
+        for(long long i = 0; i < TARGET_OPS; i++) {
+            int* earliest = queue->pop(queue);
+
+            *earliest += (int) size;
+            queue->push(queue, earliest, NULL);
+        }
+
+        stop_timing(&queue_measurement, TARGET_OPS);
+
+        queue->teardown_keep(queue);
+        free(contents);
+
+        const char* name = arity == 2 ? "binary_heap" : "4_ary_heap";
+
+        print_result(name, "heapify", size, 1, &heapify_measurement);
+        print_result(name, "take_earliest", size, 1, &queue_measurement);
+    }
+
+    free(keys);
+}
+
+size_t int_size(void* contents) {
+    return sizeof(int);
+}
+
+// Benchmarks writing a list of ints to a file, and loading it back (which
+// would otherwise take one add_copy per node)
+void benchmark_serialization(long long size) {
+    struct Measurement serialize_measurement;
+    struct Measurement deserialize_measurement;
+    memset(&serialize_measurement, 0, sizeof(serialize_measurement));
+    memset(&deserialize_measurement, 0, sizeof(deserialize_measurement));
+
+    LinkedList list = createLinkedList();
+    for(long long i = 0; i < size; i++)
+        list->add(list, &benchmark_data[i % THROUGHPUT_LIST_LENGTH]);
+
+    for(long long loaded = 0; loaded < TARGET_OPS; loaded += size) {
+        FILE* file = tmpfile();
+
+        start_timing(&serialize_measurement);
+        list_serialize(list, fileno(file), int_size);
+        stop_timing(&serialize_measurement, size);
+
+        start_timing(&deserialize_measurement);
+        LinkedList loaded_list = list_deserialize(fileno(file));
+        stop_timing(&deserialize_measurement, size);
+
+        loaded_list->teardown(loaded_list);
+        fclose(file);
+    }
+
+    print_result("linked_list", "serialize", size, 1, &serialize_measurement);
+    print_result("linked_list", "deserialize", size, 1, &deserialize_measurement);
+
+    list->teardown_keep(list);
+}
+
+// Allocators compared by benchmark_allocators, each created fresh for
+// every round and torn down at the end of it
+Allocator create_stdlib_allocator() {
+    return &stdlib_allocator;
+}
+
+Allocator create_bump_allocator() {
+    return createBumpAllocator(65536);
+}
+
+struct {
+    const char* name;
+    Allocator (*create)();
+} benchmark_allocators_list[] = {
+    {"stdlib_allocator", create_stdlib_allocator},
+    {"bump_allocator", create_bump_allocator},
+    {"caching_allocator", createCachingAllocator}
+};
+
+// Builds and tears down lists and vectors on each allocator, and churns
+// through nodes by deleting from the head of a list and adding to its tail
+void benchmark_allocators(long long size) {
+    int num_allocators = sizeof(benchmark_allocators_list) / sizeof(benchmark_allocators_list[0]);
+
+    for(int a = 0; a < num_allocators; a++) {
+        const char* name = benchmark_allocators_list[a].name;
+
+        struct Measurement build_measurement;
+        struct Measurement churn_measurement;
+        struct Measurement vector_measurement;
+        memset(&build_measurement, 0, sizeof(build_measurement));
+        memset(&churn_measurement, 0, sizeof(churn_measurement));
+        memset(&vector_measurement, 0, sizeof(vector_measurement));
+
+        for(long long built = 0; built < TARGET_OPS; built += size) {
+            start_timing(&build_measurement);
+
+            Allocator allocator = benchmark_allocators_list[a].create();
+            LinkedList list = createLinkedListWithAllocator(allocator);
+
+            for(long long i = 0; i < size; i++)
+                list->add(list, &benchmark_data[i % THROUGHPUT_LIST_LENGTH]);
+
+            list->teardown_keep(list);
+            allocator->teardown(allocator);
+
+            stop_timing(&build_measurement, size);
+        }
+
+        for(long long churned = 0; churned < TARGET_OPS; churned += size) {
+            Allocator allocator = benchmark_allocators_list[a].create();
+            LinkedList list = createLinkedListWithAllocator(allocator);
+
+            for(long long i = 0; i < size; i++)
+                list->add(list, &benchmark_data[i % THROUGHPUT_LIST_LENGTH]);
+
+            start_timing(&churn_measurement);
+
+            for(long long i = 0; i < size; i++) {
+                list->delete_keep(list, 0);
+                list->add(list, &benchmark_data[i % THROUGHPUT_LIST_LENGTH]);
+            }
+
+            stop_timing(&churn_measurement, size);
+
+            list->teardown_keep(list);
+            allocator->teardown(allocator);
+        }
+
+        for(long long grown = 0; grown < TARGET_OPS; grown += size) {
+            start_timing(&vector_measurement);
+
+            Allocator allocator = benchmark_allocators_list[a].create();
+            Vector vector = createVectorWithAllocator(allocator);
+
+            for(long long i = 0; i < size; i++)
+                vector->add(vector, &benchmark_data[i % THROUGHPUT_LIST_LENGTH]);
+
+            vector->teardown_keep(vector);
+            allocator->teardown(allocator);
+
+            stop_timing(&vector_measurement, size);
+        }
+
+        print_result(name, "list_build_teardown", size, 1, &build_measurement);
+        print_result(name, "list_churn", size, 1, &churn_measurement);
+        print_result(name, "vector_growth", size, 1, &vector_measurement);
+    }
+}
+
+// A list of int32_t values stored inline, compared by benchmark_typed_list
+// against a Vector of pointers to ints allocated one by one
+DS_DEFINE_LIST(int32, int32_t)
+
+// Builds a typed list and a boxed Vector of the same values, then sums
+// them, so that both the allocation per value and the pointer chase per
+// value show up in the results
+void benchmark_typed_list(long long size) {
+    struct Measurement typed_build;
+    struct Measurement boxed_build;
+    struct Measurement typed_sum;
+    struct Measurement boxed_sum;
+    memset(&typed_build, 0, sizeof(typed_build));
+    memset(&boxed_build, 0, sizeof(boxed_build));
+    memset(&typed_sum, 0, sizeof(typed_sum));
+    memset(&boxed_sum, 0, sizeof(boxed_sum));
+
+    long long rounds = num_ops(size, 100);
+    volatile long long sink = 0;
+
+    for(long long built = 0; built < TARGET_OPS; built += size) {
+        start_timing(&typed_build);
+
+        int32_list list = int32_list_create();
+
+        for(long long i = 0; i < size; i++)
+            int32_list_add(list, (int32_t) i);
+
+        int32_list_teardown(list);
+
+        stop_timing(&typed_build, size);
+
+        start_timing(&boxed_build);
+
+        Vector vector = createVector();
+
+        for(long long i = 0; i < size; i++) {
+            int* value = malloc(sizeof(int));
+            *value = (int) i;
+            vector->add(vector, value);
+        }
+
+        vector->teardown(vector);
+
+        stop_timing(&boxed_build, size);
+    }
+
+    int32_list list = int32_list_create();
+    Vector vector = createVector();
+
+    for(long long i = 0; i < size; i++) {
+        int* value = malloc(sizeof(int));
+        *value = (int) i;
+
+        int32_list_add(list, (int32_t) i);
+        vector->add(vector, value);
+    }
+
+    start_timing(&typed_sum);
+
+    for(long long r = 0; r < rounds; r++) {
+        long long sum = 0;
+
+        for(int i = 0; i < list->length; i++)
+            sum += list->values[i];
+
+        sink += sum;
+    }
+
+    stop_timing(&typed_sum, rounds * size);
+
+    start_timing(&boxed_sum);
+
+    for(long long r = 0; r < rounds; r++) {
+        long long sum = 0;
+
+        for(int i = 0; i < vector->length; i++)
+            sum += *(int*) vector->contents[i];
+
+        sink += sum;
+    }
+
+    stop_timing(&boxed_sum, rounds * size);
+
+    int32_list_teardown(list);
+    vector->teardown(vector);
+
+    print_result("int32_list", "build_teardown", size, 1, &typed_build);
+    print_result("boxed_vector", "build_teardown", size, 1, &boxed_build);
+    print_result("int32_list", "sum", size, 1, &typed_sum);
+    print_result("boxed_vector", "sum", size, 1, &boxed_sum);
+}
+
+// Uses each structure as a FIFO queue holding size contents, pushing to the
+// back and popping from the front (RingDeque also in batches of
+// FIFO_BATCH with push_n and pop_n)
+#define FIFO_BATCH 64
+
+void benchmark_fifo(long long size) {
+    struct Measurement list_measurement;
+    struct Measurement doubly_measurement;
+    struct Measurement ring_measurement;
+    struct Measurement batch_measurement;
+    memset(&list_measurement, 0, sizeof(list_measurement));
+    memset(&doubly_measurement, 0, sizeof(doubly_measurement));
+    memset(&ring_measurement, 0, sizeof(ring_measurement));
+    memset(&batch_measurement, 0, sizeof(batch_measurement));
+
+    LinkedList list = createLinkedList();
+    DoublyLinkedList doubly = createDoublyLinkedList();
+    RingDeque ring = createRingDeque();
+    RingDeque batch_ring = createRingDeque();
+
+    for(long long i = 0; i < size; i++) {
+        void* contents = &benchmark_data[i % THROUGHPUT_LIST_LENGTH];
+
+        list->add(list, contents);
+        doubly->add(doubly, contents);
+        ring->push_back(ring, contents);
+        batch_ring->push_back(batch_ring, contents);
+    }
+
+    start_timing(&list_measurement);
+
+    for(long long i = 0; i < TARGET_OPS; i++) {
+        list->add(list, list->get(list, 0));
+        list->delete_keep(list, 0);
+    }
+
+    stop_timing(&list_measurement, TARGET_OPS);
+
+    start_timing(&doubly_measurement);
+
+    for(long long i = 0; i < TARGET_OPS; i++)
+        doubly->add(doubly, doubly->pop_front(doubly));
+
+    stop_timing(&doubly_measurement, TARGET_OPS);
+
+    start_timing(&ring_measurement);
+
+    for(long long i = 0; i < TARGET_OPS; i++)
+        ring->push_back(ring, ring->pop_front(ring));
+
+    stop_timing(&ring_measurement, TARGET_OPS);
+
+    void* batch[FIFO_BATCH];
+
+    start_timing(&batch_measurement);
+
+    long long num_moved = 0;
+
+    while(num_moved < TARGET_OPS) {
+        int num_popped = batch_ring->pop_n(batch_ring, batch, FIFO_BATCH);
+        batch_ring->push_n(batch_ring, batch, num_popped);
+
+        num_moved += num_popped;
+    }
+
+    stop_timing(&batch_measurement, num_moved);
+
+    list->teardown_keep(list);
+    doubly->teardown_keep(doubly);
+    ring->teardown_keep(ring);
+    batch_ring->teardown_keep(batch_ring);
+
+    print_result("linked_list", "fifo", size, 1, &list_measurement);
+    print_result("doubly_linked_list", "fifo", size, 1, &doubly_measurement);
+    print_result("ring_deque", "fifo", size, 1, &ring_measurement);
+    print_result("ring_deque", "fifo_batched", size, 1, &batch_measurement);
+}
+
+// A LinkedList behind one global mutex, which is how lists were shared
+// between threads before ConcurrentList
+LinkedList locked_list;
+pthread_mutex_t list_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+ConcurrentList concurrent_list;
+
+// Each thread does a mix of 80% gets, 10% adds and 10% deletes, so that
+// the length of the list stays about the same
+void* locked_list_worker(void* seed_pointer) {
+    unsigned int seed = (unsigned int) (long) seed_pointer;
+
+    for(int i = 0; i < THROUGHPUT_OPS; i++) {
+        int op = rand_r(&seed) % 10;
+        int index = rand_r(&seed) % THROUGHPUT_LIST_LENGTH;
+
+        pthread_mutex_lock(&list_mutex);
+
+        if(op == 0)
+            locked_list->add(locked_list, &benchmark_data[index]);
+        else if(op == 1)
+            locked_list->delete_keep(locked_list, 0);
+        else
+            locked_list->get_or_default(locked_list, index, NULL);
+
+        pthread_mutex_unlock(&list_mutex);
+    }
+
+    return NULL;
+}
+
+void* concurrent_list_worker(void* seed_pointer) {
+    unsigned int seed = (unsigned int) (long) seed_pointer;
+
+    for(int i = 0; i < THROUGHPUT_OPS; i++) {
+        int op = rand_r(&seed) % 10;
+        int index = rand_r(&seed) % THROUGHPUT_LIST_LENGTH;
+
+        if(op == 0)
+            concurrent_list->add(concurrent_list, &benchmark_data[index]);
+        else if(op == 1)
+            concurrent_list->delete_keep(concurrent_list, 0);
+        else
+            concurrent_list->get_or_default(concurrent_list, index, NULL);
+    }
+
+    return NULL;
+}
+
+// Runs a worker on a number of threads at once, and measures the total
+// time taken for all of their operations
+void run_workers(void* (*worker)(void*), int num_threads, int ops_per_thread, struct Measurement* measurement) {
+    pthread_t threads[num_threads];
+
+    memset(measurement, 0, sizeof(struct Measurement));
+    start_timing(measurement);
+
+    for(int i = 0; i < num_threads; i++)
+        pthread_create(&threads[i], NULL, worker, (void*) (long) (i + 1));
+
+    for(int i = 0; i < num_threads; i++)
+        pthread_join(threads[i], NULL);
+
+    stop_timing(measurement, (long long) num_threads * ops_per_thread);
+}
+
+void benchmark_concurrent_throughput() {
+    struct Measurement measurement;
+
+    for(int num_threads = 1; num_threads <= 16; num_threads *= 2) {
+
+        locked_list = createLinkedList();
+        concurrent_list = createConcurrentList();
+
+        for(int i = 0; i < THROUGHPUT_LIST_LENGTH; i++) {
+            locked_list->add(locked_list, &benchmark_data[i]);
+            concurrent_list->add(concurrent_list, &benchmark_data[i]);
+        }
+
+        run_workers(locked_list_worker, num_threads, THROUGHPUT_OPS, &measurement);
+        print_result("locked_linked_list", "mixed_get_add_delete", THROUGHPUT_LIST_LENGTH, num_threads, &measurement);
+
+        run_workers(concurrent_list_worker, num_threads, THROUGHPUT_OPS, &measurement);
+        print_result("concurrent_list", "mixed_get_add_delete", THROUGHPUT_LIST_LENGTH, num_threads, &measurement);
+
+        locked_list->teardown_keep(locked_list);
+        concurrent_list->teardown_keep(concurrent_list);
+    }
+}
+
+
+
+LockFreeQueue lock_free_queue;
+
+// Each thread alternates between enqueueing and dequeueing. The locked
+// queue is a LinkedList behind one global mutex, which is how work queues
+// were shared between threads before LockFreeQueue.
+void* locked_queue_worker(void* unused) {
+    for(int i = 0; i < QUEUE_OPS; i++) {
+        pthread_mutex_lock(&list_mutex);
+
+        if(i % 2 == 0)
+            locked_list->add(locked_list, &benchmark_data[0]);
+        else
+            locked_list->delete_keep(locked_list, 0);
+
+        pthread_mutex_unlock(&list_mutex);
+    }
+
+    return NULL;
+}
+
+void* lock_free_queue_worker(void* unused) {
+    for(int i = 0; i < QUEUE_OPS; i++) {
+        if(i % 2 == 0)
+            lock_free_queue->enqueue(lock_free_queue, &benchmark_data[0]);
+        else
+            lock_free_queue->dequeue(lock_free_queue);
+    }
+
+    return NULL;
+}
+
+void benchmark_queue_throughput() {
+    struct Measurement measurement;
+
+    for(int num_threads = 1; num_threads <= 16; num_threads *= 2) {
+
+        locked_list = createLinkedList();
+        lock_free_queue = createLockFreeQueue();
+
+        run_workers(locked_queue_worker, num_threads, QUEUE_OPS, &measurement);
+        print_result("locked_linked_list", "enqueue_dequeue", 0, num_threads, &measurement);
+
+        run_workers(lock_free_queue_worker, num_threads, QUEUE_OPS, &measurement);
+        print_result("lock_free_queue", "enqueue_dequeue", 0, num_threads, &measurement);
+
+        locked_list->teardown_keep(locked_list);
+        lock_free_queue->teardown_keep(lock_free_queue);
+    }
+}
+
+
+
+// A transform heavy enough that running it dominates walking the list
+void* heavy_transform(void* contents, void* ctx) {
+    unsigned long long value = (unsigned long long) contents;
+
+    for(int i = 0; i < 200; i++)
+        value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    return (void*) value;
+}
+
+void* add_values(void* left, void* right, void* ctx) {
+    return (void*) ((unsigned long long) left + (unsigned long long) right);
+}
+
+// Benchmarks list_parallel_map and list_parallel_reduce on a long list, with
+// more and more threads
+void benchmark_parallel_operations() {
+    struct Measurement measurement;
+
+    LinkedList list = createLinkedList();
+    for(long long i = 0; i < PARALLEL_LIST_LENGTH; i++)
+        list->add(list, int_key(i));
+
+    for(int num_threads = 1; num_threads <= 16; num_threads *= 2) {
+
+        memset(&measurement, 0, sizeof(measurement));
+        start_timing(&measurement);
+        LinkedList mapped = list_parallel_map(list, heavy_transform, NULL, num_threads);
+        stop_timing(&measurement, PARALLEL_LIST_LENGTH);
+        print_result("linked_list", "parallel_map", PARALLEL_LIST_LENGTH, num_threads, &measurement);
+
+        memset(&measurement, 0, sizeof(measurement));
+        start_timing(&measurement);
+        list_parallel_reduce(mapped, add_values, NULL, NULL, num_threads);
+        stop_timing(&measurement, PARALLEL_LIST_LENGTH);
+        print_result("linked_list", "parallel_reduce", PARALLEL_LIST_LENGTH, num_threads, &measurement);
+
+        mapped->teardown_keep(mapped);
+    }
+
+    list->teardown_keep(list);
+}
+
+
+
+int main(int argc, char** argv) {
+    long long max_size = 10000000;
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            output_json = strcmp(argv[++i], "json") == 0;
+        }
+        else if(strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            max_size = atoll(argv[++i]);
+        }
+        else {
+            fprintf(stderr, "Usage : %s [--format csv|json] [--max-size N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    start_results();
+
+    for(long long size = 10; size <= max_size; size *= 10) {
+        benchmark_linked_list(size);
+        benchmark_pooled_linked_list(size);
+        benchmark_unrolled_list(size);
+        benchmark_vector(size);
+        benchmark_doubly_linked_list(size);
+        benchmark_skip_list(size);
+        benchmark_btree_map(size);
+        benchmark_radix_tree(size);
+        benchmark_list_sort(size);
+        benchmark_priority_queue(size);
+        benchmark_serialization(size);
+        benchmark_allocators(size);
+        benchmark_typed_list(size);
+        benchmark_fifo(size);
+    }
+
+    benchmark_concurrent_throughput();
+    benchmark_queue_throughput();
+    benchmark_parallel_operations();
+
+    finish_results();
+
+    return 0;
+}
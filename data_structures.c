@@ -11,6 +11,20 @@
  * the data structures. Currently, this includes :
  * 
  *     • LinkedList
+ *     • NodePool (a slab allocator which lists can draw their nodes from)
+ *     • UnrolledList
+ *     • Vector
+ *     • HashMap
+ *     • ConcurrentList (a LinkedList which can be shared between threads)
+ *     • LockFreeQueue (a FIFO queue which can be shared between threads)
+ *     • DoublyLinkedList
+ *     • SkipList (a sorted list with O(log n) access by index)
+ *     • RingDeque (a double ended queue stored in a circular array)
+ *     • PriorityQueue (a d-ary heap, with handles for decrease_key)
+ *     • BTreeMap (an ordered map stored in a B+tree, with range iterators)
+ *     • RadixTree (a map from byte strings to values, with prefix queries)
+ *     • Allocator (where the structures get their memory from)
+ *     • DS_DEFINE_LIST (a list of values of one type, stored inline)
  * 
  * These structs all are designed to accept void pointers to data as their 
  * contents. This means that any type of data can be stored in these data 
@@ -31,7 +45,96 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
-#include <stdarg.h>
+#include <limits.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif
+
+
+
+// When the library is built with -DDS_STATS, every LinkedList counts what
+// it does in its stats (see struct ListStats). Otherwise, these compile to
+// nothing, and their arguments are never evaluated.
+#ifdef DS_STATS
+    #define COUNT_STAT(list, stat, amount) ((list)->stats.stat += (amount))
+
+    #define COUNT_PEAK_LENGTH(list)({\
+        if((list)->length > (list)->stats.peak_length)\
+            (list)->stats.peak_length = (list)->length;\
+    })
+#else
+    #define COUNT_STAT(list, stat, amount) ((void) 0)
+
+    #define COUNT_PEAK_LENGTH(list) ((void) 0)
+#endif
+
+
+
+/**
+ * @brief Gets size bytes of memory from an allocator.
+ * 
+ * @param allocator - The allocator to get the memory from.
+ * @param size - The number of bytes to get.
+ * 
+ * @returns NULL on failure (allocator is out of memory), pointer to the
+ * memory on success.
+ */
+void* allocate(struct Allocator* allocator, size_t size) {
+
+    return allocator->alloc(allocator->ctx, size);
+}
+
+
+/**
+ * @brief Gives memory back to the allocator which it came from.
+ * 
+ * @param allocator - The allocator which the memory came from.
+ * @param pointer - The memory to give back (may be NULL).
+ */
+void deallocate(struct Allocator* allocator, void* pointer) {
+
+    if(pointer != NULL)
+        allocator->free(allocator->ctx, pointer);
+}
+
+
+/**
+ * @brief Resizes memory from an allocator, keeping its first bytes. If the
+ * allocator cannot resize memory, new memory is allocated and the contents
+ * are copied over.
+ * 
+ * @remark On failure, the old memory is left untouched.
+ * 
+ * @param allocator - The allocator which the memory came from.
+ * @param pointer - The memory to resize (may be NULL).
+ * @param old_size - The number of bytes the memory was allocated with.
+ * @param new_size - The number of bytes to resize the memory to.
+ * 
+ * @returns NULL on failure (allocator is out of memory), pointer to the
+ * resized memory on success.
+ */
+void* reallocate(struct Allocator* allocator, void* pointer, size_t old_size, size_t new_size) {
+
+    if(allocator->resize != NULL)
+        return allocator->resize(allocator->ctx, pointer, old_size, new_size);
+
+    void* resized = allocate(allocator, new_size);
+
+    if(resized == NULL)
+        return NULL;
+
+    if(pointer != NULL) {
+        memcpy(resized, pointer, old_size < new_size ? old_size : new_size);
+        deallocate(allocator, pointer);
+    }
+
+    return resized;
+}
 
 
 
@@ -54,7 +157,7 @@ int handle_head_uninitialized(struct LinkedList* list) {
     if(list->head == NULL) {
 
         // Allocate new space on the heap for the head.
-        list->head = (struct Node*) malloc(sizeof(struct Node));
+        list->head = (struct Node*) allocate(list->allocator, sizeof(struct Node));
 
         if(list->head == NULL) {
             return 0; //couldn't allocate enough heap for the next node.
@@ -67,11 +170,144 @@ int handle_head_uninitialized(struct LinkedList* list) {
 }
 
 
+
+/**
+ * @brief Allocates a new node for a list, either from the list's pool (if
+ * it has one) or from the list's allocator.
+ * 
+ * @param list - The list which the node will belong to.
+ * 
+ * @returns NULL on failure (not enough heap to allocate node), pointer to
+ * the new (uninitialized) node on success.
+ */
+struct Node* allocate_node(struct LinkedList* list) {
+
+    if(list->pool != NULL)
+        return (struct Node*) list->pool->allocate(list->pool);
+
+    COUNT_STAT(list, mallocs, 1);
+    COUNT_STAT(list, bytes_allocated, sizeof(struct Node));
+
+    return (struct Node*) allocate(list->allocator, sizeof(struct Node));
+}
+
+
+/**
+ * @brief Checks whether a node stores its contents inline, right after the
+ * node itself (see add_inline).
+ * 
+ * @param node - The node to check.
+ * 
+ * @returns 1 if the contents of the node are inline, 0 otherwise.
+ */
+int is_inline_node(struct Node* node) {
+
+    return node->contents == (void*) node->inline_contents;
+}
+
+
+/**
+ * @brief Frees the contents of a node, unless they are stored inline (in
+ * which case they are freed along with the node), or they are in the file
+ * mapped by the list (in which case they are unmapped with the list).
+ * 
+ * @param list - The list which the node belongs to.
+ * @param node - The node whose contents will be freed.
+ */
+void free_contents(struct LinkedList* list, struct Node* node) {
+
+    if(node->contents == NULL || is_inline_node(node))
+        return;
+
+    char* contents = (char*) node->contents;
+    char* mapping = (char*) list->mapping;
+
+    if(mapping != NULL && contents >= mapping && contents < mapping + list->mapping_length)
+        return;
+
+    COUNT_STAT(list, frees, 1);
+
+    free(node->contents);
+}
+
+
+/**
+ * @brief Frees a node which belonged to a list, either by giving it back to
+ * the list's pool (if it has one) or to the list's allocator.
+ * 
+ * @remark This does not free the contents of the node, unless they are
+ * stored inline. Nodes with inline contents always go back to the list's
+ * allocator.
+ * 
+ * @param list - The list which the node belonged to.
+ * @param node - The node to free.
+ */
+void free_node(struct LinkedList* list, struct Node* node) {
+
+    if(is_inline_node(node)) {
+        list->inline_nodes--;
+        COUNT_STAT(list, frees, 1);
+        deallocate(list->allocator, node);
+    }
+    else if(list->pool != NULL) {
+        list->pool->release(list->pool, node);
+    }
+    else {
+        COUNT_STAT(list, frees, 1);
+        deallocate(list->allocator, node);
+    }
+}
+
+
+/**
+ * @brief Finds the node at a given index in a list. The walk starts from the
+ * list's finger (the node most recently found by index) if it is at or
+ * before the index, and from the head otherwise, and the finger is then
+ * moved to the node found. The last node is found straight from the tail.
+ * 
+ * @remark The index must exist in the list. Anything which relinks nodes
+ * before the finger (other than through this function) must reset the
+ * finger to NULL, or move it to a node whose index it knows.
+ * 
+ * @param list - The list to find the node in.
+ * @param index - The index of the node to find.
+ * 
+ * @returns Pointer to the node at the index.
+ */
+struct Node* find_node(struct LinkedList* list, int index) {
+
+    struct Node* current_node = list->head;
+    int current_index = 0;
+
+    if(index == list->length - 1) {
+        current_node = list->tail;
+        current_index = index;
+    }
+    else if(list->finger != NULL && list->finger_index <= index) {
+        current_node = list->finger;
+        current_index = list->finger_index;
+    }
+
+    COUNT_STAT(list, nodes_traversed, index - current_index);
+
+    for(; current_index < index; current_index++) {
+        current_node = current_node->next;
+    }
+
+    list->finger = current_node;
+    list->finger_index = index;
+
+    return current_node;
+}
+
+
+
 /**
  * @brief Adds a new node with contents "contents" to the end of the list. This
  * contents is a void pointer to some data in memory.
  * 
- * @remark Also increments the length of the list by 1 on success.
+ * @remark Also increments the length of the list by 1 on success. This is
+ * O(1), since the list keeps a pointer to its tail.
  * 
  * @param list - The list to add the new Node to.
  * @param contents - The contents to include in the node.
@@ -82,25 +318,21 @@ int add(struct LinkedList* list, void* contents) {
 
     assertf(list != NULL, "Tried to insert into a NULL Linked List.\n");
 
-    // This Node will traverse through to the end of the list.
-    struct Node* prev_node = list->head;
-    
-    // Traversing list over [1,length) (since we start at the head).
-    for(int i = 1; i < list->length; i++) {
-        prev_node = prev_node->next;
-    }
+    // The tail is the last node in the list, so there is no need to traverse
+    // the list to find the end of it.
+    struct Node* prev_node = list->tail;
 
     // Create new node for the data @ contents
-    struct Node* new_node = malloc(sizeof(struct Node));
+    struct Node* new_node = allocate_node(list);
 
     // Check for NULL on malloc (no more space in heap)
     if(new_node == NULL)
         return 0;
 
     new_node->contents = contents;
+    new_node->next = NULL;
 
-    // If we never traversed any nodes, then prev_node will be NULL.
-    // This means that the list is empty.
+    // If there is no tail, then the list is empty.
     if(prev_node == NULL) {
         list->head = new_node;
     }
@@ -110,15 +342,75 @@ int add(struct LinkedList* list, void* contents) {
         prev_node->next = new_node;
     }
 
+    // The new node is now the last node in the list
+    list->tail = new_node;
+
     // Increment size of list
     list->length++;
 
+    COUNT_STAT(list, adds, 1);
+    COUNT_PEAK_LENGTH(list);
+
     // Return 1 (success)
     return 1;
 }
 
 
 
+/**
+ * @brief Adds a new node to the end of the list which holds a copy of
+ * num_bytes bytes of "contents" inline, right after the node. The node and
+ * its contents are allocated together, so the copy costs a single allocation
+ * and sits next to the node in memory.
+ * 
+ * @remark Nodes with inline contents are always allocated from the list's
+ * allocator, even if the list has a pool. Their contents are freed along
+ * with the node (even by delete_keep and teardown_keep), so they must not be
+ * freed by the user. Also increments the length of the list by 1 on success.
+ * 
+ * @param list - The list to add the new Node to.
+ * @param contents - The data to copy into the node.
+ * @param num_bytes - The number of bytes of data to copy.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int add_inline(struct LinkedList* list, void* contents, int num_bytes) {
+
+    assertf(list != NULL, "Tried to insert into a NULL Linked List.\n");
+
+    assertf(num_bytes > 0, "Tried to add %d bytes inline to a Linked List.\n", num_bytes);
+
+    COUNT_STAT(list, mallocs, 1);
+    COUNT_STAT(list, bytes_allocated, sizeof(struct Node) + num_bytes);
+
+    struct Node* new_node = (struct Node*) allocate(list->allocator, sizeof(struct Node) + num_bytes);
+
+    if(new_node == NULL)
+        return 0;
+
+    memcpy(new_node->inline_contents, contents, num_bytes);
+
+    new_node->contents = new_node->inline_contents;
+    new_node->next = NULL;
+
+    if(list->tail == NULL)
+        list->head = new_node;
+    else
+        list->tail->next = new_node;
+
+    list->tail = new_node;
+
+    list->length++;
+    list->inline_nodes++;
+
+    COUNT_STAT(list, adds, 1);
+    COUNT_PEAK_LENGTH(list);
+
+    return 1;
+}
+
+
+
 /**
  * @brief Inserts a new node with contents "contents" into a list at a given
  * index. This contents is a void pointer to some data in memory.
@@ -139,48 +431,44 @@ int insert(struct LinkedList* list, int index, void* contents) {
 
     assertf(index >= 0, "Tried to insert into Linked List at negative index.\n");
 
-    // Keep a pointer to the nodes which will come before and after the node 
-    // that we will insert.
-    struct Node* next_node = list->head;
-
-    struct Node* prev_node = NULL; // prev_node starts at null because nothing
-                                   // is before the head
-
-    // Traverses list over [0,index), because prev_node starts from the position
-    // 0, before the head of the list.
-    for(int i = 0; i < index; i++) {
+    // (inserting past the end of the list also counts as adds)
+    COUNT_STAT(list, inserts, 1);
 
-        // Advance prev_node by 1
-        prev_node = next_node;
+    // If we are inserting at or past the end of the list, fill any gap with
+    // nodes (note that the contents for all of these new nodes will be
+    // NULL !!!) and then append the new node using the tail.
+    if(index >= list->length) {
 
-        // If we have gone past the end of the list, keep trying to insert
-        // more nodes to fill the gap
-        if(i >= list->length) {
-
-            // note that the contents for all of these new nodes will
-            // be NULL !!!
-            next_node->next = (struct Node*) malloc(sizeof(struct Node));
-
-            if(next_node->next == NULL) {
+        while(list->length < index) {
+            if(!add(list, NULL))
                 return 0; //couldn't allocate enough heap for the next node.
-            }
-
-            list->length++;
         }
 
-        next_node = next_node->next;
+        return add(list, contents);
     }
- 
+
     // Create new node structure to be inserted into list.
-    struct Node* new_node = (struct Node*) malloc(sizeof(struct Node));
+    struct Node* new_node = allocate_node(list);
 
     // If malloc returns NULL, there is not enough space left in the heap
     if(new_node == NULL)
         return 0;
 
+    // Keep a pointer to the nodes which will come before and after the node 
+    // that we will insert (prev_node is NULL when inserting at the head,
+    // because nothing is before the head).
+    struct Node* prev_node = index == 0 ? NULL : find_node(list, index - 1);
+    struct Node* next_node = prev_node == NULL ? list->head : prev_node->next;
+
     new_node->contents = contents;
     list->length++;
 
+    // The new node is at the index, and every node after it moved up by one
+    list->finger = new_node;
+    list->finger_index = index;
+
+    COUNT_PEAK_LENGTH(list);
+
     // If we never traversed any nodes, then prev_node will be NULL.
     // This means that the list is empty.
     if(prev_node == NULL) {
@@ -216,17 +504,11 @@ void* get(struct LinkedList* list, int index) {
     assertf(list != NULL, "Tried to get data from a NULL Linked List.\n");
 
     assertf(index >= 0 && index < list->length, "Tried to get data from Node at invalid index in Linked List.\n");
-    
-    // We declare a new node, which will traverse the list up to the index
-    struct Node* current_node = list->head;
 
-    // We traverse the list starting from 1 (since we start at the head)
-    for(int i = 1; i <= index; i++) {
-        current_node = current_node->next;
-    }
+    COUNT_STAT(list, gets, 1);
 
     // Return contents of desired node
-    return current_node->contents;
+    return find_node(list, index)->contents;
 }
 
 
@@ -247,24 +529,47 @@ void* get_or_default(struct LinkedList* list, int index, void* _default) {
 
     assertf(list != NULL, "Tried to get data from a NULL Linked List.\n");
 
+    COUNT_STAT(list, gets, 1);
+
     // Return default if index does not exist
     if(index < 0 || index >= list->length)
         return _default;
 
-    // Declare new node to traverse list
-    struct Node* current_node = list->head;
+    return find_node(list, index)->contents;
+}
 
-    // Traverse list starting at 1 (since we start at the head)
-    for(int i = 1; i <= index; i++) {
-        current_node = current_node->next;
-    }
 
-    return current_node->contents;
+/**
+ * @brief Copies num_bytes bytes of the contents of the node at the given index
+ * in the list into destination. This is meant for reading back small values
+ * stored with add_inline.
+ * 
+ * @param list - The list to obtain the desired Node from.
+ * @param index - The index from which the desired Node will be obtained.
+ * @param destination - Where to copy the contents to.
+ * @param num_bytes - The number of bytes to copy.
+ * 
+ * @returns 0 on failure (index does not exist in list, or the node's contents
+ * are NULL), 1 on success.
+ */
+int get_inline(struct LinkedList* list, int index, void* destination, int num_bytes) {
+
+    assertf(list != NULL, "Tried to get data from a NULL Linked List.\n");
+
+    void* contents = get_or_default(list, index, NULL);
+
+    if(contents == NULL)
+        return 0;
+
+    memcpy(destination, contents, num_bytes);
+
+    return 1;
 }
 
 
 /**
- * @brief Deletes the Node from the list at a given index.
+ * @brief Deletes the Node from the list at a given index, freeing its
+ * contents if auto_free is set (see delete and delete_keep).
  * 
  * @remark This function will decrement the size of the list by 1 on success.
  * This function also may result in a double free if two nodes are removed one
@@ -272,37 +577,26 @@ void* get_or_default(struct LinkedList* list, int index, void* _default) {
  * 
  * @param list - The list to delete desired Node from.
  * @param index - The index of the Node to be deleted.
+ * @param auto_free - Whether to free the contents of the Node.
  * 
  * @returns 0 on failure (index does not exist in list), 1 on success.
  */
-int delete(struct LinkedList* list, int index, ...) {
-
-    // Quick check to see if the no auto free is set
-
-    int auto_free = 1; // auto free is true by default
-
-    va_list args;
-    va_start(args, index);
-    if(va_arg(args, long long) == NO_AUTO_FREE) {
-        auto_free = 0;
-    }
+int delete_node(struct LinkedList* list, int index, int auto_free) {
 
     // Return 0 if index is out of bounds for the list
     if(index < 0 || index >= list->length)
         return 0;
 
     // Current node will be the one we want to remove. We keep previous to
-    // eventually link around current.
-    struct Node* current_node = list->head;
+    // eventually link around current (previous is NULL for the head).
+    struct Node* previous_node = index == 0 ? NULL : find_node(list, index - 1);
 
-    struct Node* previous_node = NULL;
+    struct Node* current_node = previous_node == NULL ? list->head : previous_node->next;
 
-    // Traverse list starting from 1 (current_node starts at the head, and
-    // current_node is the one that we will eventually delete)
-    for(int i = 1; i <= index; i++) {
-        previous_node = current_node;
-        current_node = current_node->next;
-    }
+    // The finger is left on the node before the deleted one, which keeps its
+    // index (or cleared, if there is none)
+    if(previous_node == NULL)
+        list->finger = NULL;
 
     // If we have not traversed any nodes, then we must delete the head
     // and link around it.
@@ -314,121 +608,8992 @@ int delete(struct LinkedList* list, int index, ...) {
         previous_node->next = current_node->next;
     }
 
+    // If we deleted the last node, the node before it is the new tail
+    if(current_node == list->tail) {
+        list->tail = previous_node;
+    }
+
     // Free the contents of this node.
-    if(current_node->contents != NULL && auto_free)
-        free(current_node->contents);
+    if(auto_free)
+        free_contents(list, current_node);
 
     // Free current node after unlinking it
-    free(current_node);
+    free_node(list, current_node);
 
     // Decrement length
     list->length--;
 
+    COUNT_STAT(list, deletes, 1);
+
     // Return 1 on success
     return 1;
 }
 
 
 /**
- * @brief Frees the list, all of its nodes, and all of the nodes' contents.
+ * @brief Deletes the Node from the list at a given index, and frees its
+ * contents unless the list's auto_free is turned off.
  * 
- * @remark This function may result in a double free if there are two identical
- * pointers in different contents in different nodes in the list.
+ * @remark This function will decrement the size of the list by 1 on success.
  * 
- * @param list - The list to tear down.
+ * @param list - The list to delete desired Node from.
+ * @param index - The index of the Node to be deleted.
  * 
- * @returns 1 on success.
+ * @returns 0 on failure (index does not exist in list), 1 on success.
  */
-int teardown(struct LinkedList* list, ...) {
+int delete(struct LinkedList* list, int index) {
 
-    // Quick check to see if the no auto free is set
+    return delete_node(list, index, list->auto_free);
+}
 
-    int auto_free = 1; // auto free is true by default
 
-    va_list args;
-    va_start(args, list);
-    if(va_arg(args, long long) == NO_AUTO_FREE) {
-        auto_free = 0;
-    }
+/**
+ * @brief Deletes the Node from the list at a given index, without freeing
+ * its contents (whatever the list's auto_free is).
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete desired Node from.
+ * @param index - The index of the Node to be deleted.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int delete_keep(struct LinkedList* list, int index) {
 
-    // Get the length of the list (number of nodes to traverse)
-    int length = list->length;
+    return delete_node(list, index, 0);
+}
+
+
+/**
+ * @brief Frees the list and all of its nodes, along with the nodes' contents
+ * if auto_free is set (see teardown and teardown_keep).
+ * 
+ * @remark This function may result in a double free if there are two identical
+ * pointers in different contents in different nodes in the list.
+ * 
+ * @param list - The list to tear down.
+ * @param auto_free - Whether to free the contents of the nodes.
+ * 
+ * @returns 1 on success.
+ */
+int free_list(struct LinkedList* list, int auto_free) {
 
     // Traverse list starting from head
     struct Node* current_node = list->head;
-    struct Node* previous_node = NULL;
+    struct Node* next_node = NULL;
 
-    // Free the list itself
-    free(list);
+    struct NodePool* pool = list->pool;
 
-    // Traverse starting from index 1 (since we have already seen head)
-    for(int i = 1; i < length; i++) {
+    // If this list is the only one using its pool, all of the nodes are
+    // freed at once when the pool's slabs are freed. Then, we only need to
+    // traverse the list if we have to free the contents of its nodes (or
+    // nodes with inline contents, which never come from the pool).
+    if(pool != NULL && pool->references == 1 && !auto_free && list->inline_nodes == 0)
+        current_node = NULL;
 
-        // Move to next node
-        previous_node = current_node;
-        current_node = current_node->next;
+    // Traverse until we run off of the end of the list (this also handles
+    // the case where the list is empty)
+    while(current_node != NULL) {
+
+        // Remember the next node before we free the current one
+        next_node = current_node->next;
 
         // If the contents of the node is not NULL, free it.
         //     Note, this can result in a double free if there are
         //     two identical pointers in the contents fields of two
         //     nodes in the list !
-        if(previous_node->contents != NULL && auto_free)
-            free(previous_node->contents);
+        if(auto_free)
+            free_contents(list, current_node);
         
-        // Then, free the node
-        free(previous_node);
+        // Then, free the node (unless the pool is about to free its slabs)
+        if(pool == NULL || is_inline_node(current_node))
+            deallocate(list->allocator, current_node);
+        else if(pool->references > 1)
+            pool->release(pool, current_node);
+
+        current_node = next_node;
     }
-    
-    // Free the last node in the list
-    if(current_node->contents != NULL && auto_free)
-        free(current_node->contents);
-    free(current_node);
+
+    // Drop this list's reference to its pool
+    if(pool != NULL)
+        pool->teardown(pool);
+
+    // Unmap the file the list was loaded from (along with the contents
+    // which were stored in it)
+    if(list->mapping != NULL)
+        munmap(list->mapping, list->mapping_length);
+
+    // Free the list itself
+    deallocate(list->allocator, list);
 
     // Return 1 on success
     return 1;
 }
 
 
+/**
+ * @brief Frees the list, all of its nodes, and all of the nodes' contents
+ * (unless the list's auto_free is turned off).
+ * 
+ * @remark This function may result in a double free if there are two identical
+ * pointers in different contents in different nodes in the list.
+ * 
+ * @param list - The list to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int teardown(struct LinkedList* list) {
 
-// This is used for getting the number of arguments passed to the copy
-// macros
-int get_num_args(char* macro_va_args) {
-    if(strlen(macro_va_args) == 0) {
-        return 0;
-    }
+    return free_list(list, list->auto_free);
+}
 
-    // If there were arguments passed to one of the macros
-    int num_macro_va_args = 1;
 
-    // We retrieve the number of bytes to allocate (the first argument 
-    // passed to the macro)
-    char* num_bytes_string = strtok(macro_va_args, ",");
-    
-    while(strtok(NULL, ",") != NULL) {
-        num_macro_va_args++; // This means we have more than one arg
-    }
+/**
+ * @brief Frees the list and all of its nodes, without freeing the nodes'
+ * contents (whatever the list's auto_free is).
+ * 
+ * @param list - The list to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int teardown_keep(struct LinkedList* list) {
 
-    return num_macro_va_args;
+    return free_list(list, 0);
 }
 
 
 
 /**
- * @brief Allocates, instantiates, and returns a new LinkedList, with length
- * 0 and function pointers to all of the above functions. 
+ * @brief Adds new nodes with the given array of contents to the end of the
+ * list. The new nodes are linked to each other as they are allocated, and
+ * then linked to the tail all at once.
  * 
- * @returns New LinkedList with 0 length and default function pointers.
+ * @remark If the list has a pool, all of the nodes are allocated from a
+ * single slab. Also increments the length of the list by num_contents on
+ * success. On failure, the list is left unchanged.
+ * 
+ * @param list - The list to add the new nodes to.
+ * @param contents - The array of contents to include in the new nodes.
+ * @param num_contents - The number of contents in the array.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new nodes), 1 on success.
  */
-LinkedList createLinkedList() {
-    LinkedList list = (LinkedList) malloc(sizeof(struct LinkedList));
+int add_many(struct LinkedList* list, void** contents, int num_contents) {
 
-    list->length = 0;
-    list->add = add;
-    list->insert = insert;
-    list->get = get;
-    list->get_or_default = get_or_default;
-    list->delete = delete;
-    list->teardown = teardown;
+    assertf(list != NULL, "Tried to insert into a NULL Linked List.\n");
+
+    assertf(num_contents >= 0, "Tried to add a negative number of nodes to a Linked List.\n");
+
+    if(num_contents == 0)
+        return 1;
+
+    if(list->pool != NULL && !list->pool->reserve(list->pool, num_contents))
+        return 0;
+
+    struct Node* first_node = NULL;
+    struct Node* last_node = NULL;
+
+    // Build the chain of new nodes separately from the list
+    for(int i = 0; i < num_contents; i++) {
+
+        struct Node* new_node = allocate_node(list);
+
+        // If we run out of heap, free the partial chain and give up
+        if(new_node == NULL) {
+            while(first_node != NULL) {
+                struct Node* next_node = first_node->next;
+                free_node(list, first_node);
+                first_node = next_node;
+            }
+
+            return 0;
+        }
+
+        new_node->contents = contents[i];
+        new_node->next = NULL;
+
+        if(last_node == NULL)
+            first_node = new_node;
+        else
+            last_node->next = new_node;
+
+        last_node = new_node;
+    }
+
+    // Then link the whole chain after the tail
+    if(list->tail == NULL)
+        list->head = first_node;
+    else
+        list->tail->next = first_node;
+
+    list->tail = last_node;
+    list->length += num_contents;
+
+    COUNT_STAT(list, adds, num_contents);
+    COUNT_PEAK_LENGTH(list);
+
+    return 1;
+}
+
+
+/**
+ * @brief Moves every node of another list into a list at a given index. No
+ * nodes are allocated or freed, so this is O(1) at the head or tail of the
+ * list, and O(index) elsewhere.
+ * 
+ * @remark Both lists must allocate their nodes the same way (from the same
+ * pool, and from the same allocator). The other list is left empty, and still
+ * has to be torn down.
+ * 
+ * @param list - The list to move the nodes into.
+ * @param index - The index in list that the first moved node will be at.
+ * @param other - The list to move the nodes out of.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int splice(struct LinkedList* list, int index, struct LinkedList* other) {
+
+    assertf(list != NULL && other != NULL, "Tried to splice a NULL Linked List.\n");
+
+    assertf(list != other, "Tried to splice a Linked List into itself.\n");
+
+    assertf(list->pool == other->pool && list->allocator == other->allocator, "Tried to splice Linked Lists which allocate nodes differently.\n");
+
+    assertf(other->mapping == NULL || list->mapping == NULL || other->mapping == list->mapping, "Tried to splice Linked Lists loaded from different files.\n");
+
+    if(index < 0 || index > list->length)
+        return 0;
+
+    if(other->length == 0)
+        return 1;
+
+    if(index == list->length) {
+
+        // Link the other list after the tail
+        if(list->tail == NULL)
+            list->head = other->head;
+        else
+            list->tail->next = other->head;
+
+        list->tail = other->tail;
+    }
+    else if(index == 0) {
+
+        // Link the other list before the head
+        other->tail->next = list->head;
+        list->head = other->head;
+
+        list->finger = NULL;
+    }
+    else {
+
+        // Find the node before the index, and link the other list after it
+        // (the finger is left on that node, which keeps its index)
+        struct Node* prev_node = find_node(list, index - 1);
+
+        other->tail->next = prev_node->next;
+        prev_node->next = other->head;
+    }
+
+    list->length += other->length;
+    list->inline_nodes += other->inline_nodes;
+
+    COUNT_PEAK_LENGTH(list);
+
+    // The contents of the other list may be in the file it was loaded
+    // from, so the mapping moves along with them
+    if(other->mapping != NULL) {
+        list->mapping = other->mapping;
+        list->mapping_length = other->mapping_length;
+        other->mapping = NULL;
+        other->mapping_length = 0;
+    }
+
+    other->head = NULL;
+    other->tail = NULL;
+    other->finger = NULL;
+    other->length = 0;
+    other->inline_nodes = 0;
+
+    return 1;
+}
+
+
+/**
+ * @brief Moves every node of another list onto the end of a list in O(1). No
+ * nodes are allocated or freed.
+ * 
+ * @remark Both lists must allocate their nodes the same way (from the same
+ * pool, or from the heap). The other list is left empty, and still has to be
+ * torn down.
+ * 
+ * @param list - The list to move the nodes onto.
+ * @param other - The list to move the nodes out of.
+ * 
+ * @returns 1 on success.
+ */
+int extend(struct LinkedList* list, struct LinkedList* other) {
+
+    assertf(list != NULL, "Tried to extend a NULL Linked List.\n");
+
+    return splice(list, list->length, other);
+}
+
+
+/**
+ * @brief Deletes every node in the index range [from, to) from the list. The
+ * list is traversed once to find the node before the range, and the nodes in
+ * the range are freed as they are unlinked.
+ * 
+ * @remark This function will decrement the size of the list by to - from on
+ * success. The contents are freed unless the list's auto_free is turned off.
+ * 
+ * @param list - The list to delete the nodes from.
+ * @param from - The index of the first node to be deleted.
+ * @param to - The index after the last node to be deleted.
+ * 
+ * @returns 0 on failure (range does not exist in list), 1 on success.
+ */
+int delete_range(struct LinkedList* list, int from, int to) {
+
+    int auto_free = list->auto_free;
+
+    // Return 0 if the range is out of bounds for the list
+    if(from < 0 || to > list->length || from > to)
+        return 0;
+
+    if(from == to)
+        return 1;
+
+    // Find the node before the range (NULL if the range starts at the head).
+    // The finger is left on it, since it keeps its index.
+    struct Node* previous_node = from == 0 ? NULL : find_node(list, from - 1);
+    struct Node* current_node = previous_node == NULL ? list->head : previous_node->next;
+
+    if(previous_node == NULL)
+        list->finger = NULL;
+
+    // Free every node in the range
+    for(int i = from; i < to; i++) {
+        struct Node* next_node = current_node->next;
+
+        if(auto_free)
+            free_contents(list, current_node);
+
+        free_node(list, current_node);
+
+        current_node = next_node;
+    }
+
+    // Link around the range
+    if(previous_node == NULL)
+        list->head = current_node;
+    else
+        previous_node->next = current_node;
+
+    if(current_node == NULL)
+        list->tail = previous_node;
+
+    list->length -= to - from;
+
+    COUNT_STAT(list, deletes, to - from);
+    COUNT_STAT(list, nodes_traversed, to - from);
+
+    return 1;
+}
+
+
+
+/**
+ * @brief Checks whether an iterator has another node to return.
+ * 
+ * @param iterator - The iterator to check.
+ * 
+ * @returns 1 if next can be called, 0 if the end of the list was reached.
+ */
+int iterator_has_next(struct ListIterator* iterator) {
+    return iterator->upcoming != NULL;
+}
+
+
+/**
+ * @brief Moves an iterator forward to the next node in its list, and returns
+ * the contents of that node.
+ * 
+ * @remark This function will crash the program upon trying to move past the
+ * end of the list.
+ * 
+ * @param iterator - The iterator to move.
+ * 
+ * @returns void* to contents of the next node.
+ */
+void* iterator_next(struct ListIterator* iterator) {
+
+    assertf(iterator->upcoming != NULL, "Tried to iterate past the end of a Linked List.\n");
+
+    // If current was removed, previous is already the node before upcoming
+    if(iterator->current != NULL)
+        iterator->previous = iterator->current;
+
+    iterator->current = iterator->upcoming;
+    iterator->upcoming = iterator->upcoming->next;
+    iterator->index++;
+
+    COUNT_STAT(iterator->list, nodes_traversed, 1);
+
+    return iterator->current->contents;
+}
+
+
+/**
+ * @brief Deletes the node most recently returned by next from the list, and
+ * frees its contents (unless the list's auto_free is turned off). The
+ * iterator stays in place, so the following call to next returns the node
+ * after the deleted one.
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param iterator - The iterator whose current node will be deleted.
+ * 
+ * @returns 0 on failure (there is no current node), 1 on success.
+ */
+int iterator_remove_current(struct ListIterator* iterator) {
+
+    struct LinkedList* list = iterator->list;
+    struct Node* current_node = iterator->current;
+
+    if(current_node == NULL)
+        return 0;
+
+    // Link around the current node
+    if(iterator->previous == NULL)
+        list->head = current_node->next;
+    else
+        iterator->previous->next = current_node->next;
+
+    if(current_node == list->tail)
+        list->tail = iterator->previous;
+
+    if(list->auto_free)
+        free_contents(list, current_node);
+
+    free_node(list, current_node);
+
+    list->length--;
+    list->finger = NULL;
+
+    COUNT_STAT(list, deletes, 1);
+
+    // The node before the removed one keeps its index
+    iterator->current = NULL;
+    iterator->index--;
+
+    return 1;
+}
+
+
+/**
+ * @brief Inserts a new node with contents "contents" right after the node
+ * most recently returned by next (or, if there is none, right before the node
+ * that next will return). The new node is returned by the next call to next.
+ * 
+ * @remark Also increments the length of the list by 1 on success.
+ * 
+ * @param iterator - The iterator to insert at.
+ * @param contents - The contents to include in the node.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int iterator_insert_after_current(struct ListIterator* iterator, void* contents) {
+
+    struct LinkedList* list = iterator->list;
+
+    struct Node* new_node = allocate_node(list);
+
+    if(new_node == NULL)
+        return 0;
+
+    new_node->contents = contents;
+    new_node->next = iterator->upcoming;
+
+    // The new node goes after current, or after previous if current was
+    // removed, or at the head if neither exist
+    struct Node* prev_node = iterator->current != NULL ? iterator->current : iterator->previous;
+
+    if(prev_node == NULL)
+        list->head = new_node;
+    else
+        prev_node->next = new_node;
+
+    if(new_node->next == NULL)
+        list->tail = new_node;
+
+    list->length++;
+    list->finger = NULL;
+
+    COUNT_STAT(list, inserts, 1);
+    COUNT_PEAK_LENGTH(list);
+
+    iterator->upcoming = new_node;
+
+    return 1;
+}
+
+
+
+/**
+ * @brief Returns an iterator over a list, positioned before its first node.
+ * 
+ * @param list - The list to iterate over.
+ * 
+ * @returns New iterator (by value, so that it can be kept on the stack).
+ */
+struct ListIterator begin(struct LinkedList* list) {
+
+    assertf(list != NULL, "Tried to iterate over a NULL Linked List.\n");
+
+    struct ListIterator iterator;
+
+    iterator.list = list;
+    iterator.previous = NULL;
+    iterator.current = NULL;
+    iterator.upcoming = list->head;
+    iterator.index = -1;
+    iterator.has_next = iterator_has_next;
+    iterator.next = iterator_next;
+    iterator.remove_current = iterator_remove_current;
+    iterator.insert_after_current = iterator_insert_after_current;
+
+    return iterator;
+}
+
+
+
+/**
+ * @brief Merges two sorted chains of nodes into one sorted chain. Nodes from
+ * the first chain come before equal nodes from the second, so that merging
+ * is stable.
+ * 
+ * @param first - The first chain (which came earlier in the list).
+ * @param second - The second chain.
+ * @param compare - The comparator to sort with.
+ * 
+ * @returns The first node of the merged chain.
+ */
+struct Node* merge_node_chains(struct Node* first, struct Node* second, int (*compare)(void*, void*)) {
+
+    struct Node merged;
+    struct Node* tail = &merged;
+
+    while(first != NULL && second != NULL) {
+        if(compare(first->contents, second->contents) <= 0) {
+            tail->next = first;
+            first = first->next;
+        }
+        else {
+            tail->next = second;
+            second = second->next;
+        }
+
+        tail = tail->next;
+    }
+
+    tail->next = first != NULL ? first : second;
+
+    return merged.next;
+}
+
+
+/**
+ * @brief Sorts a list with a comparator by relinking its nodes, with a stable
+ * bottom-up merge sort. This is O(n log n), and allocates nothing.
+ * 
+ * @remark Nodes are taken off the front of the list one at a time, and kept
+ * in sorted chains with power of two lengths (like the digits of a binary
+ * counter), which are merged as soon as two have the same length. Merging
+ * chains which were just built this way keeps most merges in cache.
+ * 
+ * @param list - The list to sort.
+ * @param compare - Compares the contents of two nodes, returning a negative
+ * number, 0, or a positive number if the first is less than, equal to, or
+ * greater than the second.
+ * 
+ * @returns 1 on success.
+ */
+int sort(struct LinkedList* list, int (*compare)(void*, void*)) {
+
+    assertf(list != NULL, "Tried to sort a NULL Linked List.\n");
+
+    // chains[i] is either NULL, or a sorted chain of 2^i nodes. Chains with
+    // higher indices hold nodes from earlier in the list.
+    struct Node* chains[sizeof(int) * 8] = {NULL};
+
+    struct Node* current_node = list->head;
+
+    while(current_node != NULL) {
+        struct Node* next_node = current_node->next;
+
+        // Carry the node up through the chains, merging as we go
+        struct Node* carry = current_node;
+        carry->next = NULL;
+
+        int i = 0;
+
+        while(chains[i] != NULL) {
+            carry = merge_node_chains(chains[i], carry, compare);
+            chains[i] = NULL;
+            i++;
+        }
+
+        chains[i] = carry;
+
+        current_node = next_node;
+    }
+
+    // Merge the remaining chains, from the latest nodes to the earliest
+    struct Node* sorted = NULL;
+
+    for(int i = 0; i < (int) (sizeof(chains) / sizeof(chains[0])); i++) {
+        if(chains[i] != NULL)
+            sorted = merge_node_chains(chains[i], sorted, compare);
+    }
+
+    list->head = sorted;
+    list->finger = NULL;
+
+    // Find the new tail
+    list->tail = NULL;
+
+    for(current_node = list->head; current_node != NULL; current_node = current_node->next) {
+        list->tail = current_node;
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Sorts contents[start, end) into sorted[start, end) with a stable
+ * top-down merge sort, where both arrays start out holding the same contents.
+ * Each half is sorted into contents (using sorted as scratch space), and then
+ * the halves are merged into sorted.
+ * 
+ * @remark Recursing depth first means that each small range is sorted while
+ * it is still in cache, instead of the whole array being passed over once per
+ * merge width. Short ranges are sorted with insertion sort.
+ * 
+ * @param contents - The array to sort from.
+ * @param sorted - The array to sort into.
+ * @param start - The index of the first element in the range.
+ * @param end - The index after the last element in the range.
+ * @param compare - The comparator to sort with.
+ */
+void merge_sort_contents(void** contents, void** sorted, int start, int end, int (*compare)(void*, void*)) {
+
+    // Ranges this short fit easily in cache, so insertion sort is fastest
+    if(end - start <= 16) {
+        for(int i = start + 1; i < end; i++) {
+            void* current = sorted[i];
+
+            int j = i;
+
+            while(j > start && compare(sorted[j - 1], current) > 0) {
+                sorted[j] = sorted[j - 1];
+                j--;
+            }
+
+            sorted[j] = current;
+        }
+
+        return;
+    }
+
+    int middle = start + (end - start) / 2;
+
+    merge_sort_contents(sorted, contents, start, middle, compare);
+    merge_sort_contents(sorted, contents, middle, end, compare);
+
+    // If the halves are already in order, there is nothing to merge
+    if(compare(contents[middle - 1], contents[middle]) <= 0) {
+        memcpy(&sorted[start], &contents[start], (end - start) * sizeof(void*));
+        return;
+    }
+
+    int i = start, j = middle, k = start;
+
+    while(i < middle && j < end) {
+        if(compare(contents[i], contents[j]) <= 0)
+            sorted[k++] = contents[i++];
+        else
+            sorted[k++] = contents[j++];
+    }
+
+    while(i < middle)
+        sorted[k++] = contents[i++];
+
+    while(j < end)
+        sorted[k++] = contents[j++];
+}
+
+
+/**
+ * @brief Sorts a list with a comparator, by gathering its contents into an
+ * array, sorting the array with a stable merge sort, and writing the sorted
+ * contents back into the nodes in order. This is O(n log n), and faster than
+ * relinking the nodes when they are spread around memory, since the nodes are
+ * only visited twice (in order), and the sort itself runs on an array.
+ * 
+ * @remark The nodes stay in place, and their contents are moved between
+ * them. Since contents stored inline can't leave their node, lists with
+ * inline nodes are sorted by relinking instead.
+ * 
+ * @param list - The list to sort.
+ * @param compare - Compares the contents of two nodes, returning a negative
+ * number, 0, or a positive number if the first is less than, equal to, or
+ * greater than the second.
+ * 
+ * @returns 0 on failure (not enough heap for the temporary array), 1 on
+ * success.
+ */
+int sort_via_array(struct LinkedList* list, int (*compare)(void*, void*)) {
+
+    assertf(list != NULL, "Tried to sort a NULL Linked List.\n");
+
+    if(list->inline_nodes > 0)
+        return sort(list, compare);
+
+    if(list->length < 2)
+        return 1;
+
+    // The array and the buffer are allocated together
+    size_t num_bytes = 2 * (size_t) list->length * sizeof(void*);
+
+    void** contents = allocate(list->allocator, num_bytes);
+
+    if(contents == NULL)
+        return 0;
+
+    void** sorted = contents + list->length;
+
+    struct Node* current_node = list->head;
+
+    for(int i = 0; i < list->length; i++) {
+        contents[i] = current_node->contents;
+        sorted[i] = current_node->contents;
+        current_node = current_node->next;
+    }
+
+    merge_sort_contents(contents, sorted, 0, list->length, compare);
+
+    current_node = list->head;
+
+    for(int i = 0; i < list->length; i++) {
+        current_node->contents = sorted[i];
+        current_node = current_node->next;
+    }
+
+    deallocate(list->allocator, contents);
+
+    return 1;
+}
+
+
+
+/**
+ * @brief Allocates a new, empty node for an unrolled list, with room for
+ * block_size contents.
+ * 
+ * @param list - The list which the node will belong to.
+ * 
+ * @returns NULL on failure (not enough heap to allocate node), pointer to
+ * the new node on success.
+ */
+struct UnrolledNode* allocate_unrolled_node(struct UnrolledList* list) {
+
+    struct UnrolledNode* node = allocate(list->allocator, sizeof(struct UnrolledNode) + list->block_size * sizeof(void*));
+
+    if(node == NULL)
+        return NULL;
+
+    node->count = 0;
+    node->next = NULL;
+
+    return node;
+}
+
+
+/**
+ * @brief Finds the node of an unrolled list which stores the contents at a
+ * given index.
+ * 
+ * @remark The index must be within the bounds of the list.
+ * 
+ * @param list - The list to search.
+ * @param index - The index to search for. This is overwritten with the
+ * position of the contents within the node that is returned.
+ * @param previous - If not NULL, this is set to the node before the node
+ * that is returned (NULL if the returned node is the head).
+ * 
+ * @returns Pointer to the node which stores the contents at index.
+ */
+struct UnrolledNode* find_unrolled_node(struct UnrolledList* list, int* index, struct UnrolledNode** previous) {
+
+    struct UnrolledNode* previous_node = NULL;
+    struct UnrolledNode* current_node = list->head;
+
+    // Skip over entire nodes at a time until we reach the node which
+    // stores the index
+    while(*index >= current_node->count) {
+        *index -= current_node->count;
+
+        previous_node = current_node;
+        current_node = current_node->next;
+    }
+
+    if(previous != NULL)
+        *previous = previous_node;
+
+    return current_node;
+}
+
+
+/**
+ * @brief Adds new contents "contents" to the end of an unrolled list. A new
+ * node is only allocated when the tail node is full.
+ * 
+ * @remark Also increments the length of the list by 1 on success.
+ * 
+ * @param list - The list to add the contents to.
+ * @param contents - The contents to add.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int unrolled_add(struct UnrolledList* list, void* contents) {
+
+    assertf(list != NULL, "Tried to insert into a NULL Unrolled List.\n");
+
+    // If there is no room left in the tail, link a new node after it
+    if(list->tail == NULL || list->tail->count == list->block_size) {
+
+        struct UnrolledNode* new_node = allocate_unrolled_node(list);
+
+        if(new_node == NULL)
+            return 0;
+
+        if(list->tail == NULL)
+            list->head = new_node;
+        else
+            list->tail->next = new_node;
+
+        list->tail = new_node;
+    }
+
+    list->tail->contents[list->tail->count] = contents;
+    list->tail->count++;
+
+    list->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Inserts new contents "contents" into an unrolled list at a given
+ * index. If the node storing that index is full, it is split in half first.
+ * 
+ * @remark The user may insert past the end of the list, in which case NULL
+ * contents will be added up to the desired index. Also increments the length
+ * of the list by 1 on success.
+ * 
+ * @param list - The list to insert the contents into.
+ * @param index - The index at which to insert the contents.
+ * @param contents - The contents to insert.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int unrolled_insert(struct UnrolledList* list, int index, void* contents) {
+
+    assertf(list != NULL, "Tried to insert into a NULL Unrolled List.\n");
+
+    assertf(index >= 0, "Tried to insert into Unrolled List at negative index.\n");
+
+    // Inserting at or past the end of the list is just adding (with NULL
+    // contents filling any gap)
+    if(index >= list->length) {
+
+        while(list->length < index) {
+            if(!unrolled_add(list, NULL))
+                return 0;
+        }
+
+        return unrolled_add(list, contents);
+    }
+
+    struct UnrolledNode* node = find_unrolled_node(list, &index, NULL);
+
+    // If the node is full, move the upper half of its contents into a new
+    // node linked right after it
+    if(node->count == list->block_size) {
+
+        struct UnrolledNode* new_node = allocate_unrolled_node(list);
+
+        if(new_node == NULL)
+            return 0;
+
+        int half = node->count / 2;
+
+        memcpy(new_node->contents, node->contents + half, (node->count - half) * sizeof(void*));
+        new_node->count = node->count - half;
+        node->count = half;
+
+        new_node->next = node->next;
+        node->next = new_node;
+
+        if(list->tail == node)
+            list->tail = new_node;
+
+        // Continue with whichever half now stores the index
+        if(index > half) {
+            index -= half;
+            node = new_node;
+        }
+    }
+
+    // Shift the contents after the index up by one to make room
+    memmove(node->contents + index + 1, node->contents + index, (node->count - index) * sizeof(void*));
+
+    node->contents[index] = contents;
+    node->count++;
+
+    list->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, at the given index of an
+ * unrolled list.
+ * 
+ * @remark This function will crash the program upon trying to obtain an
+ * index outside the bounds of the list, which is (-inf,0)U[length,inf) .
+ * 
+ * @param list - The list to obtain the desired contents from.
+ * @param index - The index from which the desired contents will be obtained.
+ * 
+ * @returns void* to desired contents.
+ */
+void* unrolled_get(struct UnrolledList* list, int index) {
+
+    assertf(list != NULL, "Tried to get data from a NULL Unrolled List.\n");
+
+    assertf(index >= 0 && index < list->length, "Tried to get data at invalid index in Unrolled List.\n");
+
+    struct UnrolledNode* node = find_unrolled_node(list, &index, NULL);
+
+    return node->contents[index];
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, at the given index of an
+ * unrolled list. If the index does not exist, returns a default value
+ * instead.
+ * 
+ * @param list - The list to obtain the desired contents from.
+ * @param index - The index from which the desired contents will be obtained.
+ * @param _default - A default value to return if the index does not exist in
+ * the list
+ * 
+ * @returns A void pointer to the contents at the desired index in the list,
+ * default otherwise.
+ */
+void* unrolled_get_or_default(struct UnrolledList* list, int index, void* _default) {
+
+    assertf(list != NULL, "Tried to get data from a NULL Unrolled List.\n");
+
+    if(index < 0 || index >= list->length)
+        return _default;
+
+    struct UnrolledNode* node = find_unrolled_node(list, &index, NULL);
+
+    return node->contents[index];
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from an unrolled list. If the
+ * node storing that index becomes less than half full, the next node is
+ * merged into it when they fit together, and empty nodes are freed.
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int unrolled_delete_contents(struct UnrolledList* list, int index, int auto_free) {
+
+    // Return 0 if index is out of bounds for the list
+    if(index < 0 || index >= list->length)
+        return 0;
+
+    struct UnrolledNode* previous_node = NULL;
+    struct UnrolledNode* node = find_unrolled_node(list, &index, &previous_node);
+
+    // Free the contents being deleted
+    if(node->contents[index] != NULL && auto_free)
+        free(node->contents[index]);
+
+    // Shift the contents after the index down by one to fill the gap
+    memmove(node->contents + index, node->contents + index + 1, (node->count - index - 1) * sizeof(void*));
+    node->count--;
+
+    list->length--;
+
+    // If the node is empty, unlink and free it
+    if(node->count == 0) {
+
+        if(previous_node == NULL)
+            list->head = node->next;
+        else
+            previous_node->next = node->next;
+
+        if(list->tail == node)
+            list->tail = previous_node;
+
+        deallocate(list->allocator, node);
+
+        return 1;
+    }
+
+    // If the node is less than half full, merge the next node into it (if
+    // their contents fit in one node) to keep the nodes densely packed
+    struct UnrolledNode* next_node = node->next;
+
+    if(node->count < list->block_size / 2 && next_node != NULL && node->count + next_node->count <= list->block_size) {
+
+        memcpy(node->contents + node->count, next_node->contents, next_node->count * sizeof(void*));
+        node->count += next_node->count;
+
+        node->next = next_node->next;
+
+        if(list->tail == next_node)
+            list->tail = node;
+
+        deallocate(list->allocator, next_node);
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from an unrolled list, and
+ * frees them unless the list's auto_free is turned off.
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int unrolled_delete(struct UnrolledList* list, int index) {
+
+    return unrolled_delete_contents(list, index, list->auto_free);
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from an unrolled list, without
+ * freeing them (whatever the list's auto_free is).
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int unrolled_delete_keep(struct UnrolledList* list, int index) {
+
+    return unrolled_delete_contents(list, index, 0);
+}
+
+
+/**
+ * @brief Frees an unrolled list, all of its nodes, and all of their contents.
+ * 
+ * @remark This function may result in a double free if the same pointer is
+ * stored more than once in the list.
+ * 
+ * @param list - The list to tear down.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 1 on success.
+ */
+int free_unrolled_list(struct UnrolledList* list, int auto_free) {
+
+    struct UnrolledNode* current_node = list->head;
+    struct Allocator* allocator = list->allocator;
+
+    deallocate(allocator, list);
+
+    while(current_node != NULL) {
+
+        struct UnrolledNode* next_node = current_node->next;
+
+        // Free all of the contents stored in this node
+        if(auto_free) {
+            for(int i = 0; i < current_node->count; i++) {
+                if(current_node->contents[i] != NULL)
+                    free(current_node->contents[i]);
+            }
+        }
+
+        deallocate(allocator, current_node);
+
+        current_node = next_node;
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees an unrolled list and everything it holds, including its
+ * contents unless the list's auto_free is turned off.
+ * 
+ * @param list - The list to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int unrolled_teardown(struct UnrolledList* list) {
+
+    return free_unrolled_list(list, list->auto_free);
+}
+
+
+/**
+ * @brief Frees an unrolled list and everything it holds, except for its
+ * contents (whatever the list's auto_free is).
+ * 
+ * @param list - The list to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int unrolled_teardown_keep(struct UnrolledList* list) {
+
+    return free_unrolled_list(list, 0);
+}
+
+
+/**
+ * @brief Adds a copy of num_bytes bytes of "contents" to the end of an unrolled list.
+ * 
+ * @remark The copy is allocated on its own, and is freed like any other
+ * contents.
+ * 
+ * @param list - The list to add the copy to.
+ * @param contents - The data to copy.
+ * @param num_bytes - The number of bytes of data to copy.
+ * 
+ * @returns 0 on failure (not enough heap to allocate the copy), 1 on success.
+ */
+int unrolled_add_inline(struct UnrolledList* list, void* contents, int num_bytes) {
+
+    assertf(num_bytes > 0, "Tried to add %d bytes inline to a Unrolled List.\n", num_bytes);
+
+    void* copy = malloc(num_bytes);
+
+    if(copy == NULL)
+        return 0;
+
+    memcpy(copy, contents, num_bytes);
+
+    if(!unrolled_add(list, copy)) {
+        free(copy);
+        return 0;
+    }
+
+    return 1;
+}
+
+
+
+/**
+ * @brief Grows (or shrinks) the array of a vector to a given capacity.
+ * 
+ * @param vector - The vector whose array will be resized.
+ * @param capacity - The new capacity of the array, which must be at least the
+ * length of the vector.
+ * 
+ * @returns 0 on failure (not enough heap to resize array), 1 on success.
+ */
+int resize_vector(struct Vector* vector, int capacity) {
+
+    // Resizing to 0 bytes may or may not free the array, so handle that
+    // case separately
+    if(capacity == 0) {
+        deallocate(vector->allocator, vector->contents);
+
+        vector->contents = NULL;
+        vector->capacity = 0;
+
+        return 1;
+    }
+
+    void** contents = reallocate(vector->allocator, vector->contents, vector->capacity * sizeof(void*), capacity * sizeof(void*));
+
+    if(contents == NULL)
+        return 0; //couldn't allocate enough heap for the array.
+
+    vector->contents = contents;
+    vector->capacity = capacity;
+
+    return 1;
+}
+
+
+/**
+ * @brief Makes sure a vector has room for at least a given number of
+ * contents, so that adding up to that many will not reallocate the array.
+ * 
+ * @param vector - The vector to reserve room in.
+ * @param capacity - The number of contents to make room for.
+ * 
+ * @returns 0 on failure (not enough heap to grow array), 1 on success.
+ */
+int vector_reserve(struct Vector* vector, int capacity) {
+
+    assertf(vector != NULL, "Tried to reserve room in a NULL Vector.\n");
+
+    if(capacity <= vector->capacity)
+        return 1;
+
+    return resize_vector(vector, capacity);
+}
+
+
+/**
+ * @brief Shrinks the array of a vector so that its capacity is exactly the
+ * length of the vector, giving any unused memory back to the heap.
+ * 
+ * @param vector - The vector to shrink.
+ * 
+ * @returns 0 on failure (array could not be reallocated), 1 on success.
+ */
+int vector_shrink_to_fit(struct Vector* vector) {
+
+    assertf(vector != NULL, "Tried to shrink a NULL Vector.\n");
+
+    if(vector->length == vector->capacity)
+        return 1;
+
+    return resize_vector(vector, vector->length);
+}
+
+
+/**
+ * @brief Adds new contents "contents" to the end of a vector. When the array
+ * is full, its capacity is doubled, so adding is amortized O(1).
+ * 
+ * @remark Also increments the length of the vector by 1 on success.
+ * 
+ * @param vector - The vector to add the contents to.
+ * @param contents - The contents to add.
+ * 
+ * @returns 0 on failure (not enough heap to grow array), 1 on success.
+ */
+int vector_add(struct Vector* vector, void* contents) {
+
+    assertf(vector != NULL, "Tried to insert into a NULL Vector.\n");
+
+    if(vector->length == vector->capacity) {
+        if(!resize_vector(vector, vector->capacity < 8 ? 8 : vector->capacity * 2))
+            return 0;
+    }
+
+    vector->contents[vector->length] = contents;
+    vector->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Inserts new contents "contents" into a vector at a given index,
+ * shifting the contents after it up by one.
+ * 
+ * @remark The user may insert past the end of the vector, in which case NULL
+ * contents will be added up to the desired index. Also increments the length
+ * of the vector by 1 on success.
+ * 
+ * @param vector - The vector to insert the contents into.
+ * @param index - The index at which to insert the contents.
+ * @param contents - The contents to insert.
+ * 
+ * @returns 0 on failure (not enough heap to grow array), 1 on success.
+ */
+int vector_insert(struct Vector* vector, int index, void* contents) {
+
+    assertf(vector != NULL, "Tried to insert into a NULL Vector.\n");
+
+    assertf(index >= 0, "Tried to insert into Vector at negative index.\n");
+
+    // Inserting at or past the end of the vector is just adding (with NULL
+    // contents filling any gap)
+    if(index >= vector->length) {
+
+        if(!vector_reserve(vector, index + 1))
+            return 0;
+
+        while(vector->length < index) {
+            vector->contents[vector->length] = NULL;
+            vector->length++;
+        }
+
+        return vector_add(vector, contents);
+    }
+
+    if(vector->length == vector->capacity) {
+        if(!resize_vector(vector, vector->capacity * 2))
+            return 0;
+    }
+
+    // Shift the contents after the index up by one to make room
+    memmove(vector->contents + index + 1, vector->contents + index, (vector->length - index) * sizeof(void*));
+
+    vector->contents[index] = contents;
+    vector->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, at the given index of a
+ * vector.
+ * 
+ * @remark This function will crash the program upon trying to obtain an
+ * index outside the bounds of the vector, which is (-inf,0)U[length,inf) .
+ * 
+ * @param vector - The vector to obtain the desired contents from.
+ * @param index - The index from which the desired contents will be obtained.
+ * 
+ * @returns void* to desired contents.
+ */
+void* vector_get(struct Vector* vector, int index) {
+
+    assertf(vector != NULL, "Tried to get data from a NULL Vector.\n");
+
+    assertf(index >= 0 && index < vector->length, "Tried to get data at invalid index in Vector.\n");
+
+    return vector->contents[index];
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, at the given index of a
+ * vector. If the index does not exist, returns a default value instead.
+ * 
+ * @param vector - The vector to obtain the desired contents from.
+ * @param index - The index from which the desired contents will be obtained.
+ * @param _default - A default value to return if the index does not exist in
+ * the vector
+ * 
+ * @returns A void pointer to the contents at the desired index in the vector,
+ * default otherwise.
+ */
+void* vector_get_or_default(struct Vector* vector, int index, void* _default) {
+
+    assertf(vector != NULL, "Tried to get data from a NULL Vector.\n");
+
+    if(index < 0 || index >= vector->length)
+        return _default;
+
+    return vector->contents[index];
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from a vector, shifting the
+ * contents after it down by one.
+ * 
+ * @remark This function will decrement the size of the vector by 1 on
+ * success.
+ * 
+ * @param vector - The vector to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 0 on failure (index does not exist in vector), 1 on success.
+ */
+int vector_delete_contents(struct Vector* vector, int index, int auto_free) {
+
+    // Return 0 if index is out of bounds for the vector
+    if(index < 0 || index >= vector->length)
+        return 0;
+
+    if(vector->contents[index] != NULL && auto_free)
+        free(vector->contents[index]);
+
+    // Shift the contents after the index down by one to fill the gap
+    memmove(vector->contents + index, vector->contents + index + 1, (vector->length - index - 1) * sizeof(void*));
+
+    vector->length--;
+
+    return 1;
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from a vector, and frees them
+ * unless the vector's auto_free is turned off.
+ * 
+ * @remark This function will decrement the size of the vector by 1 on
+ * success.
+ * 
+ * @param vector - The vector to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * 
+ * @returns 0 on failure (index does not exist in vector), 1 on success.
+ */
+int vector_delete(struct Vector* vector, int index) {
+
+    return vector_delete_contents(vector, index, vector->auto_free);
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from a vector, without freeing
+ * them (whatever the vector's auto_free is).
+ * 
+ * @remark This function will decrement the size of the vector by 1 on
+ * success.
+ * 
+ * @param vector - The vector to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * 
+ * @returns 0 on failure (index does not exist in vector), 1 on success.
+ */
+int vector_delete_keep(struct Vector* vector, int index) {
+
+    return vector_delete_contents(vector, index, 0);
+}
+
+
+/**
+ * @brief Frees a vector, its array, and all of its contents.
+ * 
+ * @remark This function may result in a double free if the same pointer is
+ * stored more than once in the vector.
+ * 
+ * @param vector - The vector to tear down.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 1 on success.
+ */
+int free_vector(struct Vector* vector, int auto_free) {
+
+    if(auto_free) {
+        for(int i = 0; i < vector->length; i++) {
+            if(vector->contents[i] != NULL)
+                free(vector->contents[i]);
+        }
+    }
+
+    deallocate(vector->allocator, vector->contents);
+    deallocate(vector->allocator, vector);
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees a vector and everything it holds, including its contents
+ * unless the vector's auto_free is turned off.
+ * 
+ * @param vector - The vector to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int vector_teardown(struct Vector* vector) {
+
+    return free_vector(vector, vector->auto_free);
+}
+
+
+/**
+ * @brief Frees a vector and everything it holds, except for its contents
+ * (whatever the vector's auto_free is).
+ * 
+ * @param vector - The vector to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int vector_teardown_keep(struct Vector* vector) {
+
+    return free_vector(vector, 0);
+}
+
+
+/**
+ * @brief Adds a copy of num_bytes bytes of "contents" to the end of a vector.
+ * 
+ * @remark The copy is allocated on its own, and is freed like any other
+ * contents.
+ * 
+ * @param vector - The vector to add the copy to.
+ * @param contents - The data to copy.
+ * @param num_bytes - The number of bytes of data to copy.
+ * 
+ * @returns 0 on failure (not enough heap to allocate the copy), 1 on success.
+ */
+int vector_add_inline(struct Vector* vector, void* contents, int num_bytes) {
+
+    assertf(num_bytes > 0, "Tried to add %d bytes inline to a Vector.\n", num_bytes);
+
+    void* copy = malloc(num_bytes);
+
+    if(copy == NULL)
+        return 0;
+
+    memcpy(copy, contents, num_bytes);
+
+    if(!vector_add(vector, copy)) {
+        free(copy);
+        return 0;
+    }
+
+    return 1;
+}
+
+
+
+/**
+ * @brief Mixes the bits of a hash, so that every bit of the input affects the
+ * low bits that are used to pick a slot in a hash map's table.
+ * 
+ * @param hash - The hash to mix.
+ * 
+ * @returns The mixed hash.
+ */
+unsigned long long mix_hash(unsigned long long hash) {
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+
+    return hash;
+}
+
+
+/**
+ * @brief Hashes a C string key (using FNV-1a).
+ * 
+ * @param key - Pointer to the null terminated string to hash.
+ * 
+ * @returns The hash of the string.
+ */
+unsigned long long hash_string(void* key) {
+
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+
+    for(unsigned char* c = (unsigned char*) key; *c != '\0'; c++) {
+        hash ^= *c;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return mix_hash(hash);
+}
+
+
+/**
+ * @brief Compares two C string keys.
+ * 
+ * @returns 1 if the strings are equal, 0 otherwise.
+ */
+int equals_string(void* key1, void* key2) {
+    return strcmp((char*) key1, (char*) key2) == 0;
+}
+
+
+/**
+ * @brief Hashes an integer key, which is stored directly in the key pointer
+ * (see int_key()).
+ * 
+ * @param key - The integer key to hash.
+ * 
+ * @returns The hash of the integer.
+ */
+unsigned long long hash_int(void* key) {
+    return mix_hash((unsigned long long) key);
+}
+
+
+/**
+ * @brief Compares two integer keys.
+ * 
+ * @returns 1 if the integers are equal, 0 otherwise.
+ */
+int equals_int(void* key1, void* key2) {
+    return key1 == key2;
+}
+
+
+/**
+ * @brief Compares two keys of a hash map. Integer keys are compared directly,
+ * without calling the map's equals function.
+ * 
+ * @returns 1 if the keys are equal, 0 otherwise.
+ */
+int keys_equal(struct HashMap* map, void* key1, void* key2) {
+
+    if(map->equals == equals_int)
+        return key1 == key2;
+
+    return map->equals(key1, key2);
+}
+
+
+/**
+ * @brief Finds the slot in a hash map's table which stores a key.
+ * 
+ * @remark With Robin Hood probing, entries are ordered by their distance from
+ * their home slot, so the search can stop as soon as it reaches an entry that
+ * is closer to its home slot than the key would be.
+ * 
+ * @param map - The map to search.
+ * @param key - The key to search for.
+ * @param hash - The hash of the key.
+ * 
+ * @returns The index of the slot storing the key, or -1 if it is not in the
+ * map.
+ */
+int find_slot(struct HashMap* map, void* key, unsigned long long hash) {
+
+    if(map->capacity == 0)
+        return -1;
+
+    int mask = map->capacity - 1;
+    int slot = hash & mask;
+
+    for(int probe_length = 1; ; probe_length++) {
+
+        struct HashMapEntry* entry = &map->entries[slot];
+
+        if(entry->probe_length < probe_length)
+            return -1;
+
+        if(entry->hash == hash && keys_equal(map, entry->key, key))
+            return slot;
+
+        slot = (slot + 1) & mask;
+    }
+}
+
+
+/**
+ * @brief Places a key which is not yet in a hash map into its table. Whenever
+ * the entry being placed is further from its home slot than the entry in the
+ * slot it is probing, they swap places (this is Robin Hood probing, which
+ * keeps probe lengths short and even).
+ * 
+ * @remark The table must have at least one empty slot.
+ * 
+ * @param map - The map to place the entry into.
+ * @param entry - The entry to place (its probe length is overwritten).
+ */
+void place_entry(struct HashMap* map, struct HashMapEntry entry) {
+
+    int mask = map->capacity - 1;
+    int slot = entry.hash & mask;
+
+    entry.probe_length = 1;
+
+    while(map->entries[slot].probe_length != 0) {
+
+        // Take the slot from an entry closer to its home, and carry on
+        // placing that entry instead
+        if(map->entries[slot].probe_length < entry.probe_length) {
+            struct HashMapEntry displaced = map->entries[slot];
+            map->entries[slot] = entry;
+            entry = displaced;
+        }
+
+        slot = (slot + 1) & mask;
+        entry.probe_length++;
+    }
+
+    map->entries[slot] = entry;
+}
+
+
+/**
+ * @brief Moves all of the entries in a hash map into a new table with a
+ * given number of slots.
+ * 
+ * @param map - The map whose table will be resized.
+ * @param capacity - The new number of slots (a power of 2 larger than the
+ * number of keys in the map).
+ * 
+ * @returns 0 on failure (not enough heap to allocate table), 1 on success.
+ */
+int resize_hash_map(struct HashMap* map, int capacity) {
+
+    struct HashMapEntry* old_entries = map->entries;
+    int old_capacity = map->capacity;
+
+    map->entries = allocate(map->allocator, capacity * sizeof(struct HashMapEntry));
+
+    if(map->entries == NULL) {
+        map->entries = old_entries;
+        return 0; //couldn't allocate enough heap for the table.
+    }
+
+    memset(map->entries, 0, capacity * sizeof(struct HashMapEntry));
+
+    map->capacity = capacity;
+
+    // The hashes are stored in the entries, so no key is hashed again
+    for(int i = 0; i < old_capacity; i++) {
+        if(old_entries[i].probe_length != 0)
+            place_entry(map, old_entries[i]);
+    }
+
+    deallocate(map->allocator, old_entries);
+
+    return 1;
+}
+
+
+/**
+ * @brief Makes sure a hash map has room for a given number of keys, so that
+ * adding up to that many keys will not resize the table.
+ * 
+ * @remark The table is kept at most 7/8 full.
+ * 
+ * @param map - The map to reserve room in.
+ * @param num_keys - The number of keys to make room for.
+ * 
+ * @returns 0 on failure (not enough heap to grow table), 1 on success.
+ */
+int hash_map_reserve(struct HashMap* map, int num_keys) {
+
+    assertf(map != NULL, "Tried to reserve room in a NULL Hash Map.\n");
+
+    int capacity = map->capacity < 8 ? 8 : map->capacity;
+
+    while(num_keys > capacity / 8 * 7)
+        capacity *= 2;
+
+    if(capacity == map->capacity)
+        return 1;
+
+    return resize_hash_map(map, capacity);
+}
+
+
+/**
+ * @brief Adds a key with a value to a hash map. If the key is already in the
+ * map, its key and value are replaced, and the old ones are freed (if they
+ * are owned by the map, see free_keys and free_values).
+ * 
+ * @param map - The map to add the key to.
+ * @param key - The key to add.
+ * @param value - The value of the key.
+ * 
+ * @returns 0 on failure (not enough heap to grow table), 1 on success.
+ */
+int hash_map_put(struct HashMap* map, void* key, void* value) {
+
+    assertf(map != NULL, "Tried to put a key into a NULL Hash Map.\n");
+
+    unsigned long long hash = map->hash(key);
+
+    int slot = find_slot(map, key, hash);
+
+    // Replace the key and value if the key is already in the map
+    if(slot >= 0) {
+
+        struct HashMapEntry* entry = &map->entries[slot];
+
+        if(entry->key != key && entry->key != NULL && map->free_keys)
+            free(entry->key);
+
+        if(entry->value != value && entry->value != NULL && map->free_values)
+            free(entry->value);
+
+        entry->key = key;
+        entry->value = value;
+
+        return 1;
+    }
+
+    // Grow the table if adding the key would make it too full
+    if(!hash_map_reserve(map, map->length + 1))
+        return 0;
+
+    struct HashMapEntry entry = {key, value, hash, 0};
+    place_entry(map, entry);
+
+    map->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Returns the value, a void pointer, of a key in a hash map.
+ * 
+ * @param map - The map to get the value from.
+ * @param key - The key whose value will be obtained.
+ * 
+ * @returns NULL if the key is not in the map, void* to its value otherwise.
+ */
+void* hash_map_get(struct HashMap* map, void* key) {
+
+    assertf(map != NULL, "Tried to get data from a NULL Hash Map.\n");
+
+    int slot = find_slot(map, key, map->hash(key));
+
+    if(slot < 0)
+        return NULL;
+
+    return map->entries[slot].value;
+}
+
+
+/**
+ * @brief Returns the value, a void pointer, of a key in a hash map. If the key
+ * is not in the map, returns a default value instead.
+ * 
+ * @param map - The map to get the value from.
+ * @param key - The key whose value will be obtained.
+ * @param _default - A default value to return if the key is not in the map.
+ * 
+ * @returns A void pointer to the value of the key, default otherwise.
+ */
+void* hash_map_get_or_default(struct HashMap* map, void* key, void* _default) {
+
+    assertf(map != NULL, "Tried to get data from a NULL Hash Map.\n");
+
+    int slot = find_slot(map, key, map->hash(key));
+
+    if(slot < 0)
+        return _default;
+
+    return map->entries[slot].value;
+}
+
+
+/**
+ * @brief Removes a key and its value from a hash map, freeing the ones owned
+ * by the map if auto_free is set (see hash_map_remove and
+ * hash_map_remove_keep). The entries after it are shifted back, so that no
+ * tombstones are left behind.
+ * 
+ * @param map - The map to remove the key from.
+ * @param key - The key to remove.
+ * @param auto_free - Whether to free the key and value.
+ * 
+ * @returns 0 on failure (key is not in map), 1 on success.
+ */
+int hash_map_remove_entry(struct HashMap* map, void* key, int auto_free) {
+
+    assertf(map != NULL, "Tried to remove a key from a NULL Hash Map.\n");
+
+    int slot = find_slot(map, key, map->hash(key));
+
+    if(slot < 0)
+        return 0;
+
+    struct HashMapEntry* entry = &map->entries[slot];
+
+    if(entry->key != NULL && auto_free && map->free_keys)
+        free(entry->key);
+
+    if(entry->value != NULL && auto_free && map->free_values)
+        free(entry->value);
+
+    // Shift back every following entry that is not in its home slot
+    int mask = map->capacity - 1;
+    int next_slot = (slot + 1) & mask;
+
+    while(map->entries[next_slot].probe_length > 1) {
+        map->entries[slot] = map->entries[next_slot];
+        map->entries[slot].probe_length--;
+
+        slot = next_slot;
+        next_slot = (next_slot + 1) & mask;
+    }
+
+    map->entries[slot].probe_length = 0;
+
+    map->length--;
+
+    return 1;
+}
+
+
+/**
+ * @brief Removes a key and its value from a hash map, freeing the ones owned
+ * by the map (see free_keys and free_values).
+ * 
+ * @param map - The map to remove the key from.
+ * @param key - The key to remove.
+ * 
+ * @returns 0 on failure (key is not in map), 1 on success.
+ */
+int hash_map_remove(struct HashMap* map, void* key) {
+
+    return hash_map_remove_entry(map, key, 1);
+}
+
+
+/**
+ * @brief Removes a key and its value from a hash map, without freeing them.
+ * 
+ * @param map - The map to remove the key from.
+ * @param key - The key to remove.
+ * 
+ * @returns 0 on failure (key is not in map), 1 on success.
+ */
+int hash_map_remove_keep(struct HashMap* map, void* key) {
+
+    return hash_map_remove_entry(map, key, 0);
+}
+
+
+/**
+ * @brief Frees a hash map and its table, along with the keys and values owned
+ * by the map if auto_free is set (see hash_map_teardown and
+ * hash_map_teardown_keep).
+ * 
+ * @param map - The map to tear down.
+ * @param auto_free - Whether to free the keys and values.
+ * 
+ * @returns 1 on success.
+ */
+int free_hash_map(struct HashMap* map, int auto_free) {
+
+    int free_keys = auto_free && map->free_keys;
+    int free_values = auto_free && map->free_values;
+
+    for(int i = 0; i < map->capacity; i++) {
+
+        struct HashMapEntry* entry = &map->entries[i];
+
+        if(entry->probe_length == 0)
+            continue;
+
+        if(entry->key != NULL && free_keys)
+            free(entry->key);
+
+        if(entry->value != NULL && free_values)
+            free(entry->value);
+    }
+
+    deallocate(map->allocator, map->entries);
+    deallocate(map->allocator, map);
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees a hash map, its table, and all of the keys and values owned by
+ * the map (see free_keys and free_values).
+ * 
+ * @param map - The map to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int hash_map_teardown(struct HashMap* map) {
+
+    return free_hash_map(map, 1);
+}
+
+
+/**
+ * @brief Frees a hash map and its table, without freeing its keys and values.
+ * 
+ * @param map - The map to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int hash_map_teardown_keep(struct HashMap* map) {
+
+    return free_hash_map(map, 0);
+}
+
+
+
+/**
+ * @brief Traverses a concurrent list hand-over-hand, and write locks the node
+ * at a given position (or the last node, if the list is not that long).
+ * 
+ * @remark Nodes are read locked while they are traversed, so that readers
+ * are never blocked. A node is only write locked once it is reached, while
+ * its predecessor is still locked so it cannot be deleted in the meantime.
+ * Locks are always taken in list order, so threads cannot deadlock.
+ * 
+ * @param list - The list to traverse.
+ * @param position - The position of the node to lock (-1 is the sentinel
+ * node before the first node in the list).
+ * @param reached - Set to the position of the node which was locked.
+ * 
+ * @returns Pointer to the write locked node. The caller must unlock it.
+ */
+struct ConcurrentNode* lock_concurrent_node(struct ConcurrentList* list, int position, int* reached) {
+
+    struct ConcurrentNode* previous_node = NULL;
+    struct ConcurrentNode* current_node = &list->head;
+
+    for(int i = -1; ; i++) {
+
+        int found = (i == position);
+
+        if(!found) {
+            pthread_rwlock_rdlock(&current_node->lock);
+
+            // If this is the last node, it is the node we have to lock
+            if(current_node->next == NULL) {
+                pthread_rwlock_unlock(&current_node->lock);
+                found = 1;
+            }
+        }
+
+        if(found) {
+            pthread_rwlock_wrlock(&current_node->lock);
+
+            // Another thread may have added a node after this one while it
+            // was unlocked, in which case we keep going
+            if(i == position || current_node->next == NULL) {
+
+                if(previous_node != NULL)
+                    pthread_rwlock_unlock(&previous_node->lock);
+
+                *reached = i;
+                return current_node;
+            }
+        }
+
+        // Move on, keeping current locked until the next node is locked
+        if(previous_node != NULL)
+            pthread_rwlock_unlock(&previous_node->lock);
+
+        previous_node = current_node;
+        current_node = current_node->next;
+    }
+}
+
+
+/**
+ * @brief Traverses a concurrent list hand-over-hand with read locks, and
+ * finds the node at a given index.
+ * 
+ * @param list - The list to traverse.
+ * @param index - The index of the node to find.
+ * @param found - Set to 1 if the node was found, 0 otherwise.
+ * 
+ * @returns The contents of the node at index (NULL if it was not found).
+ */
+void* read_concurrent_node(struct ConcurrentList* list, int index, int* found) {
+
+    struct ConcurrentNode* current_node = &list->head;
+
+    pthread_rwlock_rdlock(&current_node->lock);
+
+    for(int i = -1; i < index; i++) {
+
+        struct ConcurrentNode* next_node = current_node->next;
+
+        if(next_node == NULL) {
+            pthread_rwlock_unlock(&current_node->lock);
+
+            *found = 0;
+            return NULL;
+        }
+
+        pthread_rwlock_rdlock(&next_node->lock);
+        pthread_rwlock_unlock(&current_node->lock);
+
+        current_node = next_node;
+    }
+
+    void* contents = current_node->contents;
+
+    pthread_rwlock_unlock(&current_node->lock);
+
+    *found = 1;
+    return contents;
+}
+
+
+/**
+ * @brief Allocates a new, unlinked node for a concurrent list.
+ * 
+ * @param list - The list which the node will belong to.
+ * @param contents - The contents to include in the node.
+ * 
+ * @returns NULL on failure (not enough heap to allocate node), pointer to
+ * the new node on success.
+ */
+struct ConcurrentNode* allocate_concurrent_node(struct ConcurrentList* list, void* contents) {
+
+    struct ConcurrentNode* node = allocate(list->allocator, sizeof(struct ConcurrentNode));
+
+    if(node == NULL)
+        return NULL;
+
+    node->contents = contents;
+    node->next = NULL;
+    pthread_rwlock_init(&node->lock, NULL);
+
+    return node;
+}
+
+
+/**
+ * @brief Adds a new node with contents "contents" to the end of a concurrent
+ * list. Only the last node is write locked.
+ * 
+ * @remark Also increments the length of the list by 1 on success.
+ * 
+ * @param list - The list to add the new Node to.
+ * @param contents - The contents to include in the node.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int concurrent_add(struct ConcurrentList* list, void* contents) {
+
+    assertf(list != NULL, "Tried to insert into a NULL Concurrent List.\n");
+
+    // Allocate before locking, to keep the time spent holding locks short
+    struct ConcurrentNode* new_node = allocate_concurrent_node(list, contents);
+
+    if(new_node == NULL)
+        return 0;
+
+    int reached;
+    struct ConcurrentNode* last_node = lock_concurrent_node(list, INT_MAX, &reached);
+
+    last_node->next = new_node;
+    list->length++;
+
+    pthread_rwlock_unlock(&last_node->lock);
+
+    return 1;
+}
+
+
+/**
+ * @brief Inserts a new node with contents "contents" into a concurrent list
+ * at a given index. Only the node before the index is write locked.
+ * 
+ * @remark The user may insert past the end of the list, in which case new
+ * nodes with NULL contents will be created up to the desired index. Also
+ * increments the length of the list by 1 on success.
+ * 
+ * @param list - The list to insert the new Node into.
+ * @param index - The index at which to insert the new node.
+ * @param contents - The contents to include in the node.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int concurrent_insert(struct ConcurrentList* list, int index, void* contents) {
+
+    assertf(list != NULL, "Tried to insert into a NULL Concurrent List.\n");
+
+    assertf(index >= 0, "Tried to insert into Concurrent List at negative index.\n");
+
+    int reached;
+    struct ConcurrentNode* prev_node = lock_concurrent_node(list, index - 1, &reached);
+
+    // Fill any gap past the end of the list with NULL contents. These nodes
+    // cannot be reached by other threads until prev_node is unlocked.
+    for(; reached < index - 1; reached++) {
+
+        struct ConcurrentNode* gap_node = allocate_concurrent_node(list, NULL);
+
+        if(gap_node == NULL) {
+            pthread_rwlock_unlock(&prev_node->lock);
+            return 0;
+        }
+
+        gap_node->next = NULL;
+        prev_node->next = gap_node;
+        list->length++;
+
+        // The gap node is not visible yet, so it is safe to lock it while
+        // still holding its predecessor
+        pthread_rwlock_wrlock(&gap_node->lock);
+        pthread_rwlock_unlock(&prev_node->lock);
+
+        prev_node = gap_node;
+    }
+
+    struct ConcurrentNode* new_node = allocate_concurrent_node(list, contents);
+
+    if(new_node == NULL) {
+        pthread_rwlock_unlock(&prev_node->lock);
+        return 0;
+    }
+
+    new_node->next = prev_node->next;
+    prev_node->next = new_node;
+    list->length++;
+
+    pthread_rwlock_unlock(&prev_node->lock);
+
+    return 1;
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, of the node at the given index
+ * in a concurrent list.
+ * 
+ * @remark Since other threads may change the length of the list at any time,
+ * this does not crash on an invalid index, but returns NULL instead.
+ * 
+ * @param list - The list to obtain the desired Node from.
+ * @param index - The index from which the desired Node will be obtained.
+ * 
+ * @returns NULL on failure, void* to contents of desired Node on success.
+ */
+void* concurrent_get(struct ConcurrentList* list, int index) {
+
+    assertf(list != NULL, "Tried to get data from a NULL Concurrent List.\n");
+
+    if(index < 0)
+        return NULL;
+
+    int found;
+    return read_concurrent_node(list, index, &found);
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, of the node at the given index
+ * in a concurrent list. If there is no node at the given index, returns a
+ * default value instead.
+ * 
+ * @param list - The list to obtain the desired Node from.
+ * @param index - The index from which the desired Node will be obtained.
+ * @param _default - A default value to return if the index does not exist in
+ * the list
+ * 
+ * @returns A void pointer to the contents of the node at the desired index in 
+ * the list, default otherwise.
+ */
+void* concurrent_get_or_default(struct ConcurrentList* list, int index, void* _default) {
+
+    assertf(list != NULL, "Tried to get data from a NULL Concurrent List.\n");
+
+    if(index < 0)
+        return _default;
+
+    int found;
+    void* contents = read_concurrent_node(list, index, &found);
+
+    return found ? contents : _default;
+}
+
+
+/**
+ * @brief Deletes the Node from a concurrent list at a given index. Only the
+ * node before it and the node itself are write locked.
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete desired Node from.
+ * @param index - The index of the Node to be deleted.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int concurrent_delete_node(struct ConcurrentList* list, int index, int auto_free) {
+
+    if(index < 0)
+        return 0;
+
+    int reached;
+    struct ConcurrentNode* prev_node = lock_concurrent_node(list, index - 1, &reached);
+
+    struct ConcurrentNode* current_node = prev_node->next;
+
+    // Return 0 if index is out of bounds for the list
+    if(reached != index - 1 || current_node == NULL) {
+        pthread_rwlock_unlock(&prev_node->lock);
+        return 0;
+    }
+
+    // No new thread can reach the node while prev_node is write locked, so
+    // this waits for any readers still on it to move on
+    pthread_rwlock_wrlock(&current_node->lock);
+
+    prev_node->next = current_node->next;
+    list->length--;
+
+    pthread_rwlock_unlock(&current_node->lock);
+    pthread_rwlock_unlock(&prev_node->lock);
+
+    pthread_rwlock_destroy(&current_node->lock);
+
+    if(current_node->contents != NULL && auto_free)
+        free(current_node->contents);
+
+    deallocate(list->allocator, current_node);
+
+    return 1;
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from a concurrent list, and
+ * frees them unless the list's auto_free is turned off.
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int concurrent_delete(struct ConcurrentList* list, int index) {
+
+    return concurrent_delete_node(list, index, list->auto_free);
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from a concurrent list,
+ * without freeing them (whatever the list's auto_free is).
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int concurrent_delete_keep(struct ConcurrentList* list, int index) {
+
+    return concurrent_delete_node(list, index, 0);
+}
+
+
+/**
+ * @brief Frees a concurrent list, all of its nodes, and all of the nodes'
+ * contents.
+ * 
+ * @remark This is NOT thread safe, and must only be called once no other
+ * thread is using the list.
+ * 
+ * @param list - The list to tear down.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 1 on success.
+ */
+int free_concurrent_list(struct ConcurrentList* list, int auto_free) {
+
+    struct ConcurrentNode* current_node = list->head.next;
+    struct Allocator* allocator = list->allocator;
+
+    pthread_rwlock_destroy(&list->head.lock);
+    deallocate(allocator, list);
+
+    while(current_node != NULL) {
+
+        struct ConcurrentNode* next_node = current_node->next;
+
+        if(current_node->contents != NULL && auto_free)
+            free(current_node->contents);
+
+        pthread_rwlock_destroy(&current_node->lock);
+        deallocate(allocator, current_node);
+
+        current_node = next_node;
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees a concurrent list (which must no longer be used by any other
+ * thread) and everything it holds, including its contents unless the list's
+ * auto_free is turned off.
+ * 
+ * @param list - The list to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int concurrent_teardown(struct ConcurrentList* list) {
+
+    return free_concurrent_list(list, list->auto_free);
+}
+
+
+/**
+ * @brief Frees a concurrent list (which must no longer be used by any other
+ * thread) and everything it holds, except for its contents (whatever the
+ * list's auto_free is).
+ * 
+ * @param list - The list to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int concurrent_teardown_keep(struct ConcurrentList* list) {
+
+    return free_concurrent_list(list, 0);
+}
+
+
+/**
+ * @brief Adds a copy of num_bytes bytes of "contents" to the end of a concurrent list.
+ * 
+ * @remark The copy is allocated on its own, and is freed like any other
+ * contents.
+ * 
+ * @param list - The list to add the copy to.
+ * @param contents - The data to copy.
+ * @param num_bytes - The number of bytes of data to copy.
+ * 
+ * @returns 0 on failure (not enough heap to allocate the copy), 1 on success.
+ */
+int concurrent_add_inline(struct ConcurrentList* list, void* contents, int num_bytes) {
+
+    assertf(num_bytes > 0, "Tried to add %d bytes inline to a Concurrent List.\n", num_bytes);
+
+    void* copy = malloc(num_bytes);
+
+    if(copy == NULL)
+        return 0;
+
+    memcpy(copy, contents, num_bytes);
+
+    if(!concurrent_add(list, copy)) {
+        free(copy);
+        return 0;
+    }
+
+    return 1;
+}
+
+
+
+// Stores pointer to the first hazard record of every thread which has ever
+// used a lock free queue
+_Atomic(struct HazardRecord*) hazard_records = NULL;
+
+// Stores the hazard record owned by the current thread
+_Thread_local struct HazardRecord* thread_hazard_record = NULL;
+
+// Used to give up a thread's hazard record when the thread exits
+pthread_key_t hazard_record_key;
+pthread_once_t hazard_record_key_once = PTHREAD_ONCE_INIT;
+
+// Retired nodes are freed in batches, once a thread has this many
+#define HAZARD_SCAN_THRESHOLD 64
+
+
+/**
+ * @brief Frees every node retired by the current thread which is not pointed
+ * to by any thread's hazard pointers.
+ * 
+ * @param record - The hazard record of the current thread.
+ */
+void scan_hazards(struct HazardRecord* record) {
+
+    int num_kept = 0;
+
+    for(int i = 0; i < record->num_retired; i++) {
+
+        void* node = record->retired[i];
+        int hazardous = 0;
+
+        for(struct HazardRecord* other = atomic_load(&hazard_records); other != NULL && !hazardous; other = other->next) {
+            if(atomic_load(&other->hazards[0]) == node || atomic_load(&other->hazards[1]) == node)
+                hazardous = 1;
+        }
+
+        // Keep nodes that are still being read, free the rest
+        if(hazardous)
+            record->retired[num_kept++] = node;
+        else
+            free(node);
+    }
+
+    record->num_retired = num_kept;
+}
+
+
+/**
+ * @brief Gives up the hazard record of a thread which is exiting, so that
+ * another thread can reuse it. Any nodes it retired which are still being
+ * read stay in the record, and are freed by its next owner.
+ * 
+ * @param record_pointer - The hazard record of the exiting thread.
+ */
+void release_hazard_record(void* record_pointer) {
+
+    struct HazardRecord* record = record_pointer;
+
+    atomic_store(&record->hazards[0], NULL);
+    atomic_store(&record->hazards[1], NULL);
+
+    scan_hazards(record);
+
+    atomic_store(&record->active, 0);
+}
+
+
+void create_hazard_record_key() {
+    pthread_key_create(&hazard_record_key, release_hazard_record);
+}
+
+
+/**
+ * @brief Returns the hazard record owned by the current thread. The first
+ * time a thread calls this, it takes over the record of a thread that has
+ * exited, or publishes a new record if there is none.
+ * 
+ * @returns Pointer to the current thread's hazard record, or NULL on failure.
+ */
+struct HazardRecord* acquire_hazard_record() {
+
+    if(thread_hazard_record != NULL)
+        return thread_hazard_record;
+
+    pthread_once(&hazard_record_key_once, create_hazard_record_key);
+
+    struct HazardRecord* record;
+
+    // Try to reuse a record given up by a thread which has exited
+    for(record = atomic_load(&hazard_records); record != NULL; record = record->next) {
+        int inactive = 0;
+
+        if(atomic_compare_exchange_strong(&record->active, &inactive, 1))
+            break;
+    }
+
+    // If there is none, publish a new record at the front of the list
+    if(record == NULL) {
+        record = malloc(sizeof(struct HazardRecord));
+
+        if(record == NULL)
+            return NULL;
+
+        atomic_init(&record->hazards[0], NULL);
+        atomic_init(&record->hazards[1], NULL);
+        atomic_init(&record->active, 1);
+        record->retired = NULL;
+        record->num_retired = 0;
+        record->retired_capacity = 0;
+
+        record->next = atomic_load(&hazard_records);
+        while(!atomic_compare_exchange_weak(&hazard_records, &record->next, record));
+    }
+
+    pthread_setspecific(hazard_record_key, record);
+    thread_hazard_record = record;
+
+    return record;
+}
+
+
+/**
+ * @brief Retires a node which has been removed from a lock free queue, so
+ * that it is freed once no thread is reading it.
+ * 
+ * @param record - The hazard record of the current thread.
+ * @param node - The node to retire.
+ */
+void retire_queue_node(struct HazardRecord* record, struct QueueNode* node) {
+
+    if(record->num_retired == record->retired_capacity) {
+
+        int capacity = record->retired_capacity < HAZARD_SCAN_THRESHOLD ? HAZARD_SCAN_THRESHOLD : record->retired_capacity * 2;
+        void** retired = realloc(record->retired, capacity * sizeof(void*));
+
+        // If we cannot keep track of the node, leaking it is the only safe
+        // thing to do
+        if(retired == NULL)
+            return;
+
+        record->retired = retired;
+        record->retired_capacity = capacity;
+    }
+
+    record->retired[record->num_retired] = node;
+    record->num_retired++;
+
+    if(record->num_retired >= HAZARD_SCAN_THRESHOLD)
+        scan_hazards(record);
+}
+
+
+/**
+ * @brief Adds a new node with contents "contents" to the end of a lock free
+ * queue.
+ * 
+ * @remark Also increments the length of the queue by 1 on success.
+ * 
+ * @param queue - The queue to add the new node to.
+ * @param contents - The contents to include in the node.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int lock_free_enqueue(struct LockFreeQueue* queue, void* contents) {
+
+    assertf(queue != NULL, "Tried to enqueue into a NULL Lock Free Queue.\n");
+
+    struct HazardRecord* record = acquire_hazard_record();
+
+    struct QueueNode* new_node = malloc(sizeof(struct QueueNode));
+
+    if(record == NULL || new_node == NULL) {
+        free(new_node);
+        return 0;
+    }
+
+    new_node->contents = contents;
+    atomic_init(&new_node->next, NULL);
+
+    while(1) {
+        struct QueueNode* tail = atomic_load(&queue->tail);
+
+        // Protect the tail, then make sure it was not removed before it
+        // was protected
+        atomic_store(&record->hazards[0], tail);
+        if(tail != atomic_load(&queue->tail))
+            continue;
+
+        struct QueueNode* next = atomic_load(&tail->next);
+
+        if(tail != atomic_load(&queue->tail))
+            continue;
+
+        // If the tail is lagging behind, help move it forward
+        if(next != NULL) {
+            atomic_compare_exchange_strong(&queue->tail, &tail, next);
+            continue;
+        }
+
+        // Link the new node after the last node, then try to move the tail
+        // to it (another thread will do it for us if this fails)
+        if(atomic_compare_exchange_strong(&tail->next, &next, new_node)) {
+            atomic_compare_exchange_strong(&queue->tail, &tail, new_node);
+            break;
+        }
+    }
+
+    atomic_store(&record->hazards[0], NULL);
+
+    queue->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Removes the first node from a lock free queue, and returns its
+ * contents. The contents now belong to the caller.
+ * 
+ * @remark Also decrements the length of the queue by 1 on success. Since NULL
+ * is returned for an empty queue, NULL contents cannot be told apart from an
+ * empty queue.
+ * 
+ * @param queue - The queue to remove the node from.
+ * 
+ * @returns NULL if the queue is empty, void* to contents of the removed node
+ * otherwise.
+ */
+void* lock_free_dequeue(struct LockFreeQueue* queue) {
+
+    assertf(queue != NULL, "Tried to dequeue from a NULL Lock Free Queue.\n");
+
+    struct HazardRecord* record = acquire_hazard_record();
+
+    if(record == NULL)
+        return NULL;
+
+    while(1) {
+        struct QueueNode* head = atomic_load(&queue->head);
+
+        atomic_store(&record->hazards[0], head);
+        if(head != atomic_load(&queue->head))
+            continue;
+
+        struct QueueNode* tail = atomic_load(&queue->tail);
+        struct QueueNode* next = atomic_load(&head->next);
+
+        atomic_store(&record->hazards[1], next);
+        if(head != atomic_load(&queue->head))
+            continue;
+
+        // The dummy node is the only node, so the queue is empty
+        if(next == NULL) {
+            atomic_store(&record->hazards[0], NULL);
+            atomic_store(&record->hazards[1], NULL);
+            return NULL;
+        }
+
+        // If the tail is lagging behind, help move it forward
+        if(head == tail) {
+            atomic_compare_exchange_strong(&queue->tail, &tail, next);
+            continue;
+        }
+
+        // Read the contents before the next node becomes the dummy node,
+        // since another thread may remove that one as soon as we are done
+        void* contents = next->contents;
+
+        if(atomic_compare_exchange_strong(&queue->head, &head, next)) {
+            atomic_store(&record->hazards[0], NULL);
+            atomic_store(&record->hazards[1], NULL);
+
+            // The old dummy node is now unreachable
+            retire_queue_node(record, head);
+
+            queue->length--;
+
+            return contents;
+        }
+    }
+}
+
+
+/**
+ * @brief Frees a lock free queue, all of its nodes, and all of the nodes'
+ * contents.
+ * 
+ * @remark This is NOT thread safe, and must only be called once no other
+ * thread is using the queue.
+ * 
+ * @param queue - The queue to tear down.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 1 on success.
+ */
+int free_lock_free_queue(struct LockFreeQueue* queue, int auto_free) {
+
+    // The dummy node's contents have already been dequeued
+    struct QueueNode* current_node = atomic_load(&queue->head);
+    int is_dummy = 1;
+
+    free(queue);
+
+    while(current_node != NULL) {
+
+        struct QueueNode* next_node = atomic_load(&current_node->next);
+
+        if(!is_dummy && current_node->contents != NULL && auto_free)
+            free(current_node->contents);
+
+        free(current_node);
+
+        current_node = next_node;
+        is_dummy = 0;
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees a lock free queue (which must no longer be used by any other
+ * thread) and everything it holds, including its contents unless the queue's
+ * auto_free is turned off.
+ * 
+ * @param queue - The queue to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int lock_free_teardown(struct LockFreeQueue* queue) {
+
+    return free_lock_free_queue(queue, queue->auto_free);
+}
+
+
+/**
+ * @brief Frees a lock free queue (which must no longer be used by any other
+ * thread) and everything it holds, except for its contents (whatever the
+ * queue's auto_free is).
+ * 
+ * @param queue - The queue to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int lock_free_teardown_keep(struct LockFreeQueue* queue) {
+
+    return free_lock_free_queue(queue, 0);
+}
+
+
+
+/**
+ * @brief Finds the node at a given index in a doubly linked list, starting
+ * from whichever end of the list is closer to the index.
+ * 
+ * @remark The index must be within the bounds of the list.
+ * 
+ * @param list - The list to search.
+ * @param index - The index of the node to find.
+ * 
+ * @returns Pointer to the node at index.
+ */
+struct DoublyNode* find_doubly_node(struct DoublyLinkedList* list, int index) {
+
+    struct DoublyNode* current_node;
+
+    if(index < list->length / 2) {
+        current_node = list->head;
+
+        for(int i = 0; i < index; i++) {
+            current_node = current_node->next;
+        }
+    }
+    else {
+        current_node = list->tail;
+
+        for(int i = list->length - 1; i > index; i--) {
+            current_node = current_node->prev;
+        }
+    }
+
+    return current_node;
+}
+
+
+/**
+ * @brief Links a new node with contents "contents" into a doubly linked list
+ * right before a given node.
+ * 
+ * @remark Also increments the length of the list by 1 on success.
+ * 
+ * @param list - The list to link the new node into.
+ * @param next_node - The node that the new node will come before (NULL to
+ * link it at the end of the list).
+ * @param contents - The contents to include in the node.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int link_doubly_node(struct DoublyLinkedList* list, struct DoublyNode* next_node, void* contents) {
+
+    struct DoublyNode* new_node = allocate(list->allocator, sizeof(struct DoublyNode));
+
+    if(new_node == NULL)
+        return 0;
+
+    new_node->contents = contents;
+    new_node->next = next_node;
+    new_node->prev = next_node == NULL ? list->tail : next_node->prev;
+
+    if(new_node->prev == NULL)
+        list->head = new_node;
+    else
+        new_node->prev->next = new_node;
+
+    if(next_node == NULL)
+        list->tail = new_node;
+    else
+        next_node->prev = new_node;
+
+    list->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Unlinks a node from a doubly linked list and frees it, returning
+ * its contents.
+ * 
+ * @remark Also decrements the length of the list by 1.
+ * 
+ * @param list - The list to unlink the node from.
+ * @param node - The node to unlink.
+ * 
+ * @returns The contents of the unlinked node (which are not freed).
+ */
+void* unlink_doubly_node(struct DoublyLinkedList* list, struct DoublyNode* node) {
+
+    if(node->prev == NULL)
+        list->head = node->next;
+    else
+        node->prev->next = node->next;
+
+    if(node->next == NULL)
+        list->tail = node->prev;
+    else
+        node->next->prev = node->prev;
+
+    void* contents = node->contents;
+
+    deallocate(list->allocator, node);
+
+    list->length--;
+
+    return contents;
+}
+
+
+/**
+ * @brief Adds a new node with contents "contents" to the end of a doubly
+ * linked list in O(1).
+ * 
+ * @remark Also increments the length of the list by 1 on success.
+ * 
+ * @param list - The list to add the new Node to.
+ * @param contents - The contents to include in the node.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int doubly_add(struct DoublyLinkedList* list, void* contents) {
+
+    assertf(list != NULL, "Tried to insert into a NULL Doubly Linked List.\n");
+
+    return link_doubly_node(list, NULL, contents);
+}
+
+
+/**
+ * @brief Adds a new node with contents "contents" to the front of a doubly
+ * linked list in O(1).
+ * 
+ * @remark Also increments the length of the list by 1 on success.
+ * 
+ * @param list - The list to add the new Node to.
+ * @param contents - The contents to include in the node.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int doubly_push_front(struct DoublyLinkedList* list, void* contents) {
+
+    assertf(list != NULL, "Tried to insert into a NULL Doubly Linked List.\n");
+
+    return link_doubly_node(list, list->head, contents);
+}
+
+
+/**
+ * @brief Inserts a new node with contents "contents" into a doubly linked
+ * list at a given index, starting from whichever end is closer.
+ * 
+ * @remark The user may insert past the end of the list, in which case new
+ * nodes with NULL contents will be created up to the desired index. Also
+ * increments the length of the list by 1 on success.
+ * 
+ * @param list - The list to insert the new Node into.
+ * @param index - The index at which to insert the new node.
+ * @param contents - The contents to include in the node.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int doubly_insert(struct DoublyLinkedList* list, int index, void* contents) {
+
+    assertf(list != NULL, "Tried to insert into a NULL Doubly Linked List.\n");
+
+    assertf(index >= 0, "Tried to insert into Doubly Linked List at negative index.\n");
+
+    // Inserting at or past the end of the list is just adding (with NULL
+    // contents filling any gap)
+    if(index >= list->length) {
+
+        while(list->length < index) {
+            if(!link_doubly_node(list, NULL, NULL))
+                return 0;
+        }
+
+        return link_doubly_node(list, NULL, contents);
+    }
+
+    return link_doubly_node(list, find_doubly_node(list, index), contents);
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, of the node at the given index
+ * in a doubly linked list, starting from whichever end is closer.
+ * 
+ * @remark This function will crash the program upon trying to obtain an
+ * index outside the bounds of the list, which is (-inf,0)U[length,inf) .
+ * 
+ * @param list - The list to obtain the desired Node from.
+ * @param index - The index from which the desired Node will be obtained.
+ * 
+ * @returns void* to contents of desired Node.
+ */
+void* doubly_get(struct DoublyLinkedList* list, int index) {
+
+    assertf(list != NULL, "Tried to get data from a NULL Doubly Linked List.\n");
+
+    assertf(index >= 0 && index < list->length, "Tried to get data from Node at invalid index in Doubly Linked List.\n");
+
+    return find_doubly_node(list, index)->contents;
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, of the node at the given index
+ * in a doubly linked list. If there is no node at the given index, returns a
+ * default value instead.
+ * 
+ * @param list - The list to obtain the desired Node from.
+ * @param index - The index from which the desired Node will be obtained.
+ * @param _default - A default value to return if the index does not exist in
+ * the list
+ * 
+ * @returns A void pointer to the contents of the node at the desired index in 
+ * the list, default otherwise.
+ */
+void* doubly_get_or_default(struct DoublyLinkedList* list, int index, void* _default) {
+
+    assertf(list != NULL, "Tried to get data from a NULL Doubly Linked List.\n");
+
+    if(index < 0 || index >= list->length)
+        return _default;
+
+    return find_doubly_node(list, index)->contents;
+}
+
+
+/**
+ * @brief Deletes the Node from a doubly linked list at a given index,
+ * starting from whichever end is closer.
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete desired Node from.
+ * @param index - The index of the Node to be deleted.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int doubly_delete_node(struct DoublyLinkedList* list, int index, int auto_free) {
+
+    // Return 0 if index is out of bounds for the list
+    if(index < 0 || index >= list->length)
+        return 0;
+
+    void* contents = unlink_doubly_node(list, find_doubly_node(list, index));
+
+    if(contents != NULL && auto_free)
+        free(contents);
+
+    return 1;
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from a doubly linked list, and
+ * frees them unless the list's auto_free is turned off.
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int doubly_delete(struct DoublyLinkedList* list, int index) {
+
+    return doubly_delete_node(list, index, list->auto_free);
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from a doubly linked list,
+ * without freeing them (whatever the list's auto_free is).
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int doubly_delete_keep(struct DoublyLinkedList* list, int index) {
+
+    return doubly_delete_node(list, index, 0);
+}
+
+
+/**
+ * @brief Removes the first node from a doubly linked list in O(1), and
+ * returns its contents. The contents now belong to the caller.
+ * 
+ * @param list - The list to remove the node from.
+ * 
+ * @returns NULL if the list is empty, void* to contents of the removed node
+ * otherwise.
+ */
+void* doubly_pop_front(struct DoublyLinkedList* list) {
+
+    assertf(list != NULL, "Tried to pop from a NULL Doubly Linked List.\n");
+
+    if(list->head == NULL)
+        return NULL;
+
+    return unlink_doubly_node(list, list->head);
+}
+
+
+/**
+ * @brief Removes the last node from a doubly linked list in O(1), and returns
+ * its contents. The contents now belong to the caller.
+ * 
+ * @param list - The list to remove the node from.
+ * 
+ * @returns NULL if the list is empty, void* to contents of the removed node
+ * otherwise.
+ */
+void* doubly_pop_back(struct DoublyLinkedList* list) {
+
+    assertf(list != NULL, "Tried to pop from a NULL Doubly Linked List.\n");
+
+    if(list->tail == NULL)
+        return NULL;
+
+    return unlink_doubly_node(list, list->tail);
+}
+
+
+/**
+ * @brief Frees a doubly linked list, all of its nodes, and all of the nodes'
+ * contents.
+ * 
+ * @remark This function may result in a double free if there are two
+ * identical pointers in different contents in different nodes in the list.
+ * 
+ * @param list - The list to tear down.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 1 on success.
+ */
+int free_doubly_list(struct DoublyLinkedList* list, int auto_free) {
+
+    struct DoublyNode* current_node = list->head;
+    struct Allocator* allocator = list->allocator;
+
+    deallocate(allocator, list);
+
+    while(current_node != NULL) {
+
+        struct DoublyNode* next_node = current_node->next;
+
+        if(current_node->contents != NULL && auto_free)
+            free(current_node->contents);
+
+        deallocate(allocator, current_node);
+
+        current_node = next_node;
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees a doubly linked list and everything it holds, including its
+ * contents unless the list's auto_free is turned off.
+ * 
+ * @param list - The list to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int doubly_teardown(struct DoublyLinkedList* list) {
+
+    return free_doubly_list(list, list->auto_free);
+}
+
+
+/**
+ * @brief Frees a doubly linked list and everything it holds, except for its
+ * contents (whatever the list's auto_free is).
+ * 
+ * @param list - The list to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int doubly_teardown_keep(struct DoublyLinkedList* list) {
+
+    return free_doubly_list(list, 0);
+}
+
+
+/**
+ * @brief Adds a copy of num_bytes bytes of "contents" to the end of a doubly linked list.
+ * 
+ * @remark The copy is allocated on its own, and is freed like any other
+ * contents.
+ * 
+ * @param list - The list to add the copy to.
+ * @param contents - The data to copy.
+ * @param num_bytes - The number of bytes of data to copy.
+ * 
+ * @returns 0 on failure (not enough heap to allocate the copy), 1 on success.
+ */
+int doubly_add_inline(struct DoublyLinkedList* list, void* contents, int num_bytes) {
+
+    assertf(num_bytes > 0, "Tried to add %d bytes inline to a Doubly Linked List.\n", num_bytes);
+
+    void* copy = malloc(num_bytes);
+
+    if(copy == NULL)
+        return 0;
+
+    memcpy(copy, contents, num_bytes);
+
+    if(!doubly_add(list, copy)) {
+        free(copy);
+        return 0;
+    }
+
+    return 1;
+}
+
+
+
+/**
+ * @brief Picks the height of a new skip list node. Each node has one more
+ * level than the last with probability 1/4, so there are about 4 times fewer
+ * nodes with each level than with the level below it.
+ * 
+ * @param list - The list the node will be inserted into.
+ * 
+ * @returns The height of the new node, between 1 and SKIP_LIST_MAX_LEVEL.
+ */
+int random_skip_level(struct SkipList* list) {
+
+    // xorshift64* (fast, and good enough for picking heights)
+    list->random_state ^= list->random_state >> 12;
+    list->random_state ^= list->random_state << 25;
+    list->random_state ^= list->random_state >> 27;
+
+    unsigned long long random = list->random_state * 0x2545f4914f6cdd1dULL;
+
+    // Every pair of trailing zero bits in the random number is another
+    // level (which happens with probability 1/4)
+    int height = 1 + __builtin_ctzll(random | (1ULL << 63)) / 2;
+
+    return height < SKIP_LIST_MAX_LEVEL ? height : SKIP_LIST_MAX_LEVEL;
+}
+
+
+/**
+ * @brief Allocates a new skip list node with a given number of levels, from
+ * the list's pool for nodes of that height.
+ * 
+ * @param list - The list which the node will belong to.
+ * @param height - The number of levels in the node.
+ * 
+ * @returns NULL on failure (not enough heap to allocate node), pointer to
+ * the new (uninitialized) node on success.
+ */
+struct SkipNode* allocate_skip_node(struct SkipList* list, int height) {
+
+    struct NodePool* pool = list->pools[height - 1];
+
+    // Pools are only created once a node of their height is needed, since
+    // tall nodes are rare (and most heights are never used at all).
+    if(pool == NULL) {
+        int capacity_hint = height == 1 ? 64 : 16;
+
+        pool = createNodePoolWithAllocator(sizeof(struct SkipNode) + height * sizeof(struct SkipLevel), capacity_hint, list->allocator);
+
+        if(pool == NULL)
+            return NULL;
+
+        list->pools[height - 1] = pool;
+    }
+
+    struct SkipNode* node = (struct SkipNode*) pool->allocate(pool);
+
+    if(node != NULL)
+        node->height = height;
+
+    return node;
+}
+
+
+/**
+ * @brief Finds the node at a given index in a skip list, by following the
+ * highest links which do not pass the index.
+ * 
+ * @remark The index must be within the bounds of the list.
+ * 
+ * @param list - The list to search.
+ * @param index - The index of the node to find.
+ * 
+ * @returns Pointer to the node at index.
+ */
+struct SkipNode* find_skip_node(struct SkipList* list, int index) {
+
+    // The head is at position 0, so the node at index is at position
+    // index + 1.
+    int position = index + 1;
+    int traversed = 0;
+
+    struct SkipNode* current_node = list->head;
+
+    for(int i = list->level - 1; i >= 0; i--) {
+        while(current_node->levels[i].next != NULL && traversed + current_node->levels[i].span <= position) {
+            traversed += current_node->levels[i].span;
+            current_node = current_node->levels[i].next;
+        }
+
+        if(traversed == position)
+            break;
+    }
+
+    return current_node;
+}
+
+
+/**
+ * @brief Inserts a new node with contents "contents" into a skip list, after
+ * every node with contents that compare less than or equal to it, so that the
+ * list stays sorted. This is O(log n) on average.
+ * 
+ * @remark Also increments the length of the list by 1 on success.
+ * 
+ * @param list - The list to insert the new Node into.
+ * @param contents - The contents to include in the node.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new node), 1 on success.
+ */
+int skip_insert_sorted(struct SkipList* list, void* contents) {
+
+    assertf(list != NULL, "Tried to insert into a NULL Skip List.\n");
+
+    // The last node before the new one on each level, and its position
+    struct SkipNode* update[SKIP_LIST_MAX_LEVEL];
+    int position[SKIP_LIST_MAX_LEVEL];
+
+    struct SkipNode* current_node = list->head;
+
+    for(int i = list->level - 1; i >= 0; i--) {
+        position[i] = i == list->level - 1 ? 0 : position[i + 1];
+
+        while(current_node->levels[i].next != NULL && list->compare(current_node->levels[i].next->contents, contents) <= 0) {
+            position[i] += current_node->levels[i].span;
+            current_node = current_node->levels[i].next;
+        }
+
+        update[i] = current_node;
+    }
+
+    int height = random_skip_level(list);
+
+    struct SkipNode* new_node = allocate_skip_node(list, height);
+
+    if(new_node == NULL)
+        return 0;
+
+    // Levels which are not in use yet start at the head, and span the
+    // whole list
+    for(int i = list->level; i < height; i++) {
+        position[i] = 0;
+        update[i] = list->head;
+        list->head->levels[i].next = NULL;
+        list->head->levels[i].span = list->length;
+    }
+
+    if(height > list->level)
+        list->level = height;
+
+    new_node->contents = contents;
+
+    // Link the new node in on each of its levels, splitting the span of the
+    // link it was inserted into
+    for(int i = 0; i < height; i++) {
+        int distance = position[0] - position[i];
+
+        new_node->levels[i].next = update[i]->levels[i].next;
+        new_node->levels[i].span = update[i]->levels[i].span - distance;
+
+        update[i]->levels[i].next = new_node;
+        update[i]->levels[i].span = distance + 1;
+    }
+
+    // Links above the new node now skip over one more position
+    for(int i = height; i < list->level; i++) {
+        update[i]->levels[i].span++;
+    }
+
+    list->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Finds the index of the first node in a skip list with contents that
+ * compare equal to "contents". This is O(log n) on average.
+ * 
+ * @param list - The list to search.
+ * @param contents - The contents to compare against.
+ * 
+ * @returns The index of the first matching node, or -1 if there is none.
+ */
+int skip_find(struct SkipList* list, void* contents) {
+
+    assertf(list != NULL, "Tried to find data in a NULL Skip List.\n");
+
+    int traversed = 0;
+
+    struct SkipNode* current_node = list->head;
+
+    // Stop on each level just before the first node which is not less
+    // than contents
+    for(int i = list->level - 1; i >= 0; i--) {
+        while(current_node->levels[i].next != NULL && list->compare(current_node->levels[i].next->contents, contents) < 0) {
+            traversed += current_node->levels[i].span;
+            current_node = current_node->levels[i].next;
+        }
+    }
+
+    struct SkipNode* next_node = current_node->levels[0].next;
+
+    if(next_node == NULL || list->compare(next_node->contents, contents) != 0)
+        return -1;
+
+    // current_node is at position traversed, so next_node is at index
+    // traversed
+    return traversed;
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, of the node at the given index
+ * in a skip list. This is O(log n) on average.
+ * 
+ * @remark This function will crash the program upon trying to obtain an
+ * index outside the bounds of the list, which is (-inf,0)U[length,inf) .
+ * 
+ * @param list - The list to obtain the desired Node from.
+ * @param index - The index from which the desired Node will be obtained.
+ * 
+ * @returns void* to contents of desired Node.
+ */
+void* skip_get(struct SkipList* list, int index) {
+
+    assertf(list != NULL, "Tried to get data from a NULL Skip List.\n");
+
+    assertf(index >= 0 && index < list->length, "Tried to get data from Node at invalid index in Skip List.\n");
+
+    return find_skip_node(list, index)->contents;
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, of the node at the given index
+ * in a skip list. If there is no node at the given index, returns a default
+ * value instead.
+ * 
+ * @param list - The list to obtain the desired Node from.
+ * @param index - The index from which the desired Node will be obtained.
+ * @param _default - A default value to return if the index does not exist in
+ * the list
+ * 
+ * @returns A void pointer to the contents of the node at the desired index in 
+ * the list, default otherwise.
+ */
+void* skip_get_or_default(struct SkipList* list, int index, void* _default) {
+
+    assertf(list != NULL, "Tried to get data from a NULL Skip List.\n");
+
+    if(index < 0 || index >= list->length)
+        return _default;
+
+    return find_skip_node(list, index)->contents;
+}
+
+
+/**
+ * @brief Deletes the Node from a skip list at a given index. This is
+ * O(log n) on average.
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete desired Node from.
+ * @param index - The index of the Node to be deleted.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int skip_delete_node(struct SkipList* list, int index, int auto_free) {
+
+    // Return 0 if index is out of bounds for the list
+    if(index < 0 || index >= list->length)
+        return 0;
+
+    // Find the last node before the deleted one on each level
+    struct SkipNode* update[SKIP_LIST_MAX_LEVEL];
+
+    int position = index + 1;
+    int traversed = 0;
+
+    struct SkipNode* current_node = list->head;
+
+    for(int i = list->level - 1; i >= 0; i--) {
+        while(current_node->levels[i].next != NULL && traversed + current_node->levels[i].span < position) {
+            traversed += current_node->levels[i].span;
+            current_node = current_node->levels[i].next;
+        }
+
+        update[i] = current_node;
+    }
+
+    struct SkipNode* deleted_node = current_node->levels[0].next;
+
+    // Link around the deleted node on its levels, and shorten the links
+    // which skip over it on the levels above
+    for(int i = 0; i < list->level; i++) {
+        if(update[i]->levels[i].next == deleted_node) {
+            update[i]->levels[i].span += deleted_node->levels[i].span - 1;
+            update[i]->levels[i].next = deleted_node->levels[i].next;
+        }
+        else {
+            update[i]->levels[i].span--;
+        }
+    }
+
+    while(list->level > 1 && list->head->levels[list->level - 1].next == NULL) {
+        list->level--;
+    }
+
+    if(deleted_node->contents != NULL && auto_free)
+        free(deleted_node->contents);
+
+    struct NodePool* pool = list->pools[deleted_node->height - 1];
+    pool->release(pool, deleted_node);
+
+    list->length--;
+
+    return 1;
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from a skip list, and frees
+ * them unless the list's auto_free is turned off.
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int skip_delete(struct SkipList* list, int index) {
+
+    return skip_delete_node(list, index, list->auto_free);
+}
+
+
+/**
+ * @brief Deletes the contents at a given index from a skip list, without
+ * freeing them (whatever the list's auto_free is).
+ * 
+ * @remark This function will decrement the size of the list by 1 on success.
+ * 
+ * @param list - The list to delete the contents from.
+ * @param index - The index of the contents to be deleted.
+ * 
+ * @returns 0 on failure (index does not exist in list), 1 on success.
+ */
+int skip_delete_keep(struct SkipList* list, int index) {
+
+    return skip_delete_node(list, index, 0);
+}
+
+
+/**
+ * @brief Frees a skip list, all of its nodes, and all of the nodes' contents.
+ * 
+ * @remark The nodes themselves are freed all at once, along with the pools
+ * they were allocated from, so the list is only traversed if the contents
+ * have to be freed.
+ * 
+ * @param list - The list to tear down.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 1 on success.
+ */
+int free_skip_list(struct SkipList* list, int auto_free) {
+
+    if(auto_free) {
+        struct SkipNode* current_node = list->head->levels[0].next;
+
+        while(current_node != NULL) {
+            if(current_node->contents != NULL)
+                free(current_node->contents);
+
+            current_node = current_node->levels[0].next;
+        }
+    }
+
+    for(int i = 0; i < SKIP_LIST_MAX_LEVEL; i++) {
+        if(list->pools[i] != NULL)
+            list->pools[i]->teardown(list->pools[i]);
+    }
+
+    deallocate(list->allocator, list->head);
+    deallocate(list->allocator, list);
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees a skip list and everything it holds, including its contents
+ * unless the list's auto_free is turned off.
+ * 
+ * @param list - The list to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int skip_teardown(struct SkipList* list) {
+
+    return free_skip_list(list, list->auto_free);
+}
+
+
+/**
+ * @brief Frees a skip list and everything it holds, except for its contents
+ * (whatever the list's auto_free is).
+ * 
+ * @param list - The list to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int skip_teardown_keep(struct SkipList* list) {
+
+    return free_skip_list(list, 0);
+}
+
+
+
+/**
+ * @brief Grows the circular array of a deque to a given capacity. Contents
+ * which wrapped around the end of the old array are moved to just after its
+ * old end, so that they still follow on from the rest.
+ * 
+ * @param deque - The deque whose array will be grown.
+ * @param capacity - The new capacity of the array, which must be a power of
+ * two, and at least twice the old capacity (or 8 or more, if there was no
+ * array yet).
+ * 
+ * @returns 0 on failure (not enough heap to grow array), 1 on success.
+ */
+int resize_ring_deque(struct RingDeque* deque, int capacity) {
+
+    void** contents = reallocate(deque->allocator, deque->contents, deque->capacity * sizeof(void*), capacity * sizeof(void*));
+
+    if(contents == NULL)
+        return 0; //couldn't allocate enough heap for the array.
+
+    // The wrapped contents fit after the old end, since the array at least
+    // doubled
+    int num_wrapped = deque->head + deque->length - deque->capacity;
+
+    if(num_wrapped > 0)
+        memcpy(contents + deque->capacity, contents, num_wrapped * sizeof(void*));
+
+    deque->contents = contents;
+    deque->capacity = capacity;
+
+    return 1;
+}
+
+
+/**
+ * @brief Makes sure a deque has room for at least a given number of
+ * contents, so that adding up to that many will not reallocate the array.
+ * The capacity is rounded up to a power of two.
+ * 
+ * @param deque - The deque to reserve room in.
+ * @param capacity - The number of contents to make room for.
+ * 
+ * @returns 0 on failure (not enough heap to grow array), 1 on success.
+ */
+int ring_reserve(struct RingDeque* deque, int capacity) {
+
+    assertf(deque != NULL, "Tried to reserve room in a NULL Ring Deque.\n");
+
+    assertf(capacity <= (1 << 30), "Tried to reserve room for %d contents in a Ring Deque.\n", capacity);
+
+    if(capacity <= deque->capacity)
+        return 1;
+
+    int new_capacity = deque->capacity < 8 ? 8 : deque->capacity * 2;
+
+    while(new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+
+    return resize_ring_deque(deque, new_capacity);
+}
+
+
+/**
+ * @brief Adds new contents "contents" to the back of a deque. When the array
+ * is full, its capacity is doubled, so this is amortized O(1).
+ * 
+ * @remark Also increments the length of the deque by 1 on success.
+ * 
+ * @param deque - The deque to add the contents to.
+ * @param contents - The contents to add.
+ * 
+ * @returns 0 on failure (not enough heap to grow array), 1 on success.
+ */
+int ring_push_back(struct RingDeque* deque, void* contents) {
+
+    assertf(deque != NULL, "Tried to push onto a NULL Ring Deque.\n");
+
+    if(deque->length == deque->capacity && !ring_reserve(deque, deque->length + 1))
+        return 0;
+
+    deque->contents[(deque->head + deque->length) & (deque->capacity - 1)] = contents;
+    deque->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Adds new contents "contents" to the front of a deque. When the array
+ * is full, its capacity is doubled, so this is amortized O(1).
+ * 
+ * @remark Also increments the length of the deque by 1 on success.
+ * 
+ * @param deque - The deque to add the contents to.
+ * @param contents - The contents to add.
+ * 
+ * @returns 0 on failure (not enough heap to grow array), 1 on success.
+ */
+int ring_push_front(struct RingDeque* deque, void* contents) {
+
+    assertf(deque != NULL, "Tried to push onto a NULL Ring Deque.\n");
+
+    if(deque->length == deque->capacity && !ring_reserve(deque, deque->length + 1))
+        return 0;
+
+    deque->head = (deque->head - 1) & (deque->capacity - 1);
+    deque->contents[deque->head] = contents;
+    deque->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Removes the first contents from a deque in O(1), and returns them.
+ * The contents now belong to the caller.
+ * 
+ * @param deque - The deque to remove the contents from.
+ * 
+ * @returns NULL if the deque is empty, void* to the removed contents
+ * otherwise.
+ */
+void* ring_pop_front(struct RingDeque* deque) {
+
+    assertf(deque != NULL, "Tried to pop from a NULL Ring Deque.\n");
+
+    if(deque->length == 0)
+        return NULL;
+
+    void* contents = deque->contents[deque->head];
+
+    deque->head = (deque->head + 1) & (deque->capacity - 1);
+    deque->length--;
+
+    return contents;
+}
+
+
+/**
+ * @brief Removes the last contents from a deque in O(1), and returns them.
+ * The contents now belong to the caller.
+ * 
+ * @param deque - The deque to remove the contents from.
+ * 
+ * @returns NULL if the deque is empty, void* to the removed contents
+ * otherwise.
+ */
+void* ring_pop_back(struct RingDeque* deque) {
+
+    assertf(deque != NULL, "Tried to pop from a NULL Ring Deque.\n");
+
+    if(deque->length == 0)
+        return NULL;
+
+    deque->length--;
+
+    return deque->contents[(deque->head + deque->length) & (deque->capacity - 1)];
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, at the given index of a deque,
+ * counting from the front.
+ * 
+ * @remark This function will crash the program upon trying to obtain an
+ * index outside the bounds of the deque, which is (-inf,0)U[length,inf) .
+ * 
+ * @param deque - The deque to obtain the desired contents from.
+ * @param index - The index from which the desired contents will be obtained.
+ * 
+ * @returns void* to desired contents.
+ */
+void* ring_get(struct RingDeque* deque, int index) {
+
+    assertf(deque != NULL, "Tried to get data from a NULL Ring Deque.\n");
+
+    assertf(index >= 0 && index < deque->length, "Tried to get data at invalid index in Ring Deque.\n");
+
+    return deque->contents[(deque->head + index) & (deque->capacity - 1)];
+}
+
+
+/**
+ * @brief Returns the contents, a void pointer, at the given index of a deque,
+ * counting from the front. If the index does not exist, returns a default
+ * value instead.
+ * 
+ * @param deque - The deque to obtain the desired contents from.
+ * @param index - The index from which the desired contents will be obtained.
+ * @param _default - A default value to return if the index does not exist in
+ * the deque
+ * 
+ * @returns A void pointer to the contents at the desired index in the deque,
+ * default otherwise.
+ */
+void* ring_get_or_default(struct RingDeque* deque, int index, void* _default) {
+
+    assertf(deque != NULL, "Tried to get data from a NULL Ring Deque.\n");
+
+    if(index < 0 || index >= deque->length)
+        return _default;
+
+    return deque->contents[(deque->head + index) & (deque->capacity - 1)];
+}
+
+
+/**
+ * @brief Adds num_contents contents from an array to the back of a deque, in
+ * order. The array is grown at most once, and the contents are copied in with
+ * at most two memcpy calls (one up to the end of the circular array, and one
+ * for whatever wraps around to its start).
+ * 
+ * @remark Also increments the length of the deque by num_contents on
+ * success. On failure, the deque is left unchanged.
+ * 
+ * @param deque - The deque to add the contents to.
+ * @param contents - The array of contents to add.
+ * @param num_contents - The number of contents in the array.
+ * 
+ * @returns 0 on failure (not enough heap to grow array), 1 on success.
+ */
+int ring_push_n(struct RingDeque* deque, void** contents, int num_contents) {
+
+    assertf(deque != NULL, "Tried to push onto a NULL Ring Deque.\n");
+
+    assertf(num_contents >= 0, "Tried to push a negative number of contents onto a Ring Deque.\n");
+
+    if(num_contents == 0)
+        return 1;
+
+    if(!ring_reserve(deque, deque->length + num_contents))
+        return 0;
+
+    int tail = (deque->head + deque->length) & (deque->capacity - 1);
+    int num_before_end = deque->capacity - tail;
+
+    if(num_before_end > num_contents)
+        num_before_end = num_contents;
+
+    memcpy(deque->contents + tail, contents, num_before_end * sizeof(void*));
+    memcpy(deque->contents, contents + num_before_end, (num_contents - num_before_end) * sizeof(void*));
+
+    deque->length += num_contents;
+
+    return 1;
+}
+
+
+/**
+ * @brief Removes up to num_contents contents from the front of a deque into an
+ * array, in order, copying them out with at most two memcpy calls. The
+ * contents now belong to the caller.
+ * 
+ * @remark Also decrements the length of the deque by the number of contents
+ * removed.
+ * 
+ * @param deque - The deque to remove the contents from.
+ * @param destination - The array to copy the contents into, with room for
+ * num_contents contents.
+ * @param num_contents - The most contents to remove.
+ * 
+ * @returns The number of contents removed (less than num_contents if the
+ * deque ran out).
+ */
+int ring_pop_n(struct RingDeque* deque, void** destination, int num_contents) {
+
+    assertf(deque != NULL, "Tried to pop from a NULL Ring Deque.\n");
+
+    assertf(num_contents >= 0, "Tried to pop a negative number of contents from a Ring Deque.\n");
+
+    if(num_contents > deque->length)
+        num_contents = deque->length;
+
+    if(num_contents == 0)
+        return 0;
+
+    int num_before_end = deque->capacity - deque->head;
+
+    if(num_before_end > num_contents)
+        num_before_end = num_contents;
+
+    memcpy(destination, deque->contents + deque->head, num_before_end * sizeof(void*));
+    memcpy(destination + num_before_end, deque->contents, (num_contents - num_before_end) * sizeof(void*));
+
+    deque->head = (deque->head + num_contents) & (deque->capacity - 1);
+    deque->length -= num_contents;
+
+    return num_contents;
+}
+
+
+/**
+ * @brief Frees a deque, its array, and all of its contents.
+ * 
+ * @remark This function may result in a double free if the same pointer is
+ * stored more than once in the deque.
+ * 
+ * @param deque - The deque to tear down.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 1 on success.
+ */
+int free_ring_deque(struct RingDeque* deque, int auto_free) {
+
+    if(auto_free) {
+        for(int i = 0; i < deque->length; i++) {
+            void* contents = deque->contents[(deque->head + i) & (deque->capacity - 1)];
+
+            if(contents != NULL)
+                free(contents);
+        }
+    }
+
+    deallocate(deque->allocator, deque->contents);
+    deallocate(deque->allocator, deque);
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees a deque and everything it holds, including its contents
+ * unless the deque's auto_free is turned off.
+ * 
+ * @param deque - The deque to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int ring_teardown(struct RingDeque* deque) {
+
+    return free_ring_deque(deque, deque->auto_free);
+}
+
+
+/**
+ * @brief Frees a deque and everything it holds, except for its contents
+ * (whatever the deque's auto_free is).
+ * 
+ * @param deque - The deque to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int ring_teardown_keep(struct RingDeque* deque) {
+
+    return free_ring_deque(deque, 0);
+}
+
+
+
+/**
+ * @brief Grows the arrays of a priority queue to a given capacity.
+ * 
+ * @param queue - The queue whose arrays will be grown.
+ * @param capacity - The new capacity of the arrays, which must be more than
+ * the old capacity.
+ * 
+ * @returns 0 on failure (not enough heap to grow arrays), 1 on success. On
+ * failure, the queue still works with its old capacity.
+ */
+int resize_priority_queue(struct PriorityQueue* queue, int capacity) {
+
+    size_t old_capacity = queue->capacity;
+
+    void** contents = reallocate(queue->allocator, queue->contents, old_capacity * sizeof(void*), capacity * sizeof(void*));
+
+    if(contents == NULL)
+        return 0;
+
+    queue->contents = contents;
+
+    int* handles = reallocate(queue->allocator, queue->handles, old_capacity * sizeof(int), capacity * sizeof(int));
+
+    if(handles == NULL)
+        return 0;
+
+    queue->handles = handles;
+
+    int* positions = reallocate(queue->allocator, queue->positions, old_capacity * sizeof(int), capacity * sizeof(int));
+
+    if(positions == NULL)
+        return 0;
+
+    queue->positions = positions;
+    queue->capacity = capacity;
+
+    return 1;
+}
+
+
+/**
+ * @brief Makes sure a priority queue has room for at least a given number of
+ * contents, so that pushing up to that many will not reallocate its arrays.
+ * 
+ * @param queue - The queue to reserve room in.
+ * @param capacity - The number of contents to make room for.
+ * 
+ * @returns 0 on failure (not enough heap to grow arrays), 1 on success.
+ */
+int priority_queue_reserve(struct PriorityQueue* queue, int capacity) {
+
+    assertf(queue != NULL, "Tried to reserve room in a NULL Priority Queue.\n");
+
+    if(capacity <= queue->capacity)
+        return 1;
+
+    int new_capacity = queue->capacity < 8 ? 8 : queue->capacity * 2;
+
+    return resize_priority_queue(queue, new_capacity < capacity ? capacity : new_capacity);
+}
+
+
+/**
+ * @brief Takes an unused handle from a priority queue, reusing handles whose
+ * contents were popped before giving out new ones.
+ * 
+ * @remark There is always an unused handle below the queue's capacity while
+ * its length is below its capacity, since every handle in use belongs to
+ * contents in the heap.
+ * 
+ * @param queue - The queue to take a handle from.
+ * 
+ * @returns The handle.
+ */
+int take_priority_queue_handle(struct PriorityQueue* queue) {
+
+    if(queue->free_handle == -1)
+        return queue->num_handles++;
+
+    int handle = queue->free_handle;
+
+    queue->free_handle = -2 - queue->positions[handle];
+
+    return handle;
+}
+
+
+/**
+ * @brief Puts contents and their handle at a position in the heap of a
+ * priority queue, and records the position for the handle.
+ * 
+ * @param queue - The queue to put the contents in.
+ * @param position - The position in the heap to put them at.
+ * @param contents - The contents.
+ * @param handle - The handle of the contents.
+ */
+void place_in_heap(struct PriorityQueue* queue, int position, void* contents, int handle) {
+
+    queue->contents[position] = contents;
+    queue->handles[position] = handle;
+    queue->positions[handle] = position;
+}
+
+
+/**
+ * @brief Moves the contents at a position in the heap of a priority queue up
+ * towards the root, until their parent is no bigger than them. Parents are
+ * moved down into the gap as it goes, rather than swapped.
+ * 
+ * @param queue - The queue whose heap will be fixed.
+ * @param position - The position of the contents to move up.
+ */
+void heap_sift_up(struct PriorityQueue* queue, int position) {
+
+    void* contents = queue->contents[position];
+    int handle = queue->handles[position];
+
+    while(position > 0) {
+        int parent = (position - 1) / queue->arity;
+
+        if(queue->compare(queue->contents[parent], contents) <= 0)
+            break;
+
+        place_in_heap(queue, position, queue->contents[parent], queue->handles[parent]);
+
+        position = parent;
+    }
+
+    place_in_heap(queue, position, contents, handle);
+}
+
+
+/**
+ * @brief Moves the contents at a position in the heap of a priority queue
+ * down towards the leaves, until none of their children are smaller than
+ * them. The smallest child is moved up into the gap at each level.
+ * 
+ * @param queue - The queue whose heap will be fixed.
+ * @param position - The position of the contents to move down.
+ */
+void heap_sift_down(struct PriorityQueue* queue, int position) {
+
+    void* contents = queue->contents[position];
+    int handle = queue->handles[position];
+
+    while(1) {
+        int first_child = queue->arity * position + 1;
+
+        if(first_child >= queue->length)
+            break;
+
+        int last_child = first_child + queue->arity;
+
+        if(last_child > queue->length)
+            last_child = queue->length;
+
+        // Find the smallest of the children, which sit next to each other
+        int smallest = first_child;
+
+        for(int child = first_child + 1; child < last_child; child++) {
+            if(queue->compare(queue->contents[child], queue->contents[smallest]) < 0)
+                smallest = child;
+        }
+
+        if(queue->compare(queue->contents[smallest], contents) >= 0)
+            break;
+
+        place_in_heap(queue, position, queue->contents[smallest], queue->handles[smallest]);
+
+        position = smallest;
+    }
+
+    place_in_heap(queue, position, contents, handle);
+}
+
+
+/**
+ * @brief Adds new contents "contents" to a priority queue in O(log n).
+ * 
+ * @remark Also increments the length of the queue by 1 on success.
+ * 
+ * @param queue - The queue to add the contents to.
+ * @param contents - The contents to add.
+ * @param handle - Where to store the handle of the contents (may be NULL).
+ * 
+ * @returns 0 on failure (not enough heap to grow arrays), 1 on success.
+ */
+int priority_queue_push(struct PriorityQueue* queue, void* contents, int* handle) {
+
+    assertf(queue != NULL, "Tried to push onto a NULL Priority Queue.\n");
+
+    if(queue->length == queue->capacity && !priority_queue_reserve(queue, queue->length + 1))
+        return 0;
+
+    int new_handle = take_priority_queue_handle(queue);
+
+    place_in_heap(queue, queue->length, contents, new_handle);
+    queue->length++;
+
+    heap_sift_up(queue, queue->length - 1);
+
+    if(handle != NULL)
+        *handle = new_handle;
+
+    return 1;
+}
+
+
+/**
+ * @brief Removes the smallest contents from a priority queue in O(log n), and
+ * returns them. The contents now belong to the caller, and their handle may
+ * be given to contents pushed later.
+ * 
+ * @param queue - The queue to remove the contents from.
+ * 
+ * @returns NULL if the queue is empty, void* to the removed contents
+ * otherwise.
+ */
+void* priority_queue_pop(struct PriorityQueue* queue) {
+
+    assertf(queue != NULL, "Tried to pop from a NULL Priority Queue.\n");
+
+    if(queue->length == 0)
+        return NULL;
+
+    void* contents = queue->contents[0];
+    int handle = queue->handles[0];
+
+    // Give the handle back
+    queue->positions[handle] = -2 - queue->free_handle;
+    queue->free_handle = handle;
+
+    // Move the last contents to the root, and down to where they belong
+    queue->length--;
+
+    if(queue->length > 0) {
+        place_in_heap(queue, 0, queue->contents[queue->length], queue->handles[queue->length]);
+        heap_sift_down(queue, 0);
+    }
+
+    return contents;
+}
+
+
+/**
+ * @brief Returns the smallest contents in a priority queue in O(1), without
+ * removing them.
+ * 
+ * @param queue - The queue to look in.
+ * 
+ * @returns NULL if the queue is empty, void* to the smallest contents
+ * otherwise.
+ */
+void* priority_queue_peek(struct PriorityQueue* queue) {
+
+    assertf(queue != NULL, "Tried to peek into a NULL Priority Queue.\n");
+
+    if(queue->length == 0)
+        return NULL;
+
+    return queue->contents[0];
+}
+
+
+/**
+ * @brief Rebuilds the heap of a priority queue from scratch in O(n), by moving
+ * every parent down, from the last parent back to the root (Floyd's method).
+ * 
+ * @param queue - The queue whose heap will be rebuilt.
+ */
+void build_heap(struct PriorityQueue* queue) {
+
+    if(queue->length < 2)
+        return;
+
+    for(int position = (queue->length - 2) / queue->arity; position >= 0; position--) {
+        heap_sift_down(queue, position);
+    }
+}
+
+
+/**
+ * @brief Adds num_contents contents from an array to a priority queue, and
+ * rebuilds the heap once in O(n), rather than pushing each of them in
+ * O(log n).
+ * 
+ * @remark Also increments the length of the queue by num_contents on
+ * success. On failure, the queue is left unchanged.
+ * 
+ * @param queue - The queue to add the contents to.
+ * @param contents - The array of contents to add.
+ * @param num_contents - The number of contents in the array.
+ * @param handles - An array with room for num_contents handles, where the
+ * handle of each contents is stored (may be NULL).
+ * 
+ * @returns 0 on failure (not enough heap to grow arrays), 1 on success.
+ */
+int priority_queue_heapify(struct PriorityQueue* queue, void** contents, int num_contents, int* handles) {
+
+    assertf(queue != NULL, "Tried to heapify into a NULL Priority Queue.\n");
+
+    assertf(num_contents >= 0, "Tried to heapify a negative number of contents into a Priority Queue.\n");
+
+    if(!priority_queue_reserve(queue, queue->length + num_contents))
+        return 0;
+
+    for(int i = 0; i < num_contents; i++) {
+        int handle = take_priority_queue_handle(queue);
+
+        place_in_heap(queue, queue->length + i, contents[i], handle);
+
+        if(handles != NULL)
+            handles[i] = handle;
+    }
+
+    queue->length += num_contents;
+
+    build_heap(queue);
+
+    return 1;
+}
+
+
+/**
+ * @brief Adds the contents of every node in a list to a priority queue, and
+ * rebuilds the heap once in O(n). The list is left as it was, so the
+ * contents are shared with it (turn off auto_free on one of them).
+ * 
+ * @remark Also increments the length of the queue by the length of the list
+ * on success. On failure, the queue is left unchanged.
+ * 
+ * @param queue - The queue to add the contents to.
+ * @param list - The list whose contents will be added.
+ * @param handles - An array with room for a handle for every node in the
+ * list, where the handle of each contents is stored in list order (may be
+ * NULL).
+ * 
+ * @returns 0 on failure (not enough heap to grow arrays), 1 on success.
+ */
+int priority_queue_heapify_list(struct PriorityQueue* queue, struct LinkedList* list, int* handles) {
+
+    assertf(queue != NULL, "Tried to heapify into a NULL Priority Queue.\n");
+
+    assertf(list != NULL, "Tried to heapify a NULL Linked List into a Priority Queue.\n");
+
+    if(!priority_queue_reserve(queue, queue->length + list->length))
+        return 0;
+
+    int i = 0;
+
+    for(struct Node* current_node = list->head; current_node != NULL; current_node = current_node->next) {
+        int handle = take_priority_queue_handle(queue);
+
+        place_in_heap(queue, queue->length + i, current_node->contents, handle);
+
+        if(handles != NULL)
+            handles[i] = handle;
+
+        i++;
+    }
+
+    queue->length += i;
+
+    build_heap(queue);
+
+    return 1;
+}
+
+
+/**
+ * @brief Moves the contents with a given handle up the heap of a priority
+ * queue in O(log n), after the caller changed them so that they compare
+ * smaller than before.
+ * 
+ * @remark Contents which were changed to compare bigger must be popped and
+ * pushed again instead.
+ * 
+ * @param queue - The queue holding the contents.
+ * @param handle - The handle of the contents which changed.
+ * 
+ * @returns 0 on failure (handle is not in use), 1 on success.
+ */
+int priority_queue_decrease_key(struct PriorityQueue* queue, int handle) {
+
+    assertf(queue != NULL, "Tried to decrease a key in a NULL Priority Queue.\n");
+
+    if(handle < 0 || handle >= queue->num_handles || queue->positions[handle] < 0)
+        return 0;
+
+    heap_sift_up(queue, queue->positions[handle]);
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees a priority queue, its arrays, and all of its contents.
+ * 
+ * @remark This function may result in a double free if the same pointer is
+ * stored more than once in the queue.
+ * 
+ * @param queue - The queue to tear down.
+ * @param auto_free - Whether to free the contents.
+ * 
+ * @returns 1 on success.
+ */
+int free_priority_queue(struct PriorityQueue* queue, int auto_free) {
+
+    if(auto_free) {
+        for(int i = 0; i < queue->length; i++) {
+            if(queue->contents[i] != NULL)
+                free(queue->contents[i]);
+        }
+    }
+
+    deallocate(queue->allocator, queue->contents);
+    deallocate(queue->allocator, queue->handles);
+    deallocate(queue->allocator, queue->positions);
+    deallocate(queue->allocator, queue);
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees a priority queue and everything it holds, including its
+ * contents unless the queue's auto_free is turned off.
+ * 
+ * @param queue - The queue to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int priority_queue_teardown(struct PriorityQueue* queue) {
+
+    return free_priority_queue(queue, queue->auto_free);
+}
+
+
+/**
+ * @brief Frees a priority queue and everything it holds, except for its
+ * contents (whatever the queue's auto_free is).
+ * 
+ * @param queue - The queue to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int priority_queue_teardown_keep(struct PriorityQueue* queue) {
+
+    return free_priority_queue(queue, 0);
+}
+
+
+// Nodes other than the root are never left with fewer keys than these (so
+// two siblings which are too small to share can always be merged)
+#define BTREE_LEAF_MIN_KEYS (BTREE_NODE_KEYS / 2)
+#define BTREE_INTERNAL_MIN_KEYS ((BTREE_NODE_KEYS - 1) / 2)
+
+/**
+ * @brief Finds the first key in a B+tree node which is at least a given key,
+ * with a binary search.
+ * 
+ * @param map - The map which the node belongs to.
+ * @param node - The node to search.
+ * @param key - The key to search for.
+ * 
+ * @returns The index of the first key which is at least key (num_keys if
+ * there is none).
+ */
+int btree_lower_bound(struct BTreeMap* map, struct BTreeNode* node, void* key) {
+
+    int low = 0;
+    int high = node->num_keys;
+
+    while(low < high) {
+        int middle = (low + high) / 2;
+
+        if(map->compare(node->keys[middle], key) < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+
+/**
+ * @brief Finds the first key in a B+tree node which is bigger than a given
+ * key, with a binary search. In an internal node, this is the index of the
+ * child whose keys the key falls between.
+ * 
+ * @param map - The map which the node belongs to.
+ * @param node - The node to search.
+ * @param key - The key to search for.
+ * 
+ * @returns The index of the first key which is bigger than key (num_keys if
+ * there is none).
+ */
+int btree_upper_bound(struct BTreeMap* map, struct BTreeNode* node, void* key) {
+
+    int low = 0;
+    int high = node->num_keys;
+
+    while(low < high) {
+        int middle = (low + high) / 2;
+
+        if(map->compare(node->keys[middle], key) <= 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+
+/**
+ * @brief Finds the leaf of a B+tree which a key belongs in, by following the
+ * children of the internal nodes down from the root.
+ * 
+ * @param map - The map to search.
+ * @param key - The key to search for.
+ * 
+ * @returns Pointer to the leaf.
+ */
+struct BTreeLeaf* find_btree_leaf(struct BTreeMap* map, void* key) {
+
+    struct BTreeNode* node = map->root;
+
+    while(!node->is_leaf) {
+        node = ((struct BTreeInternal*) node)->children[btree_upper_bound(map, node, key)];
+    }
+
+    return (struct BTreeLeaf*) node;
+}
+
+
+/**
+ * @brief Returns the smallest key under a node of a B+tree (the first key of
+ * its leftmost leaf).
+ * 
+ * @param node - The node to start from, which must have keys under it.
+ * 
+ * @returns The smallest key.
+ */
+void* btree_first_key(struct BTreeNode* node) {
+
+    while(!node->is_leaf) {
+        node = ((struct BTreeInternal*) node)->children[0];
+    }
+
+    return node->keys[0];
+}
+
+
+/**
+ * @brief Returns the leftmost leaf of a B+tree, which holds its smallest keys.
+ * 
+ * @param map - The map to search.
+ * 
+ * @returns Pointer to the leaf.
+ */
+struct BTreeLeaf* first_btree_leaf(struct BTreeMap* map) {
+
+    struct BTreeNode* node = map->root;
+
+    while(!node->is_leaf) {
+        node = ((struct BTreeInternal*) node)->children[0];
+    }
+
+    return (struct BTreeLeaf*) node;
+}
+
+
+/**
+ * @brief Allocates a new, empty leaf for a B+tree from the map's leaf pool.
+ * 
+ * @param map - The map which the leaf will belong to.
+ * 
+ * @returns NULL on failure (not enough heap to allocate leaf), pointer to the
+ * new leaf on success.
+ */
+struct BTreeLeaf* allocate_btree_leaf(struct BTreeMap* map) {
+
+    struct BTreeLeaf* leaf = map->leaf_pool->allocate(map->leaf_pool);
+
+    if(leaf == NULL)
+        return NULL;
+
+    leaf->node.num_keys = 0;
+    leaf->node.is_leaf = 1;
+    leaf->prev = NULL;
+    leaf->next = NULL;
+
+    return leaf;
+}
+
+
+/**
+ * @brief Allocates a new, empty internal node for a B+tree from the map's
+ * internal node pool.
+ * 
+ * @param map - The map which the node will belong to.
+ * 
+ * @returns NULL on failure (not enough heap to allocate node), pointer to
+ * the new node on success.
+ */
+struct BTreeInternal* allocate_btree_internal(struct BTreeMap* map) {
+
+    struct BTreeInternal* internal = map->internal_pool->allocate(map->internal_pool);
+
+    if(internal == NULL)
+        return NULL;
+
+    internal->node.num_keys = 0;
+    internal->node.is_leaf = 0;
+
+    return internal;
+}
+
+
+/**
+ * @brief Gives a node of a B+tree back to the pool it came from.
+ * 
+ * @param map - The map which the node belonged to.
+ * @param node - The node to free.
+ */
+void free_btree_node(struct BTreeMap* map, struct BTreeNode* node) {
+
+    if(node->is_leaf)
+        map->leaf_pool->release(map->leaf_pool, node);
+    else
+        map->internal_pool->release(map->internal_pool, node);
+}
+
+
+/**
+ * @brief Splits a full child of an internal node of a B+tree in two, and adds
+ * the new right half as the next child of the parent. A leaf's first key
+ * after the split is copied up into the parent, while an internal node's
+ * middle key is moved up.
+ * 
+ * @param map - The map which the nodes belong to.
+ * @param parent - The parent of the full child, which must not be full.
+ * @param index - The index of the full child in the parent.
+ * 
+ * @returns 0 on failure (not enough heap to allocate node), 1 on success.
+ */
+int split_btree_child(struct BTreeMap* map, struct BTreeInternal* parent, int index) {
+
+    struct BTreeNode* child = parent->children[index];
+    struct BTreeNode* right;
+    void* separator;
+
+    if(child->is_leaf) {
+        struct BTreeLeaf* left_leaf = (struct BTreeLeaf*) child;
+        struct BTreeLeaf* right_leaf = allocate_btree_leaf(map);
+
+        if(right_leaf == NULL)
+            return 0;
+
+        int num_moved = BTREE_NODE_KEYS - BTREE_NODE_KEYS / 2;
+
+        memcpy(right_leaf->node.keys, child->keys + BTREE_NODE_KEYS / 2, num_moved * sizeof(void*));
+        memcpy(right_leaf->values, left_leaf->values + BTREE_NODE_KEYS / 2, num_moved * sizeof(void*));
+
+        right_leaf->node.num_keys = num_moved;
+        child->num_keys = BTREE_NODE_KEYS / 2;
+
+        // Link the new leaf in after the old one
+        right_leaf->prev = left_leaf;
+        right_leaf->next = left_leaf->next;
+
+        if(left_leaf->next != NULL)
+            left_leaf->next->prev = right_leaf;
+
+        left_leaf->next = right_leaf;
+
+        right = &right_leaf->node;
+        separator = right->keys[0];
+    }
+    else {
+        struct BTreeInternal* left_internal = (struct BTreeInternal*) child;
+        struct BTreeInternal* right_internal = allocate_btree_internal(map);
+
+        if(right_internal == NULL)
+            return 0;
+
+        int middle = BTREE_NODE_KEYS / 2;
+        int num_moved = BTREE_NODE_KEYS - middle - 1;
+
+        memcpy(right_internal->node.keys, child->keys + middle + 1, num_moved * sizeof(void*));
+        memcpy(right_internal->children, left_internal->children + middle + 1, (num_moved + 1) * sizeof(struct BTreeNode*));
+
+        right_internal->node.num_keys = num_moved;
+        child->num_keys = middle;
+
+        right = &right_internal->node;
+        separator = child->keys[middle];
+    }
+
+    // Make room for the separator and the new child in the parent
+    memmove(parent->node.keys + index + 1, parent->node.keys + index, (parent->node.num_keys - index) * sizeof(void*));
+    memmove(parent->children + index + 2, parent->children + index + 1, (parent->node.num_keys - index) * sizeof(struct BTreeNode*));
+
+    parent->node.keys[index] = separator;
+    parent->children[index + 1] = right;
+    parent->node.num_keys++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Adds a key with a value to a B+tree map. If the key is already in
+ * the map, its key and value are replaced, and the old ones are freed (if
+ * they are owned by the map, see free_keys and free_values).
+ * 
+ * @remark Full nodes are split on the way down from the root, so that there
+ * is always room in the parent for a split child, and the tree only ever
+ * grows taller at the root. This is O(log n).
+ * 
+ * @param map - The map to add the key to.
+ * @param key - The key to add.
+ * @param value - The value of the key.
+ * 
+ * @returns 0 on failure (not enough heap to allocate nodes), 1 on success.
+ */
+int btree_put(struct BTreeMap* map, void* key, void* value) {
+
+    assertf(map != NULL, "Tried to put a key into a NULL B+Tree Map.\n");
+
+    // Split a full root under a new root
+    if(map->root->num_keys == BTREE_NODE_KEYS) {
+        struct BTreeInternal* root = allocate_btree_internal(map);
+
+        if(root == NULL)
+            return 0;
+
+        root->children[0] = map->root;
+
+        if(!split_btree_child(map, root, 0)) {
+            free_btree_node(map, &root->node);
+            return 0;
+        }
+
+        map->root = &root->node;
+    }
+
+    struct BTreeNode* node = map->root;
+
+    // Stores where the key is copied into an internal node, if it is
+    // already in the map and is the first key of its leaf
+    void** separator = NULL;
+
+    while(!node->is_leaf) {
+        struct BTreeInternal* internal = (struct BTreeInternal*) node;
+
+        int index = btree_upper_bound(map, node, key);
+
+        if(internal->children[index]->num_keys == BTREE_NODE_KEYS) {
+            if(!split_btree_child(map, internal, index))
+                return 0;
+
+            if(map->compare(key, node->keys[index]) >= 0)
+                index++;
+        }
+
+        if(index > 0 && map->compare(node->keys[index - 1], key) == 0)
+            separator = &node->keys[index - 1];
+
+        node = internal->children[index];
+    }
+
+    struct BTreeLeaf* leaf = (struct BTreeLeaf*) node;
+
+    int index = btree_lower_bound(map, node, key);
+
+    // Replace the key and value if the key is already in the map
+    if(index < node->num_keys && map->compare(node->keys[index], key) == 0) {
+
+        if(node->keys[index] != key && node->keys[index] != NULL && map->free_keys)
+            free(node->keys[index]);
+
+        if(leaf->values[index] != value && leaf->values[index] != NULL && map->free_values)
+            free(leaf->values[index]);
+
+        node->keys[index] = key;
+        leaf->values[index] = value;
+
+        if(separator != NULL)
+            *separator = key;
+
+        return 1;
+    }
+
+    memmove(node->keys + index + 1, node->keys + index, (node->num_keys - index) * sizeof(void*));
+    memmove(leaf->values + index + 1, leaf->values + index, (node->num_keys - index) * sizeof(void*));
+
+    node->keys[index] = key;
+    leaf->values[index] = value;
+    node->num_keys++;
+
+    map->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Returns the value, a void pointer, of a key in a B+tree map. If the
+ * key is not in the map, returns a default value instead.
+ * 
+ * @param map - The map to get the value from.
+ * @param key - The key whose value will be obtained.
+ * @param _default - A default value to return if the key is not in the map.
+ * 
+ * @returns A void pointer to the value of the key, default otherwise.
+ */
+void* btree_get_or_default(struct BTreeMap* map, void* key, void* _default) {
+
+    assertf(map != NULL, "Tried to get data from a NULL B+Tree Map.\n");
+
+    struct BTreeLeaf* leaf = find_btree_leaf(map, key);
+
+    int index = btree_lower_bound(map, &leaf->node, key);
+
+    if(index == leaf->node.num_keys || map->compare(leaf->node.keys[index], key) != 0)
+        return _default;
+
+    return leaf->values[index];
+}
+
+
+/**
+ * @brief Returns the value, a void pointer, of a key in a B+tree map.
+ * 
+ * @param map - The map to get the value from.
+ * @param key - The key whose value will be obtained.
+ * 
+ * @returns NULL if the key is not in the map, void* to its value otherwise.
+ */
+void* btree_get(struct BTreeMap* map, void* key) {
+
+    assertf(map != NULL, "Tried to get data from a NULL B+Tree Map.\n");
+
+    return btree_get_or_default(map, key, NULL);
+}
+
+
+/**
+ * @brief Fixes a child of an internal node of a B+tree which has one key too
+ * few, by moving a key over from a sibling which can spare one, or else by
+ * merging the child with a sibling (which takes a key and a child out of
+ * the parent).
+ * 
+ * @param map - The map which the nodes belong to.
+ * @param parent - The parent of the child.
+ * @param index - The index of the child in the parent.
+ */
+void rebalance_btree_child(struct BTreeMap* map, struct BTreeInternal* parent, int index) {
+
+    struct BTreeNode* child = parent->children[index];
+    struct BTreeNode* left = index > 0 ? parent->children[index - 1] : NULL;
+    struct BTreeNode* right = index < parent->node.num_keys ? parent->children[index + 1] : NULL;
+
+    int min_keys = child->is_leaf ? BTREE_LEAF_MIN_KEYS : BTREE_INTERNAL_MIN_KEYS;
+
+    if(left != NULL && left->num_keys > min_keys) {
+
+        // Move the last key of the left sibling to the front of the child
+        memmove(child->keys + 1, child->keys, child->num_keys * sizeof(void*));
+
+        if(child->is_leaf) {
+            struct BTreeLeaf* leaf = (struct BTreeLeaf*) child;
+
+            memmove(leaf->values + 1, leaf->values, child->num_keys * sizeof(void*));
+
+            child->keys[0] = left->keys[left->num_keys - 1];
+            leaf->values[0] = ((struct BTreeLeaf*) left)->values[left->num_keys - 1];
+
+            parent->node.keys[index - 1] = child->keys[0];
+        }
+        else {
+            struct BTreeInternal* internal = (struct BTreeInternal*) child;
+
+            memmove(internal->children + 1, internal->children, (child->num_keys + 1) * sizeof(struct BTreeNode*));
+
+            child->keys[0] = parent->node.keys[index - 1];
+            internal->children[0] = ((struct BTreeInternal*) left)->children[left->num_keys];
+
+            parent->node.keys[index - 1] = left->keys[left->num_keys - 1];
+        }
+
+        left->num_keys--;
+        child->num_keys++;
+    }
+    else if(right != NULL && right->num_keys > min_keys) {
+
+        // Move the first key of the right sibling to the back of the child
+        if(child->is_leaf) {
+            struct BTreeLeaf* leaf = (struct BTreeLeaf*) child;
+            struct BTreeLeaf* right_leaf = (struct BTreeLeaf*) right;
+
+            child->keys[child->num_keys] = right->keys[0];
+            leaf->values[child->num_keys] = right_leaf->values[0];
+
+            memmove(right_leaf->values, right_leaf->values + 1, (right->num_keys - 1) * sizeof(void*));
+            memmove(right->keys, right->keys + 1, (right->num_keys - 1) * sizeof(void*));
+
+            parent->node.keys[index] = right->keys[0];
+        }
+        else {
+            struct BTreeInternal* internal = (struct BTreeInternal*) child;
+            struct BTreeInternal* right_internal = (struct BTreeInternal*) right;
+
+            child->keys[child->num_keys] = parent->node.keys[index];
+            internal->children[child->num_keys + 1] = right_internal->children[0];
+
+            parent->node.keys[index] = right->keys[0];
+
+            memmove(right->keys, right->keys + 1, (right->num_keys - 1) * sizeof(void*));
+            memmove(right_internal->children, right_internal->children + 1, right->num_keys * sizeof(struct BTreeNode*));
+        }
+
+        right->num_keys--;
+        child->num_keys++;
+    }
+    else {
+
+        // Merge the child with a sibling, always into the one on the left
+        if(left == NULL) {
+            left = child;
+            right = parent->children[index + 1];
+        }
+        else {
+            right = child;
+            index--;
+        }
+
+        if(left->is_leaf) {
+            struct BTreeLeaf* left_leaf = (struct BTreeLeaf*) left;
+            struct BTreeLeaf* right_leaf = (struct BTreeLeaf*) right;
+
+            memcpy(left->keys + left->num_keys, right->keys, right->num_keys * sizeof(void*));
+            memcpy(left_leaf->values + left->num_keys, right_leaf->values, right->num_keys * sizeof(void*));
+
+            left->num_keys += right->num_keys;
+
+            left_leaf->next = right_leaf->next;
+
+            if(right_leaf->next != NULL)
+                right_leaf->next->prev = left_leaf;
+        }
+        else {
+            struct BTreeInternal* left_internal = (struct BTreeInternal*) left;
+            struct BTreeInternal* right_internal = (struct BTreeInternal*) right;
+
+            // The separator comes down between the two sets of keys
+            left->keys[left->num_keys] = parent->node.keys[index];
+
+            memcpy(left->keys + left->num_keys + 1, right->keys, right->num_keys * sizeof(void*));
+            memcpy(left_internal->children + left->num_keys + 1, right_internal->children, (right->num_keys + 1) * sizeof(struct BTreeNode*));
+
+            left->num_keys += right->num_keys + 1;
+        }
+
+        free_btree_node(map, right);
+
+        // Take the separator and the right node out of the parent
+        memmove(parent->node.keys + index, parent->node.keys + index + 1, (parent->node.num_keys - index - 1) * sizeof(void*));
+        memmove(parent->children + index + 1, parent->children + index + 2, (parent->node.num_keys - index - 1) * sizeof(struct BTreeNode*));
+
+        parent->node.num_keys--;
+    }
+}
+
+
+/**
+ * @brief Removes a key and its value from under a node of a B+tree, fixing
+ * any nodes left with too few keys on the way back up.
+ * 
+ * @remark Internal nodes hold copies of keys from the leaves, so a removed
+ * key may still be stored in one of the nodes above its leaf. It is replaced
+ * there with the new first key of the subtree it came from, before the key
+ * is handed back (and perhaps freed).
+ * 
+ * @param map - The map which the nodes belong to.
+ * @param node - The node to remove the key from under.
+ * @param key - The key to remove.
+ * @param removed_key - Where to store the key that was in the map.
+ * @param removed_value - Where to store the value of the key.
+ * 
+ * @returns 0 on failure (key is not in map), 1 on success.
+ */
+int remove_from_btree_node(struct BTreeMap* map, struct BTreeNode* node, void* key, void** removed_key, void** removed_value) {
+
+    if(node->is_leaf) {
+        struct BTreeLeaf* leaf = (struct BTreeLeaf*) node;
+
+        int index = btree_lower_bound(map, node, key);
+
+        if(index == node->num_keys || map->compare(node->keys[index], key) != 0)
+            return 0;
+
+        *removed_key = node->keys[index];
+        *removed_value = leaf->values[index];
+
+        memmove(node->keys + index, node->keys + index + 1, (node->num_keys - index - 1) * sizeof(void*));
+        memmove(leaf->values + index, leaf->values + index + 1, (node->num_keys - index - 1) * sizeof(void*));
+
+        node->num_keys--;
+
+        return 1;
+    }
+
+    struct BTreeInternal* internal = (struct BTreeInternal*) node;
+
+    int index = btree_upper_bound(map, node, key);
+
+    if(!remove_from_btree_node(map, internal->children[index], key, removed_key, removed_value))
+        return 0;
+
+    // If the key was copied into this node, it was the first key under the
+    // child (which still has keys left, since it lost at most one)
+    if(index > 0 && map->compare(node->keys[index - 1], key) == 0)
+        node->keys[index - 1] = btree_first_key(internal->children[index]);
+
+    struct BTreeNode* child = internal->children[index];
+
+    if(child->num_keys < (child->is_leaf ? BTREE_LEAF_MIN_KEYS : BTREE_INTERNAL_MIN_KEYS))
+        rebalance_btree_child(map, internal, index);
+
+    return 1;
+}
+
+
+/**
+ * @brief Removes a key and its value from a B+tree map in O(log n), freeing
+ * the ones owned by the map if auto_free is set (see btree_remove and
+ * btree_remove_keep).
+ * 
+ * @param map - The map to remove the key from.
+ * @param key - The key to remove.
+ * @param auto_free - Whether to free the key and value.
+ * 
+ * @returns 0 on failure (key is not in map), 1 on success.
+ */
+int btree_remove_entry(struct BTreeMap* map, void* key, int auto_free) {
+
+    assertf(map != NULL, "Tried to remove a key from a NULL B+Tree Map.\n");
+
+    void* removed_key;
+    void* removed_value;
+
+    if(!remove_from_btree_node(map, map->root, key, &removed_key, &removed_value))
+        return 0;
+
+    // The tree only gets shorter when the root is left with a single child
+    if(!map->root->is_leaf && map->root->num_keys == 0) {
+        struct BTreeNode* root = map->root;
+
+        map->root = ((struct BTreeInternal*) root)->children[0];
+
+        free_btree_node(map, root);
+    }
+
+    if(removed_key != NULL && auto_free && map->free_keys)
+        free(removed_key);
+
+    if(removed_value != NULL && auto_free && map->free_values)
+        free(removed_value);
+
+    map->length--;
+
+    return 1;
+}
+
+
+/**
+ * @brief Removes a key and its value from a B+tree map, freeing the ones
+ * owned by the map (see free_keys and free_values).
+ * 
+ * @param map - The map to remove the key from.
+ * @param key - The key to remove.
+ * 
+ * @returns 0 on failure (key is not in map), 1 on success.
+ */
+int btree_remove(struct BTreeMap* map, void* key) {
+
+    return btree_remove_entry(map, key, 1);
+}
+
+
+/**
+ * @brief Removes a key and its value from a B+tree map, without freeing them.
+ * 
+ * @param map - The map to remove the key from.
+ * @param key - The key to remove.
+ * 
+ * @returns 0 on failure (key is not in map), 1 on success.
+ */
+int btree_remove_keep(struct BTreeMap* map, void* key) {
+
+    return btree_remove_entry(map, key, 0);
+}
+
+
+/**
+ * @brief Fills an empty B+tree map from sorted arrays of keys and values in
+ * O(n). The leaves are packed as full as they can be (with the keys spread
+ * evenly, so that none has too few), and each level of internal nodes is
+ * then built over the one below, without any searching or splitting.
+ * 
+ * @remark Every node needed is reserved from the pools before anything is
+ * changed, so on failure the map is left empty.
+ * 
+ * @param map - The map to fill, which must be empty.
+ * @param keys - The keys to add, in strictly increasing order.
+ * @param values - The value of each key.
+ * @param num_keys - The number of keys in the arrays.
+ * 
+ * @returns 0 on failure (not enough heap to allocate nodes), 1 on success.
+ */
+int btree_bulk_load(struct BTreeMap* map, void** keys, void** values, int num_keys) {
+
+    assertf(map != NULL, "Tried to bulk load a NULL B+Tree Map.\n");
+
+    assertf(map->length == 0, "Tried to bulk load a B+Tree Map which is not empty.\n");
+
+    assertf(num_keys >= 0, "Tried to bulk load a negative number of keys into a B+Tree Map.\n");
+
+    for(int i = 1; i < num_keys; i++) {
+        assertf(map->compare(keys[i - 1], keys[i]) < 0, "Tried to bulk load keys out of order into a B+Tree Map.\n");
+    }
+
+    if(num_keys == 0)
+        return 1;
+
+    // Count the nodes on every level before allocating any of them
+    int num_leaves = (num_keys + BTREE_NODE_KEYS - 1) / BTREE_NODE_KEYS;
+    int num_internals = 0;
+
+    for(int count = num_leaves; count > 1; ) {
+        count = (count + BTREE_NODE_KEYS) / (BTREE_NODE_KEYS + 1);
+        num_internals += count;
+    }
+
+    if(!map->leaf_pool->reserve(map->leaf_pool, num_leaves) || !map->internal_pool->reserve(map->internal_pool, num_internals))
+        return 0;
+
+    // Stores the nodes of the level being built, and the first key under
+    // each of them (each level is written over the one below it)
+    struct BTreeNode** nodes = allocate(map->allocator, num_leaves * sizeof(struct BTreeNode*));
+    void** first_keys = allocate(map->allocator, num_leaves * sizeof(void*));
+
+    if(nodes == NULL || first_keys == NULL) {
+        deallocate(map->allocator, nodes);
+        deallocate(map->allocator, first_keys);
+        return 0;
+    }
+
+    free_btree_node(map, map->root);
+
+    struct BTreeLeaf* prev_leaf = NULL;
+    int next_key = 0;
+
+    for(int i = 0; i < num_leaves; i++) {
+        struct BTreeLeaf* leaf = allocate_btree_leaf(map);
+
+        int count = num_keys / num_leaves + (i < num_keys % num_leaves);
+
+        memcpy(leaf->node.keys, keys + next_key, count * sizeof(void*));
+        memcpy(leaf->values, values + next_key, count * sizeof(void*));
+
+        leaf->node.num_keys = count;
+        leaf->prev = prev_leaf;
+
+        if(prev_leaf != NULL)
+            prev_leaf->next = leaf;
+
+        nodes[i] = &leaf->node;
+        first_keys[i] = keys[next_key];
+
+        prev_leaf = leaf;
+        next_key += count;
+    }
+
+    int count = num_leaves;
+
+    while(count > 1) {
+        int num_parents = (count + BTREE_NODE_KEYS) / (BTREE_NODE_KEYS + 1);
+        int next_child = 0;
+
+        for(int i = 0; i < num_parents; i++) {
+            struct BTreeInternal* parent = allocate_btree_internal(map);
+
+            int num_children = count / num_parents + (i < count % num_parents);
+
+            for(int j = 0; j < num_children; j++) {
+                parent->children[j] = nodes[next_child + j];
+
+                if(j > 0)
+                    parent->node.keys[j - 1] = first_keys[next_child + j];
+            }
+
+            parent->node.num_keys = num_children - 1;
+
+            // The children of this parent were all read from at or after
+            // index i, so it is safe to write over them
+            nodes[i] = &parent->node;
+            first_keys[i] = first_keys[next_child];
+
+            next_child += num_children;
+        }
+
+        count = num_parents;
+    }
+
+    map->root = nodes[0];
+    map->length = num_keys;
+
+    deallocate(map->allocator, nodes);
+    deallocate(map->allocator, first_keys);
+
+    return 1;
+}
+
+
+/**
+ * @brief Moves a B+tree iterator on to the next leaf (or the previous one, if
+ * it walks backwards) when it has run off the end of its leaf, and ends it
+ * once it passes its bound.
+ * 
+ * @param iterator - The iterator to settle.
+ */
+void settle_btree_iterator(struct BTreeIterator* iterator) {
+
+    while(iterator->leaf != NULL) {
+
+        if(iterator->index < 0) {
+            iterator->leaf = iterator->leaf->prev;
+
+            if(iterator->leaf != NULL)
+                iterator->index = iterator->leaf->node.num_keys - 1;
+        }
+        else if(iterator->index >= iterator->leaf->node.num_keys) {
+            iterator->leaf = iterator->leaf->next;
+            iterator->index = 0;
+        }
+        else {
+            break;
+        }
+    }
+
+    if(iterator->leaf == NULL || !iterator->bounded)
+        return;
+
+    int comparison = iterator->map->compare(iterator->leaf->node.keys[iterator->index], iterator->bound);
+
+    if(iterator->reverse ? comparison < 0 : comparison > 0)
+        iterator->leaf = NULL;
+}
+
+
+/**
+ * @brief Checks whether a B+tree iterator has another key to return.
+ * 
+ * @param iterator - The iterator to check.
+ * 
+ * @returns 1 if next can be called, 0 if the end of the range was reached.
+ */
+int btree_iterator_has_next(struct BTreeIterator* iterator) {
+    return iterator->leaf != NULL;
+}
+
+
+/**
+ * @brief Moves a B+tree iterator to the next key in its range, stores that
+ * key in the iterator's key, and returns the key's value.
+ * 
+ * @remark This function will crash the program upon trying to move past the
+ * end of the range. The map must not be changed while it is iterated over.
+ * 
+ * @param iterator - The iterator to move.
+ * 
+ * @returns void* to the value of the next key.
+ */
+void* btree_iterator_next(struct BTreeIterator* iterator) {
+
+    assertf(iterator->leaf != NULL, "Tried to iterate past the end of a B+Tree Map.\n");
+
+    struct BTreeLeaf* leaf = iterator->leaf;
+    int index = iterator->index;
+
+    iterator->key = leaf->node.keys[index];
+    iterator->index += iterator->reverse ? -1 : 1;
+
+    settle_btree_iterator(iterator);
+
+    return leaf->values[index];
+}
+
+
+/**
+ * @brief Returns a B+tree iterator starting at a given position, walking in a
+ * given direction up to an optional bound.
+ * 
+ * @param map - The map to iterate over.
+ * @param leaf - The leaf of the first key.
+ * @param index - The index of the first key in the leaf (which may be just
+ * off either end of it).
+ * @param bound - The last key the iterator may return.
+ * @param bounded - Whether to stop at bound.
+ * @param reverse - Whether to walk backwards.
+ * 
+ * @returns New iterator (by value, so that it can be kept on the stack).
+ */
+struct BTreeIterator make_btree_iterator(struct BTreeMap* map, struct BTreeLeaf* leaf, int index, void* bound, int bounded, int reverse) {
+
+    struct BTreeIterator iterator;
+
+    iterator.map = map;
+    iterator.leaf = leaf;
+    iterator.index = index;
+    iterator.key = NULL;
+    iterator.bound = bound;
+    iterator.bounded = bounded;
+    iterator.reverse = reverse;
+    iterator.has_next = btree_iterator_has_next;
+    iterator.next = btree_iterator_next;
+
+    settle_btree_iterator(&iterator);
+
+    return iterator;
+}
+
+
+/**
+ * @brief Returns an iterator over every key in a B+tree map, in increasing
+ * order.
+ * 
+ * @param map - The map to iterate over.
+ * 
+ * @returns New iterator (by value, so that it can be kept on the stack).
+ */
+struct BTreeIterator btree_begin(struct BTreeMap* map) {
+
+    assertf(map != NULL, "Tried to iterate over a NULL B+Tree Map.\n");
+
+    return make_btree_iterator(map, first_btree_leaf(map), 0, NULL, 0, 0);
+}
+
+
+/**
+ * @brief Returns an iterator over every key in a B+tree map, in decreasing
+ * order.
+ * 
+ * @param map - The map to iterate over.
+ * 
+ * @returns New iterator (by value, so that it can be kept on the stack).
+ */
+struct BTreeIterator btree_begin_reverse(struct BTreeMap* map) {
+
+    assertf(map != NULL, "Tried to iterate over a NULL B+Tree Map.\n");
+
+    struct BTreeNode* node = map->root;
+
+    while(!node->is_leaf) {
+        node = ((struct BTreeInternal*) node)->children[node->num_keys];
+    }
+
+    return make_btree_iterator(map, (struct BTreeLeaf*) node, node->num_keys - 1, NULL, 0, 1);
+}
+
+
+/**
+ * @brief Returns an iterator over the keys of a B+tree map from "from" to "to"
+ * (inclusive), in increasing order. Finding the first key is O(log n), and
+ * every key after it is O(1).
+ * 
+ * @param map - The map to iterate over.
+ * @param from - The smallest key to return.
+ * @param to - The biggest key to return.
+ * 
+ * @returns New iterator (by value, so that it can be kept on the stack).
+ */
+struct BTreeIterator btree_range(struct BTreeMap* map, void* from, void* to) {
+
+    assertf(map != NULL, "Tried to iterate over a NULL B+Tree Map.\n");
+
+    struct BTreeLeaf* leaf = find_btree_leaf(map, from);
+
+    return make_btree_iterator(map, leaf, btree_lower_bound(map, &leaf->node, from), to, 1, 0);
+}
+
+
+/**
+ * @brief Returns an iterator over the keys of a B+tree map from "to" down to
+ * "from" (inclusive), in decreasing order. Finding the first key is
+ * O(log n), and every key after it is O(1).
+ * 
+ * @param map - The map to iterate over.
+ * @param from - The smallest key to return.
+ * @param to - The biggest key to return.
+ * 
+ * @returns New iterator (by value, so that it can be kept on the stack).
+ */
+struct BTreeIterator btree_range_reverse(struct BTreeMap* map, void* from, void* to) {
+
+    assertf(map != NULL, "Tried to iterate over a NULL B+Tree Map.\n");
+
+    struct BTreeLeaf* leaf = find_btree_leaf(map, to);
+
+    return make_btree_iterator(map, leaf, btree_upper_bound(map, &leaf->node, to) - 1, from, 1, 1);
+}
+
+
+/**
+ * @brief Frees a B+tree map and all of its nodes, along with the keys and
+ * values owned by the map if auto_free is set (see btree_teardown and
+ * btree_teardown_keep).
+ * 
+ * @remark The keys in internal nodes are copies of keys in the leaves, so
+ * only the leaves are walked. The nodes themselves are freed along with the
+ * pools.
+ * 
+ * @param map - The map to tear down.
+ * @param auto_free - Whether to free the keys and values.
+ * 
+ * @returns 1 on success.
+ */
+int free_btree_map(struct BTreeMap* map, int auto_free) {
+
+    int free_keys = auto_free && map->free_keys;
+    int free_values = auto_free && map->free_values;
+
+    if(free_keys || free_values) {
+        for(struct BTreeLeaf* leaf = first_btree_leaf(map); leaf != NULL; leaf = leaf->next) {
+            for(int i = 0; i < leaf->node.num_keys; i++) {
+                if(leaf->node.keys[i] != NULL && free_keys)
+                    free(leaf->node.keys[i]);
+
+                if(leaf->values[i] != NULL && free_values)
+                    free(leaf->values[i]);
+            }
+        }
+    }
+
+    map->leaf_pool->teardown(map->leaf_pool);
+    map->internal_pool->teardown(map->internal_pool);
+
+    deallocate(map->allocator, map);
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees a B+tree map and everything it holds, including the keys and
+ * values owned by the map (see free_keys and free_values).
+ * 
+ * @param map - The map to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int btree_teardown(struct BTreeMap* map) {
+
+    return free_btree_map(map, 1);
+}
+
+
+/**
+ * @brief Frees a B+tree map and everything it holds, except for its keys and
+ * values.
+ * 
+ * @param map - The map to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int btree_teardown_keep(struct BTreeMap* map) {
+
+    return free_btree_map(map, 0);
+}
+
+
+/**
+ * @brief Checks whether a leaf of a radix tree holds a given key.
+ * 
+ * @param leaf - The leaf to check.
+ * @param key - The key to look for.
+ * @param key_length - The number of bytes in the key.
+ * 
+ * @returns 1 if the leaf's key is the same as key, 0 otherwise.
+ */
+int radix_leaf_matches(struct RadixLeaf* leaf, void* key, int key_length) {
+
+    return leaf->key_length == key_length && memcmp(leaf->key, key, key_length) == 0;
+}
+
+
+/**
+ * @brief Allocates a new leaf for a radix tree, holding a copy of a key and
+ * its value.
+ * 
+ * @param tree - The tree which the leaf will belong to.
+ * @param key - The key to copy into the leaf.
+ * @param key_length - The number of bytes in the key.
+ * @param value - The value of the key.
+ * 
+ * @returns NULL on failure (not enough heap to allocate leaf), pointer to the
+ * new leaf on success.
+ */
+struct RadixLeaf* allocate_radix_leaf(struct RadixTree* tree, void* key, int key_length, void* value) {
+
+    struct RadixLeaf* leaf = allocate(tree->allocator, sizeof(struct RadixLeaf) + key_length);
+
+    if(leaf == NULL)
+        return NULL;
+
+    leaf->type = RADIX_LEAF;
+    leaf->key_length = key_length;
+    leaf->value = value;
+
+    memcpy(leaf->key, key, key_length);
+
+    return leaf;
+}
+
+
+/**
+ * @brief Allocates a new, empty inner node of a given size for a radix tree,
+ * from the tree's pool for that size.
+ * 
+ * @param tree - The tree which the node will belong to.
+ * @param type - The size of node (RADIX_NODE4, RADIX_NODE16, RADIX_NODE48 or
+ * RADIX_NODE256).
+ * 
+ * @returns NULL on failure (not enough heap to allocate node), pointer to
+ * the new node on success.
+ */
+struct RadixNode* allocate_radix_node(struct RadixTree* tree, int type) {
+
+    struct NodePool* pool = tree->pools[type - 1];
+
+    struct RadixNode* node = pool->allocate(pool);
+
+    if(node == NULL)
+        return NULL;
+
+    node->type = type;
+    node->num_children = 0;
+    node->prefix_length = 0;
+    node->leaf = NULL;
+
+    if(type == RADIX_NODE48) {
+        memset(((struct RadixNode48*) node)->child_index, 0, 256);
+        memset(((struct RadixNode48*) node)->children, 0, 48 * sizeof(struct RadixNode*));
+    }
+    else if(type == RADIX_NODE256) {
+        memset(((struct RadixNode256*) node)->children, 0, 256 * sizeof(struct RadixNode*));
+    }
+
+    return node;
+}
+
+
+/**
+ * @brief Gives an inner node of a radix tree back to the pool it came from.
+ * 
+ * @param tree - The tree which the node belonged to.
+ * @param node - The node to free.
+ */
+void free_radix_node(struct RadixTree* tree, struct RadixNode* node) {
+
+    tree->pools[node->type - 1]->release(tree->pools[node->type - 1], node);
+}
+
+
+/**
+ * @brief Copies the header of an inner node of a radix tree (its prefix, its
+ * leaf, and its number of children) into a node of another size, which is
+ * replacing it.
+ * 
+ * @param destination - The new node.
+ * @param source - The node being replaced.
+ */
+void copy_radix_header(struct RadixNode* destination, struct RadixNode* source) {
+
+    destination->num_children = source->num_children;
+    destination->prefix_length = source->prefix_length;
+    destination->leaf = source->leaf;
+
+    memcpy(destination->prefix, source->prefix, RADIX_MAX_PREFIX);
+}
+
+
+/**
+ * @brief Finds the child of an inner node of a radix tree for a given byte.
+ * Node16 compares the byte with all of its keys at once using SSE2, when it
+ * is available.
+ * 
+ * @param node - The node to search.
+ * @param byte - The byte to find the child for.
+ * 
+ * @returns NULL if the node has no child for the byte, pointer to the slot
+ * holding the child otherwise (so that the child can be replaced).
+ */
+struct RadixNode** find_radix_child(struct RadixNode* node, unsigned char byte) {
+
+    switch(node->type) {
+        case RADIX_NODE4: {
+            struct RadixNode4* node4 = (struct RadixNode4*) node;
+
+            for(int i = 0; i < node->num_children; i++) {
+                if(node4->keys[i] == byte)
+                    return &node4->children[i];
+            }
+
+            return NULL;
+        }
+
+        case RADIX_NODE16: {
+            struct RadixNode16* node16 = (struct RadixNode16*) node;
+
+            #ifdef __SSE2__
+                __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8((char) byte), _mm_loadu_si128((__m128i*) node16->keys));
+
+                int mask = _mm_movemask_epi8(matches) & ((1 << node->num_children) - 1);
+
+                return mask != 0 ? &node16->children[__builtin_ctz(mask)] : NULL;
+            #else
+                for(int i = 0; i < node->num_children; i++) {
+                    if(node16->keys[i] == byte)
+                        return &node16->children[i];
+                }
+
+                return NULL;
+            #endif
+        }
+
+        case RADIX_NODE48: {
+            struct RadixNode48* node48 = (struct RadixNode48*) node;
+
+            int index = node48->child_index[byte];
+
+            return index != 0 ? &node48->children[index - 1] : NULL;
+        }
+
+        default: {
+            struct RadixNode256* node256 = (struct RadixNode256*) node;
+
+            return node256->children[byte] != NULL ? &node256->children[byte] : NULL;
+        }
+    }
+}
+
+
+/**
+ * @brief Finds where a byte belongs in the sorted keys of a Node16 of a radix
+ * tree (using SSE2 to compare it with all of the keys at once, when it is
+ * available).
+ * 
+ * @param node16 - The node to search.
+ * @param byte - The byte to place.
+ * 
+ * @returns The index of the first key bigger than byte (num_children if there
+ * is none).
+ */
+int radix_node16_position(struct RadixNode16* node16, unsigned char byte) {
+
+    #ifdef __SSE2__
+        // SSE2 only compares signed bytes, so flip the top bit of both sides
+        // to compare them as unsigned bytes
+        __m128i flip = _mm_set1_epi8((char) 0x80);
+        __m128i bigger = _mm_cmplt_epi8(_mm_xor_si128(_mm_set1_epi8((char) byte), flip), _mm_xor_si128(_mm_loadu_si128((__m128i*) node16->keys), flip));
+
+        int mask = _mm_movemask_epi8(bigger) & ((1 << node16->node.num_children) - 1);
+
+        return mask != 0 ? __builtin_ctz(mask) : node16->node.num_children;
+    #else
+        int position = 0;
+
+        while(position < node16->node.num_children && node16->keys[position] < byte)
+            position++;
+
+        return position;
+    #endif
+}
+
+
+/**
+ * @brief Adds a child for a new byte to an inner node of a radix tree. If the
+ * node is full, it is replaced by a node of the next size up first.
+ * 
+ * @param tree - The tree which the node belongs to.
+ * @param ref - The slot holding the node (which is updated if the node is
+ * replaced).
+ * @param byte - The byte of the new child, which the node must not have a
+ * child for yet.
+ * @param child - The new child.
+ * 
+ * @returns 0 on failure (not enough heap to grow node), 1 on success. On
+ * failure, the node is left as it was.
+ */
+int add_radix_child(struct RadixTree* tree, struct RadixNode** ref, unsigned char byte, struct RadixNode* child) {
+
+    struct RadixNode* node = *ref;
+
+    switch(node->type) {
+        case RADIX_NODE4: {
+            struct RadixNode4* node4 = (struct RadixNode4*) node;
+
+            if(node->num_children == 4) {
+                struct RadixNode16* node16 = (struct RadixNode16*) allocate_radix_node(tree, RADIX_NODE16);
+
+                if(node16 == NULL)
+                    return 0;
+
+                copy_radix_header(&node16->node, node);
+                memcpy(node16->keys, node4->keys, 4);
+                memcpy(node16->children, node4->children, 4 * sizeof(struct RadixNode*));
+
+                free_radix_node(tree, node);
+                *ref = &node16->node;
+
+                return add_radix_child(tree, ref, byte, child);
+            }
+
+            int position = 0;
+
+            while(position < node->num_children && node4->keys[position] < byte)
+                position++;
+
+            memmove(node4->keys + position + 1, node4->keys + position, node->num_children - position);
+            memmove(node4->children + position + 1, node4->children + position, (node->num_children - position) * sizeof(struct RadixNode*));
+
+            node4->keys[position] = byte;
+            node4->children[position] = child;
+            node->num_children++;
+
+            return 1;
+        }
+
+        case RADIX_NODE16: {
+            struct RadixNode16* node16 = (struct RadixNode16*) node;
+
+            if(node->num_children == 16) {
+                struct RadixNode48* node48 = (struct RadixNode48*) allocate_radix_node(tree, RADIX_NODE48);
+
+                if(node48 == NULL)
+                    return 0;
+
+                copy_radix_header(&node48->node, node);
+
+                for(int i = 0; i < 16; i++) {
+                    node48->child_index[node16->keys[i]] = i + 1;
+                    node48->children[i] = node16->children[i];
+                }
+
+                free_radix_node(tree, node);
+                *ref = &node48->node;
+
+                return add_radix_child(tree, ref, byte, child);
+            }
+
+            int position = radix_node16_position(node16, byte);
+
+            memmove(node16->keys + position + 1, node16->keys + position, node->num_children - position);
+            memmove(node16->children + position + 1, node16->children + position, (node->num_children - position) * sizeof(struct RadixNode*));
+
+            node16->keys[position] = byte;
+            node16->children[position] = child;
+            node->num_children++;
+
+            return 1;
+        }
+
+        case RADIX_NODE48: {
+            struct RadixNode48* node48 = (struct RadixNode48*) node;
+
+            if(node->num_children == 48) {
+                struct RadixNode256* node256 = (struct RadixNode256*) allocate_radix_node(tree, RADIX_NODE256);
+
+                if(node256 == NULL)
+                    return 0;
+
+                copy_radix_header(&node256->node, node);
+
+                for(int i = 0; i < 256; i++) {
+                    if(node48->child_index[i] != 0)
+                        node256->children[i] = node48->children[node48->child_index[i] - 1];
+                }
+
+                free_radix_node(tree, node);
+                *ref = &node256->node;
+
+                return add_radix_child(tree, ref, byte, child);
+            }
+
+            // Take the first free slot (freed slots are set back to NULL)
+            int slot = 0;
+
+            while(node48->children[slot] != NULL)
+                slot++;
+
+            node48->children[slot] = child;
+            node48->child_index[byte] = slot + 1;
+            node->num_children++;
+
+            return 1;
+        }
+
+        default: {
+            ((struct RadixNode256*) node)->children[byte] = child;
+            node->num_children++;
+
+            return 1;
+        }
+    }
+}
+
+
+/**
+ * @brief Takes the child for a byte out of an inner node of a radix tree. If
+ * the node gets small enough, it is replaced by a node of the next size
+ * down (unless that cannot be allocated, in which case it is left as it
+ * is).
+ * 
+ * @param tree - The tree which the node belongs to.
+ * @param ref - The slot holding the node (which is updated if the node is
+ * replaced).
+ * @param byte - The byte of the child to take out, which must exist.
+ */
+void remove_radix_child(struct RadixTree* tree, struct RadixNode** ref, unsigned char byte) {
+
+    struct RadixNode* node = *ref;
+
+    switch(node->type) {
+        case RADIX_NODE4: {
+            struct RadixNode4* node4 = (struct RadixNode4*) node;
+
+            int position = (int) (find_radix_child(node, byte) - node4->children);
+
+            memmove(node4->keys + position, node4->keys + position + 1, node->num_children - position - 1);
+            memmove(node4->children + position, node4->children + position + 1, (node->num_children - position - 1) * sizeof(struct RadixNode*));
+
+            node->num_children--;
+
+            break;
+        }
+
+        case RADIX_NODE16: {
+            struct RadixNode16* node16 = (struct RadixNode16*) node;
+
+            int position = (int) (find_radix_child(node, byte) - node16->children);
+
+            memmove(node16->keys + position, node16->keys + position + 1, node->num_children - position - 1);
+            memmove(node16->children + position, node16->children + position + 1, (node->num_children - position - 1) * sizeof(struct RadixNode*));
+
+            node->num_children--;
+
+            if(node->num_children <= 3) {
+                struct RadixNode4* node4 = (struct RadixNode4*) allocate_radix_node(tree, RADIX_NODE4);
+
+                if(node4 == NULL)
+                    break;
+
+                copy_radix_header(&node4->node, node);
+                memcpy(node4->keys, node16->keys, node->num_children);
+                memcpy(node4->children, node16->children, node->num_children * sizeof(struct RadixNode*));
+
+                free_radix_node(tree, node);
+                *ref = &node4->node;
+            }
+
+            break;
+        }
+
+        case RADIX_NODE48: {
+            struct RadixNode48* node48 = (struct RadixNode48*) node;
+
+            node48->children[node48->child_index[byte] - 1] = NULL;
+            node48->child_index[byte] = 0;
+
+            node->num_children--;
+
+            if(node->num_children <= 12) {
+                struct RadixNode16* node16 = (struct RadixNode16*) allocate_radix_node(tree, RADIX_NODE16);
+
+                if(node16 == NULL)
+                    break;
+
+                copy_radix_header(&node16->node, node);
+
+                // Walking the bytes in order keeps the keys sorted
+                int position = 0;
+
+                for(int i = 0; i < 256; i++) {
+                    if(node48->child_index[i] != 0) {
+                        node16->keys[position] = i;
+                        node16->children[position] = node48->children[node48->child_index[i] - 1];
+                        position++;
+                    }
+                }
+
+                free_radix_node(tree, node);
+                *ref = &node16->node;
+            }
+
+            break;
+        }
+
+        default: {
+            struct RadixNode256* node256 = (struct RadixNode256*) node;
+
+            node256->children[byte] = NULL;
+
+            node->num_children--;
+
+            if(node->num_children <= 37) {
+                struct RadixNode48* node48 = (struct RadixNode48*) allocate_radix_node(tree, RADIX_NODE48);
+
+                if(node48 == NULL)
+                    break;
+
+                copy_radix_header(&node48->node, node);
+
+                int slot = 0;
+
+                for(int i = 0; i < 256; i++) {
+                    if(node256->children[i] != NULL) {
+                        node48->children[slot] = node256->children[i];
+                        node48->child_index[i] = slot + 1;
+                        slot++;
+                    }
+                }
+
+                free_radix_node(tree, node);
+                *ref = &node48->node;
+            }
+
+            break;
+        }
+    }
+}
+
+
+/**
+ * @brief Returns the leaf with the smallest key under a node of a radix tree.
+ * Every leaf under a node shares its whole prefix, so this is used to find
+ * the bytes of prefixes longer than RADIX_MAX_PREFIX.
+ * 
+ * @param node - The node to start from, which must have keys under it.
+ * 
+ * @returns Pointer to the leaf.
+ */
+struct RadixLeaf* radix_minimum_leaf(struct RadixNode* node) {
+
+    while(node->type != RADIX_LEAF) {
+
+        if(node->leaf != NULL)
+            return node->leaf;
+
+        switch(node->type) {
+            case RADIX_NODE4:
+                node = ((struct RadixNode4*) node)->children[0];
+                break;
+
+            case RADIX_NODE16:
+                node = ((struct RadixNode16*) node)->children[0];
+                break;
+
+            case RADIX_NODE48: {
+                struct RadixNode48* node48 = (struct RadixNode48*) node;
+
+                int i = 0;
+
+                while(node48->child_index[i] == 0)
+                    i++;
+
+                node = node48->children[node48->child_index[i] - 1];
+                break;
+            }
+
+            default: {
+                struct RadixNode256* node256 = (struct RadixNode256*) node;
+
+                int i = 0;
+
+                while(node256->children[i] == NULL)
+                    i++;
+
+                node = node256->children[i];
+                break;
+            }
+        }
+    }
+
+    return (struct RadixLeaf*) node;
+}
+
+
+/**
+ * @brief Checks the stored bytes of an inner node's prefix against a key, and
+ * skips over any bytes past RADIX_MAX_PREFIX (the key must later be checked
+ * against a leaf's whole key).
+ * 
+ * @param node - The inner node whose prefix will be checked.
+ * @param key - The key to check.
+ * @param key_length - The number of bytes in the key.
+ * @param depth - The index in the key where the node's prefix starts.
+ * 
+ * @returns 1 if the key may have the node's prefix, 0 if it does not.
+ */
+int radix_prefix_matches(struct RadixNode* node, unsigned char* key, int key_length, int depth) {
+
+    if(depth + node->prefix_length > key_length)
+        return 0;
+
+    int num_stored = node->prefix_length < RADIX_MAX_PREFIX ? node->prefix_length : RADIX_MAX_PREFIX;
+
+    return memcmp(node->prefix, key + depth, num_stored) == 0;
+}
+
+
+/**
+ * @brief Finds how many bytes of an inner node's whole prefix a key shares,
+ * reading bytes past RADIX_MAX_PREFIX from the node's smallest leaf.
+ * 
+ * @param node - The inner node whose prefix will be checked.
+ * @param key - The key to check.
+ * @param key_length - The number of bytes in the key.
+ * @param depth - The index in the key where the node's prefix starts.
+ * 
+ * @returns The number of bytes the prefix and key have in common (from
+ * depth on).
+ */
+int radix_prefix_mismatch(struct RadixNode* node, unsigned char* key, int key_length, int depth) {
+
+    int max_length = node->prefix_length < key_length - depth ? node->prefix_length : key_length - depth;
+
+    int i = 0;
+
+    while(i < max_length && i < RADIX_MAX_PREFIX && node->prefix[i] == key[depth + i])
+        i++;
+
+    if(i == RADIX_MAX_PREFIX && i < max_length) {
+        struct RadixLeaf* leaf = radix_minimum_leaf(node);
+
+        while(i < max_length && leaf->key[depth + i] == key[depth + i])
+            i++;
+    }
+
+    return i;
+}
+
+
+/**
+ * @brief Adds a key with a value to a radix tree, or replaces the value of a
+ * key already in the tree (freeing the replaced value if it is owned by
+ * the tree, see free_values). This is O(key length).
+ * 
+ * @remark When a new key splits an inner node's prefix, or a leaf, a Node4 is
+ * put in their place to branch on the first byte that differs.
+ * 
+ * @param tree - The tree to add the key to.
+ * @param key - The key to add (which is copied into the tree).
+ * @param key_length - The number of bytes in the key.
+ * @param value - The value of the key.
+ * 
+ * @returns 0 on failure (not enough heap to allocate leaf or nodes), 1 on
+ * success.
+ */
+int radix_put(struct RadixTree* tree, void* key, int key_length, void* value) {
+
+    assertf(tree != NULL, "Tried to put a key into a NULL Radix Tree.\n");
+
+    assertf(key_length >= 0, "Tried to put a key of length %d into a Radix Tree.\n", key_length);
+
+    unsigned char* bytes = key;
+
+    struct RadixNode** ref = &tree->root;
+    int depth = 0;
+
+    while(*ref != NULL) {
+
+        struct RadixNode* node = *ref;
+
+        if(node->type == RADIX_LEAF) {
+
+            struct RadixLeaf* old_leaf = (struct RadixLeaf*) node;
+
+            // Replace the value if the key is already in the tree
+            if(radix_leaf_matches(old_leaf, key, key_length)) {
+                if(old_leaf->value != value && old_leaf->value != NULL && tree->free_values)
+                    free(old_leaf->value);
+
+                old_leaf->value = value;
+
+                return 1;
+            }
+
+            // Otherwise, branch on the first byte where the keys differ
+            struct RadixLeaf* leaf = allocate_radix_leaf(tree, key, key_length, value);
+            struct RadixNode* node4 = allocate_radix_node(tree, RADIX_NODE4);
+
+            if(leaf == NULL || node4 == NULL) {
+                deallocate(tree->allocator, leaf);
+
+                if(node4 != NULL)
+                    free_radix_node(tree, node4);
+
+                return 0;
+            }
+
+            int common = depth;
+
+            while(common < key_length && common < old_leaf->key_length && bytes[common] == old_leaf->key[common])
+                common++;
+
+            node4->prefix_length = common - depth;
+            memcpy(node4->prefix, bytes + depth, node4->prefix_length < RADIX_MAX_PREFIX ? node4->prefix_length : RADIX_MAX_PREFIX);
+
+            if(old_leaf->key_length == common)
+                node4->leaf = old_leaf;
+            else
+                add_radix_child(tree, &node4, old_leaf->key[common], node);
+
+            if(key_length == common)
+                node4->leaf = leaf;
+            else
+                add_radix_child(tree, &node4, bytes[common], (struct RadixNode*) leaf);
+
+            *ref = node4;
+            tree->length++;
+
+            return 1;
+        }
+
+        if(node->prefix_length > 0) {
+
+            int common = radix_prefix_mismatch(node, bytes, key_length, depth);
+
+            // If the key leaves the prefix part way through, split the
+            // prefix in two around a new Node4
+            if(common < node->prefix_length) {
+                struct RadixLeaf* leaf = allocate_radix_leaf(tree, key, key_length, value);
+                struct RadixNode* node4 = allocate_radix_node(tree, RADIX_NODE4);
+
+                if(leaf == NULL || node4 == NULL) {
+                    deallocate(tree->allocator, leaf);
+
+                    if(node4 != NULL)
+                        free_radix_node(tree, node4);
+
+                    return 0;
+                }
+
+                node4->prefix_length = common;
+                memcpy(node4->prefix, node->prefix, common < RADIX_MAX_PREFIX ? common : RADIX_MAX_PREFIX);
+
+                // The node keeps the rest of its prefix, after the byte it
+                // now hangs from
+                unsigned char edge;
+
+                if(node->prefix_length <= RADIX_MAX_PREFIX) {
+                    edge = node->prefix[common];
+                    node->prefix_length -= common + 1;
+
+                    memmove(node->prefix, node->prefix + common + 1, node->prefix_length);
+                }
+                else {
+                    struct RadixLeaf* minimum = radix_minimum_leaf(node);
+
+                    edge = minimum->key[depth + common];
+                    node->prefix_length -= common + 1;
+
+                    memcpy(node->prefix, minimum->key + depth + common + 1, node->prefix_length < RADIX_MAX_PREFIX ? node->prefix_length : RADIX_MAX_PREFIX);
+                }
+
+                add_radix_child(tree, &node4, edge, node);
+
+                if(key_length == depth + common)
+                    node4->leaf = leaf;
+                else
+                    add_radix_child(tree, &node4, bytes[depth + common], (struct RadixNode*) leaf);
+
+                *ref = node4;
+                tree->length++;
+
+                return 1;
+            }
+
+            depth += node->prefix_length;
+        }
+
+        // A key which ends here goes in the node's own leaf
+        if(depth == key_length) {
+            if(node->leaf != NULL) {
+                if(node->leaf->value != value && node->leaf->value != NULL && tree->free_values)
+                    free(node->leaf->value);
+
+                node->leaf->value = value;
+
+                return 1;
+            }
+
+            node->leaf = allocate_radix_leaf(tree, key, key_length, value);
+
+            if(node->leaf == NULL)
+                return 0;
+
+            tree->length++;
+
+            return 1;
+        }
+
+        struct RadixNode** child = find_radix_child(node, bytes[depth]);
+
+        if(child == NULL) {
+            struct RadixLeaf* leaf = allocate_radix_leaf(tree, key, key_length, value);
+
+            if(leaf == NULL)
+                return 0;
+
+            if(!add_radix_child(tree, ref, bytes[depth], (struct RadixNode*) leaf)) {
+                deallocate(tree->allocator, leaf);
+                return 0;
+            }
+
+            tree->length++;
+
+            return 1;
+        }
+
+        ref = child;
+        depth++;
+    }
+
+    struct RadixLeaf* leaf = allocate_radix_leaf(tree, key, key_length, value);
+
+    if(leaf == NULL)
+        return 0;
+
+    *ref = (struct RadixNode*) leaf;
+    tree->length++;
+
+    return 1;
+}
+
+
+/**
+ * @brief Finds the leaf holding a key in a radix tree, in O(key length).
+ * 
+ * @param tree - The tree to search.
+ * @param key - The key to find.
+ * @param key_length - The number of bytes in the key.
+ * 
+ * @returns NULL if the key is not in the tree, pointer to its leaf otherwise.
+ */
+struct RadixLeaf* find_radix_leaf(struct RadixTree* tree, void* key, int key_length) {
+
+    unsigned char* bytes = key;
+
+    struct RadixNode* node = tree->root;
+    int depth = 0;
+
+    while(node != NULL && node->type != RADIX_LEAF) {
+
+        if(!radix_prefix_matches(node, bytes, key_length, depth))
+            return NULL;
+
+        depth += node->prefix_length;
+
+        if(depth == key_length) {
+            node = (struct RadixNode*) node->leaf;
+            break;
+        }
+
+        struct RadixNode** child = find_radix_child(node, bytes[depth]);
+
+        if(child == NULL)
+            return NULL;
+
+        node = *child;
+        depth++;
+    }
+
+    // Prefix bytes past RADIX_MAX_PREFIX were skipped, so check the whole key
+    if(node == NULL || !radix_leaf_matches((struct RadixLeaf*) node, key, key_length))
+        return NULL;
+
+    return (struct RadixLeaf*) node;
+}
+
+
+/**
+ * @brief Returns the value, a void pointer, of a key in a radix tree. If the
+ * key is not in the tree, returns a default value instead.
+ * 
+ * @param tree - The tree to get the value from.
+ * @param key - The key whose value will be obtained.
+ * @param key_length - The number of bytes in the key.
+ * @param _default - A default value to return if the key is not in the tree.
+ * 
+ * @returns A void pointer to the value of the key, default otherwise.
+ */
+void* radix_get_or_default(struct RadixTree* tree, void* key, int key_length, void* _default) {
+
+    assertf(tree != NULL, "Tried to get data from a NULL Radix Tree.\n");
+
+    struct RadixLeaf* leaf = find_radix_leaf(tree, key, key_length);
+
+    return leaf != NULL ? leaf->value : _default;
+}
+
+
+/**
+ * @brief Returns the value, a void pointer, of a key in a radix tree.
+ * 
+ * @param tree - The tree to get the value from.
+ * @param key - The key whose value will be obtained.
+ * @param key_length - The number of bytes in the key.
+ * 
+ * @returns NULL if the key is not in the tree, void* to its value otherwise.
+ */
+void* radix_get(struct RadixTree* tree, void* key, int key_length) {
+
+    return radix_get_or_default(tree, key, key_length, NULL);
+}
+
+
+/**
+ * @brief Tidies up a Node4 of a radix tree after a key was removed from it. A
+ * Node4 left with no children is replaced by its own leaf, and one left
+ * with a single child (and no leaf) is replaced by that child, whose prefix
+ * grows to take in the Node4's prefix and the byte between them.
+ * 
+ * @param tree - The tree which the node belongs to.
+ * @param ref - The slot holding the node (which is updated if the node is
+ * replaced).
+ */
+void compact_radix_node(struct RadixTree* tree, struct RadixNode** ref) {
+
+    struct RadixNode* node = *ref;
+
+    if(node->type != RADIX_NODE4)
+        return;
+
+    struct RadixNode4* node4 = (struct RadixNode4*) node;
+
+    if(node->num_children == 0) {
+        *ref = (struct RadixNode*) node->leaf;
+    }
+    else if(node->num_children == 1 && node->leaf == NULL) {
+        struct RadixNode* child = node4->children[0];
+
+        if(child->type != RADIX_LEAF) {
+
+            // Only the first RADIX_MAX_PREFIX bytes of the joined prefix are
+            // stored, and those all come from stored bytes
+            unsigned char prefix[RADIX_MAX_PREFIX];
+            int length = node->prefix_length < RADIX_MAX_PREFIX ? node->prefix_length : RADIX_MAX_PREFIX;
+
+            memcpy(prefix, node->prefix, length);
+
+            if(length < RADIX_MAX_PREFIX)
+                prefix[length++] = node4->keys[0];
+
+            int num_from_child = RADIX_MAX_PREFIX - length < child->prefix_length ? RADIX_MAX_PREFIX - length : child->prefix_length;
+
+            memcpy(prefix + length, child->prefix, num_from_child);
+            memcpy(child->prefix, prefix, length + num_from_child);
+
+            child->prefix_length += node->prefix_length + 1;
+        }
+
+        *ref = child;
+    }
+    else {
+        return;
+    }
+
+    free_radix_node(tree, node);
+}
+
+
+/**
+ * @brief Removes a key from under a node of a radix tree, and tidies up the
+ * nodes on the way back up.
+ * 
+ * @param tree - The tree which the nodes belong to.
+ * @param ref - The slot holding the node to remove the key from under.
+ * @param key - The key to remove.
+ * @param key_length - The number of bytes in the key.
+ * @param depth - The index in the key where the node's prefix starts.
+ * 
+ * @returns NULL if the key is not in the tree, pointer to the leaf which was
+ * taken out of the tree otherwise (which the caller frees).
+ */
+struct RadixLeaf* remove_from_radix_node(struct RadixTree* tree, struct RadixNode** ref, unsigned char* key, int key_length, int depth) {
+
+    struct RadixNode* node = *ref;
+
+    if(node->type == RADIX_LEAF) {
+        if(!radix_leaf_matches((struct RadixLeaf*) node, key, key_length))
+            return NULL;
+
+        *ref = NULL;
+
+        return (struct RadixLeaf*) node;
+    }
+
+    if(!radix_prefix_matches(node, key, key_length, depth))
+        return NULL;
+
+    depth += node->prefix_length;
+
+    if(depth == key_length) {
+        struct RadixLeaf* leaf = node->leaf;
+
+        if(leaf == NULL || !radix_leaf_matches(leaf, key, key_length))
+            return NULL;
+
+        node->leaf = NULL;
+
+        compact_radix_node(tree, ref);
+
+        return leaf;
+    }
+
+    struct RadixNode** child = find_radix_child(node, key[depth]);
+
+    if(child == NULL)
+        return NULL;
+
+    struct RadixLeaf* leaf = remove_from_radix_node(tree, child, key, key_length, depth + 1);
+
+    // Only a leaf child is ever removed outright (inner nodes are replaced
+    // by what is left of them)
+    if(leaf != NULL && *child == NULL) {
+        remove_radix_child(tree, ref, key[depth]);
+        compact_radix_node(tree, ref);
+    }
+
+    return leaf;
+}
+
+
+/**
+ * @brief Removes a key and its value from a radix tree in O(key length),
+ * freeing the value if it is owned by the tree and auto_free is set (see
+ * radix_remove and radix_remove_keep).
+ * 
+ * @param tree - The tree to remove the key from.
+ * @param key - The key to remove.
+ * @param key_length - The number of bytes in the key.
+ * @param auto_free - Whether to free the value.
+ * 
+ * @returns 0 on failure (key is not in tree), 1 on success.
+ */
+int radix_remove_entry(struct RadixTree* tree, void* key, int key_length, int auto_free) {
+
+    assertf(tree != NULL, "Tried to remove a key from a NULL Radix Tree.\n");
+
+    if(tree->root == NULL)
+        return 0;
+
+    struct RadixLeaf* leaf = remove_from_radix_node(tree, &tree->root, key, key_length, 0);
+
+    if(leaf == NULL)
+        return 0;
+
+    if(leaf->value != NULL && auto_free && tree->free_values)
+        free(leaf->value);
+
+    deallocate(tree->allocator, leaf);
+
+    tree->length--;
+
+    return 1;
+}
+
+
+/**
+ * @brief Removes a key and its value from a radix tree, freeing the value if
+ * it is owned by the tree (see free_values).
+ * 
+ * @param tree - The tree to remove the key from.
+ * @param key - The key to remove.
+ * @param key_length - The number of bytes in the key.
+ * 
+ * @returns 0 on failure (key is not in tree), 1 on success.
+ */
+int radix_remove(struct RadixTree* tree, void* key, int key_length) {
+
+    return radix_remove_entry(tree, key, key_length, 1);
+}
+
+
+/**
+ * @brief Removes a key and its value from a radix tree, without freeing the
+ * value.
+ * 
+ * @param tree - The tree to remove the key from.
+ * @param key - The key to remove.
+ * @param key_length - The number of bytes in the key.
+ * 
+ * @returns 0 on failure (key is not in tree), 1 on success.
+ */
+int radix_remove_keep(struct RadixTree* tree, void* key, int key_length) {
+
+    return radix_remove_entry(tree, key, key_length, 0);
+}
+
+
+/**
+ * @brief Finds the longest key in a radix tree which is a prefix of a given
+ * key (or the key itself), in O(key length). Every key found along the path
+ * down to the key is a prefix of it, so the last one found is the longest.
+ * 
+ * @param tree - The tree to search.
+ * @param key - The key to find the longest prefix of.
+ * @param key_length - The number of bytes in the key.
+ * @param match_length - Where to store the length of the prefix that was
+ * found (may be NULL).
+ * 
+ * @returns NULL if no key in the tree is a prefix of key, void* to the value
+ * of the longest one otherwise.
+ */
+void* radix_longest_prefix(struct RadixTree* tree, void* key, int key_length, int* match_length) {
+
+    assertf(tree != NULL, "Tried to search a NULL Radix Tree.\n");
+
+    unsigned char* bytes = key;
+
+    struct RadixNode* node = tree->root;
+    struct RadixLeaf* longest = NULL;
+    int depth = 0;
+
+    // Prefix bytes past RADIX_MAX_PREFIX are skipped, so every leaf is
+    // checked against the key before it is taken
+    while(node != NULL) {
+
+        if(node->type == RADIX_LEAF) {
+            struct RadixLeaf* leaf = (struct RadixLeaf*) node;
+
+            if(leaf->key_length <= key_length && memcmp(leaf->key, bytes, leaf->key_length) == 0)
+                longest = leaf;
+
+            break;
+        }
+
+        if(!radix_prefix_matches(node, bytes, key_length, depth))
+            break;
+
+        depth += node->prefix_length;
+
+        if(node->leaf != NULL && memcmp(node->leaf->key, bytes, node->leaf->key_length) == 0)
+            longest = node->leaf;
+
+        if(depth == key_length)
+            break;
+
+        struct RadixNode** child = find_radix_child(node, bytes[depth]);
+
+        node = child != NULL ? *child : NULL;
+        depth++;
+    }
+
+    if(longest == NULL)
+        return NULL;
+
+    if(match_length != NULL)
+        *match_length = longest->key_length;
+
+    return longest->value;
+}
+
+
+/**
+ * @brief Calls fn on every key under a node of a radix tree which starts with
+ * a given prefix, in order (the node's own leaf first, and then its
+ * children by byte).
+ * 
+ * @param node - The node to start from.
+ * @param prefix - The prefix which keys must start with.
+ * @param prefix_length - The number of bytes in the prefix.
+ * @param fn - The function to call with each key, its length, its value, and
+ * ctx.
+ * @param ctx - Passed along to every call to fn.
+ * 
+ * @returns The number of keys fn was called on.
+ */
+int radix_foreach_under(struct RadixNode* node, unsigned char* prefix, int prefix_length, void (*fn)(void*, int, void*, void*), void* ctx) {
+
+    if(node->type == RADIX_LEAF) {
+        struct RadixLeaf* leaf = (struct RadixLeaf*) node;
+
+        if(leaf->key_length < prefix_length || memcmp(leaf->key, prefix, prefix_length) != 0)
+            return 0;
+
+        fn(leaf->key, leaf->key_length, leaf->value, ctx);
+
+        return 1;
+    }
+
+    int count = 0;
+
+    if(node->leaf != NULL)
+        count += radix_foreach_under((struct RadixNode*) node->leaf, prefix, prefix_length, fn, ctx);
+
+    switch(node->type) {
+        case RADIX_NODE4:
+            for(int i = 0; i < node->num_children; i++)
+                count += radix_foreach_under(((struct RadixNode4*) node)->children[i], prefix, prefix_length, fn, ctx);
+            break;
+
+        case RADIX_NODE16:
+            for(int i = 0; i < node->num_children; i++)
+                count += radix_foreach_under(((struct RadixNode16*) node)->children[i], prefix, prefix_length, fn, ctx);
+            break;
+
+        case RADIX_NODE48: {
+            struct RadixNode48* node48 = (struct RadixNode48*) node;
+
+            for(int i = 0; i < 256; i++) {
+                if(node48->child_index[i] != 0)
+                    count += radix_foreach_under(node48->children[node48->child_index[i] - 1], prefix, prefix_length, fn, ctx);
+            }
+            break;
+        }
+
+        default: {
+            struct RadixNode256* node256 = (struct RadixNode256*) node;
+
+            for(int i = 0; i < 256; i++) {
+                if(node256->children[i] != NULL)
+                    count += radix_foreach_under(node256->children[i], prefix, prefix_length, fn, ctx);
+            }
+            break;
+        }
+    }
+
+    return count;
+}
+
+
+/**
+ * @brief Calls fn on every key in a radix tree which starts with a given
+ * prefix, in order. The node holding every such key is found in
+ * O(prefix length), and the keys under it are then visited without
+ * searching.
+ * 
+ * @remark The tree must not be changed by fn.
+ * 
+ * @param tree - The tree to search.
+ * @param prefix - The prefix which keys must start with.
+ * @param prefix_length - The number of bytes in the prefix (0 visits every
+ * key).
+ * @param fn - The function to call with each key, its length, its value, and
+ * ctx.
+ * @param ctx - Passed along to every call to fn.
+ * 
+ * @returns The number of keys fn was called on.
+ */
+int radix_prefix_foreach(struct RadixTree* tree, void* prefix, int prefix_length, void (*fn)(void*, int, void*, void*), void* ctx) {
+
+    assertf(tree != NULL, "Tried to search a NULL Radix Tree.\n");
+
+    unsigned char* bytes = prefix;
+
+    struct RadixNode* node = tree->root;
+    int depth = 0;
+
+    // Walk down until the prefix runs out. Prefix bytes past
+    // RADIX_MAX_PREFIX are skipped, so keys are checked against the prefix
+    // as they are visited.
+    while(node != NULL && node->type != RADIX_LEAF) {
+
+        int num_checked = node->prefix_length < RADIX_MAX_PREFIX ? node->prefix_length : RADIX_MAX_PREFIX;
+
+        if(num_checked > prefix_length - depth)
+            num_checked = prefix_length - depth;
+
+        if(memcmp(node->prefix, bytes + depth, num_checked) != 0)
+            return 0;
+
+        if(depth + node->prefix_length >= prefix_length)
+            break;
+
+        depth += node->prefix_length;
+
+        struct RadixNode** child = find_radix_child(node, bytes[depth]);
+
+        node = child != NULL ? *child : NULL;
+        depth++;
+    }
+
+    if(node == NULL)
+        return 0;
+
+    return radix_foreach_under(node, bytes, prefix_length, fn, ctx);
+}
+
+
+/**
+ * @brief Frees every leaf under a node of a radix tree, along with their
+ * values if free_values is set. Inner nodes are freed along with the pools.
+ * 
+ * @param tree - The tree which the nodes belong to.
+ * @param node - The node to start from.
+ * @param free_values - Whether to free the values.
+ */
+void free_radix_leaves(struct RadixTree* tree, struct RadixNode* node, int free_values) {
+
+    if(node->type == RADIX_LEAF) {
+        struct RadixLeaf* leaf = (struct RadixLeaf*) node;
+
+        if(leaf->value != NULL && free_values)
+            free(leaf->value);
+
+        deallocate(tree->allocator, leaf);
+
+        return;
+    }
+
+    if(node->leaf != NULL)
+        free_radix_leaves(tree, (struct RadixNode*) node->leaf, free_values);
+
+    switch(node->type) {
+        case RADIX_NODE4:
+            for(int i = 0; i < node->num_children; i++)
+                free_radix_leaves(tree, ((struct RadixNode4*) node)->children[i], free_values);
+            break;
+
+        case RADIX_NODE16:
+            for(int i = 0; i < node->num_children; i++)
+                free_radix_leaves(tree, ((struct RadixNode16*) node)->children[i], free_values);
+            break;
+
+        case RADIX_NODE48:
+            for(int i = 0; i < 48; i++) {
+                if(((struct RadixNode48*) node)->children[i] != NULL)
+                    free_radix_leaves(tree, ((struct RadixNode48*) node)->children[i], free_values);
+            }
+            break;
+
+        default:
+            for(int i = 0; i < 256; i++) {
+                if(((struct RadixNode256*) node)->children[i] != NULL)
+                    free_radix_leaves(tree, ((struct RadixNode256*) node)->children[i], free_values);
+            }
+            break;
+    }
+}
+
+
+/**
+ * @brief Frees a radix tree, its nodes and its leaves, along with the values
+ * owned by the tree if auto_free is set (see radix_teardown and
+ * radix_teardown_keep).
+ * 
+ * @param tree - The tree to tear down.
+ * @param auto_free - Whether to free the values.
+ * 
+ * @returns 1 on success.
+ */
+int free_radix_tree(struct RadixTree* tree, int auto_free) {
+
+    if(tree->root != NULL)
+        free_radix_leaves(tree, tree->root, auto_free && tree->free_values);
+
+    for(int i = 0; i < 4; i++) {
+        tree->pools[i]->teardown(tree->pools[i]);
+    }
+
+    deallocate(tree->allocator, tree);
+
+    return 1;
+}
+
+
+/**
+ * @brief Frees a radix tree and everything it holds, including the values
+ * owned by the tree (see free_values).
+ * 
+ * @param tree - The tree to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int radix_teardown(struct RadixTree* tree) {
+
+    return free_radix_tree(tree, 1);
+}
+
+
+/**
+ * @brief Frees a radix tree and everything it holds, except for its values.
+ * 
+ * @param tree - The tree to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int radix_teardown_keep(struct RadixTree* tree) {
+
+    return free_radix_tree(tree, 0);
+}
+
+
+
+/**
+ * @brief Takes the index of the next chunk for a worker to run in a parallel
+ * job. Workers take chunks from the bottom of their own deque, and once it
+ * is empty, steal chunks from the top of the other workers' deques.
+ * 
+ * @param job - The job to take a chunk from.
+ * @param worker - The index of the worker taking the chunk.
+ * 
+ * @returns The index of the chunk, or -1 if every chunk has been taken.
+ */
+int take_parallel_chunk(struct ParallelJob* job, int worker) {
+
+    for(int i = 0; i < job->num_workers; i++) {
+
+        struct WorkStealingDeque* deque = &job->deques[(worker + i) % job->num_workers];
+
+        int chunk = -1;
+
+        pthread_mutex_lock(&deque->lock);
+
+        if(deque->bottom < deque->top) {
+            if(i == 0)
+                chunk = deque->bottom++;
+            else
+                chunk = --deque->top;
+        }
+
+        pthread_mutex_unlock(&deque->lock);
+
+        if(chunk >= 0)
+            return chunk;
+    }
+
+    return -1;
+}
+
+
+/**
+ * @brief Runs chunks of a parallel job until there are none left.
+ * 
+ * @param worker_pointer - Pointer to the ParallelWorker for this thread.
+ * 
+ * @returns NULL.
+ */
+void* run_parallel_worker(void* worker_pointer) {
+
+    struct ParallelWorker* worker = (struct ParallelWorker*) worker_pointer;
+    struct ParallelJob* job = worker->job;
+
+    int chunk;
+
+    while((chunk = take_parallel_chunk(job, worker->index)) >= 0) {
+        job->process(job, &job->chunks[chunk]);
+    }
+
+    return NULL;
+}
+
+
+/**
+ * @brief Splits a list into chunks in a single pass, and runs every chunk
+ * with job->process on up to num_threads threads (including the calling
+ * thread). Each thread starts with an even share of the chunks.
+ * 
+ * @remark The list must not be changed while the job runs, and must not be
+ * empty.
+ * 
+ * @param list - The list to run the job on.
+ * @param job - The job to run (its process, function, and ctx must be set).
+ * @param num_threads - The number of threads to run the job on.
+ * @param num_chunks - Set to the number of chunks the list was split into.
+ * 
+ * @returns The chunks, which must be freed by the caller, or NULL on failure
+ * (not enough heap).
+ */
+struct ParallelChunk* run_parallel_job(struct LinkedList* list, struct ParallelJob* job, int num_threads, int* num_chunks) {
+
+    if(num_threads < 1)
+        num_threads = 1;
+
+    // Make a few chunks per thread, so that threads which finish early
+    // have something to steal
+    int chunk_size = (list->length + num_threads * 4 - 1) / (num_threads * 4);
+    *num_chunks = (list->length + chunk_size - 1) / chunk_size;
+
+    job->num_workers = num_threads < *num_chunks ? num_threads : *num_chunks;
+    job->chunks = calloc(*num_chunks, sizeof(struct ParallelChunk));
+    job->deques = malloc(job->num_workers * sizeof(struct WorkStealingDeque));
+
+    pthread_t* threads = malloc(job->num_workers * sizeof(pthread_t));
+    struct ParallelWorker* workers = malloc(job->num_workers * sizeof(struct ParallelWorker));
+
+    if(job->chunks == NULL || job->deques == NULL || threads == NULL || workers == NULL) {
+        free(job->chunks);
+        free(job->deques);
+        free(threads);
+        free(workers);
+        return NULL;
+    }
+
+    // Find the first node of every chunk in one pass over the list
+    struct Node* current_node = list->head;
+
+    for(int i = 0; i < *num_chunks; i++) {
+        job->chunks[i].first = current_node;
+        job->chunks[i].count = i < *num_chunks - 1 ? chunk_size : list->length - i * chunk_size;
+
+        for(int j = 0; j < job->chunks[i].count; j++) {
+            current_node = current_node->next;
+        }
+    }
+
+    for(int i = 0; i < job->num_workers; i++) {
+        pthread_mutex_init(&job->deques[i].lock, NULL);
+        job->deques[i].bottom = (int) ((long long) i * *num_chunks / job->num_workers);
+        job->deques[i].top = (int) ((long long) (i + 1) * *num_chunks / job->num_workers);
+
+        workers[i].job = job;
+        workers[i].index = i;
+    }
+
+    // The calling thread is worker 0. If a thread can't be created, its
+    // chunks are stolen by the others.
+    int created[job->num_workers];
+
+    for(int i = 1; i < job->num_workers; i++) {
+        created[i] = pthread_create(&threads[i], NULL, run_parallel_worker, &workers[i]) == 0;
+    }
+
+    run_parallel_worker(&workers[0]);
+
+    for(int i = 1; i < job->num_workers; i++) {
+        if(created[i])
+            pthread_join(threads[i], NULL);
+    }
+
+    for(int i = 0; i < job->num_workers; i++) {
+        pthread_mutex_destroy(&job->deques[i].lock);
+    }
+
+    free(job->deques);
+    free(threads);
+    free(workers);
+
+    return job->chunks;
+}
+
+
+/**
+ * @brief Adds a new node with contents "contents" to the end of the nodes
+ * produced for a chunk.
+ * 
+ * @param chunk - The chunk to add the node to.
+ * @param contents - The contents to include in the node.
+ */
+void add_chunk_result(struct ParallelChunk* chunk, void* contents) {
+
+    struct Node* new_node = (struct Node*) malloc(sizeof(struct Node));
+
+    if(new_node == NULL) {
+        chunk->failed = 1;
+        return;
+    }
+
+    new_node->contents = contents;
+    new_node->next = NULL;
+
+    if(chunk->tail == NULL)
+        chunk->head = new_node;
+    else
+        chunk->tail->next = new_node;
+
+    chunk->tail = new_node;
+    chunk->length++;
+}
+
+
+/**
+ * @brief Runs the map function of a job on every node of a chunk, and adds
+ * the results to the chunk.
+ * 
+ * @param job - The job being run.
+ * @param chunk - The chunk to run.
+ */
+void map_chunk(struct ParallelJob* job, struct ParallelChunk* chunk) {
+
+    struct Node* current_node = chunk->first;
+
+    for(int i = 0; i < chunk->count && !chunk->failed; i++) {
+        void* result = job->map(current_node->contents, job->ctx);
+
+        add_chunk_result(chunk, result);
+
+        // The result would be lost if it could not be added
+        if(chunk->failed && result != NULL)
+            free(result);
+
+        current_node = current_node->next;
+    }
+}
+
+
+/**
+ * @brief Runs the filter function of a job on every node of a chunk, and adds
+ * the contents it keeps to the chunk.
+ * 
+ * @param job - The job being run.
+ * @param chunk - The chunk to run.
+ */
+void filter_chunk(struct ParallelJob* job, struct ParallelChunk* chunk) {
+
+    struct Node* current_node = chunk->first;
+
+    for(int i = 0; i < chunk->count && !chunk->failed; i++) {
+        if(job->filter(current_node->contents, job->ctx))
+            add_chunk_result(chunk, current_node->contents);
+
+        current_node = current_node->next;
+    }
+}
+
+
+/**
+ * @brief Combines the contents of every node of a chunk with the reduce
+ * function of a job, in order.
+ * 
+ * @param job - The job being run.
+ * @param chunk - The chunk to run.
+ */
+void reduce_chunk(struct ParallelJob* job, struct ParallelChunk* chunk) {
+
+    struct Node* current_node = chunk->first;
+
+    chunk->result = current_node->contents;
+
+    for(int i = 1; i < chunk->count; i++) {
+        current_node = current_node->next;
+        chunk->result = job->reduce(chunk->result, current_node->contents, job->ctx);
+    }
+}
+
+
+/**
+ * @brief Links the nodes produced for every chunk of a parallel job onto a
+ * new list, in order, and frees the chunks.
+ * 
+ * @param chunks - The chunks of the job.
+ * @param num_chunks - The number of chunks.
+ * @param free_contents - Whether to free the contents of the produced nodes
+ * if the job failed.
+ * 
+ * @returns The new list, or NULL if any chunk failed (in which case every
+ * produced node is freed).
+ */
+struct LinkedList* stitch_parallel_chunks(struct ParallelChunk* chunks, int num_chunks, int free_contents) {
+
+    int failed = 0;
+
+    for(int i = 0; i < num_chunks; i++) {
+        failed |= chunks[i].failed;
+    }
+
+    struct LinkedList* result = failed ? NULL : createLinkedList();
+
+    for(int i = 0; i < num_chunks; i++) {
+
+        if(result == NULL) {
+            // Undo the job
+            struct Node* current_node = chunks[i].head;
+
+            while(current_node != NULL) {
+                struct Node* next_node = current_node->next;
+
+                if(free_contents && current_node->contents != NULL)
+                    free(current_node->contents);
+
+                free(current_node);
+                current_node = next_node;
+            }
+        }
+        else if(chunks[i].head != NULL) {
+            if(result->tail == NULL)
+                result->head = chunks[i].head;
+            else
+                result->tail->next = chunks[i].head;
+
+            result->tail = chunks[i].tail;
+            result->length += chunks[i].length;
+        }
+    }
+
+    free(chunks);
+
+    return result;
+}
+
+
+/**
+ * @brief Creates a new list holding fn(contents, ctx) for the contents of
+ * every node in a list, in order. The list is split into chunks in a single
+ * pass, and the chunks are run on num_threads threads.
+ * 
+ * @remark fn must be safe to call from several threads at once, and the list
+ * must not be changed until this returns. The new list owns whatever fn
+ * returns, so tearing it down frees the results (unless teardown_keep is
+ * used).
+ * 
+ * @param list - The list to map over.
+ * @param fn - The function to run on the contents of every node.
+ * @param ctx - Passed along to every call to fn.
+ * @param num_threads - The number of threads to run fn on.
+ * 
+ * @returns The new list, or NULL on failure (not enough heap).
+ */
+LinkedList list_parallel_map(struct LinkedList* list, void* (*fn)(void*, void*), void* ctx, int num_threads) {
+
+    assertf(list != NULL, "Tried to map over a NULL Linked List.\n");
+
+    if(list->length == 0)
+        return createLinkedList();
+
+    struct ParallelJob job = {.process = map_chunk, .map = fn, .ctx = ctx};
+
+    int num_chunks;
+    struct ParallelChunk* chunks = run_parallel_job(list, &job, num_threads, &num_chunks);
+
+    if(chunks == NULL)
+        return NULL;
+
+    return stitch_parallel_chunks(chunks, num_chunks, 1);
+}
+
+
+/**
+ * @brief Creates a new list holding the contents of every node in a list for
+ * which fn(contents, ctx) is not 0, in order. The list is split into chunks
+ * in a single pass, and the chunks are run on num_threads threads.
+ * 
+ * @remark fn must be safe to call from several threads at once, and the list
+ * must not be changed until this returns. The contents are shared with the
+ * original list, so only one of the lists should free them on teardown.
+ * 
+ * @param list - The list to filter.
+ * @param fn - The function deciding which contents to keep.
+ * @param ctx - Passed along to every call to fn.
+ * @param num_threads - The number of threads to run fn on.
+ * 
+ * @returns The new list, or NULL on failure (not enough heap).
+ */
+LinkedList list_parallel_filter(struct LinkedList* list, int (*fn)(void*, void*), void* ctx, int num_threads) {
+
+    assertf(list != NULL, "Tried to filter a NULL Linked List.\n");
+
+    if(list->length == 0)
+        return createLinkedList();
+
+    struct ParallelJob job = {.process = filter_chunk, .filter = fn, .ctx = ctx};
+
+    int num_chunks;
+    struct ParallelChunk* chunks = run_parallel_job(list, &job, num_threads, &num_chunks);
+
+    if(chunks == NULL)
+        return NULL;
+
+    return stitch_parallel_chunks(chunks, num_chunks, 0);
+}
+
+
+/**
+ * @brief Combines the contents of every node in a list with fn, in order,
+ * starting from initial. The list is split into chunks in a single pass,
+ * each chunk is combined on one of num_threads threads, and then the results
+ * of the chunks are combined in order.
+ * 
+ * @remark fn must be associative (fn(fn(a, b), c) must equal fn(a, fn(b, c))),
+ * so its results must be the same kind of value as the contents, since the
+ * results of chunks are combined with fn as well. fn must also be safe to
+ * call from several threads at once. The list must not be changed until this
+ * returns.
+ * 
+ * @param list - The list to reduce.
+ * @param fn - The function combining two values, given ctx.
+ * @param initial - The value to start from (returned if the list is empty).
+ * @param ctx - Passed along to every call to fn.
+ * @param num_threads - The number of threads to run fn on.
+ * 
+ * @returns The combined value, or initial on failure (not enough heap).
+ */
+void* list_parallel_reduce(struct LinkedList* list, void* (*fn)(void*, void*, void*), void* initial, void* ctx, int num_threads) {
+
+    assertf(list != NULL, "Tried to reduce a NULL Linked List.\n");
+
+    if(list->length == 0)
+        return initial;
+
+    struct ParallelJob job = {.process = reduce_chunk, .reduce = fn, .ctx = ctx};
+
+    int num_chunks;
+    struct ParallelChunk* chunks = run_parallel_job(list, &job, num_threads, &num_chunks);
+
+    if(chunks == NULL)
+        return initial;
+
+    void* result = initial;
+
+    for(int i = 0; i < num_chunks; i++) {
+        result = fn(result, chunks[i].result, ctx);
+    }
+
+    free(chunks);
+
+    return result;
+}
+
+
+
+/**
+ * @brief Gets counts of what a list has done since it was created : how many
+ * nodes it has added, inserted, looked up and deleted, how many nodes it has
+ * walked past, how much it has allocated, and how long it has been.
+ * 
+ * @remark The counts are only kept when the library is built with -DDS_STATS,
+ * and are all 0 otherwise.
+ * 
+ * @param list - The list to get the counts of.
+ * 
+ * @returns The counts (by value).
+ */
+struct ListStats list_get_stats(struct LinkedList* list) {
+
+    assertf(list != NULL, "Tried to get stats from a NULL Linked List.\n");
+
+    #ifdef DS_STATS
+        return list->stats;
+    #else
+        struct ListStats stats = {0};
+        return stats;
+    #endif
+}
+
+
+/**
+ * @brief Writes the counts of what a list has done (see list_get_stats) to a
+ * stream, as a single line JSON object.
+ * 
+ * @param list - The list to write the counts of.
+ * @param stream - The stream to write to.
+ * 
+ * @returns 0 on failure (the stream could not be written), 1 on success.
+ */
+int list_dump_stats(struct LinkedList* list, FILE* stream) {
+
+    struct ListStats stats = list_get_stats(list);
+
+    int written = fprintf(stream,
+        "{\"adds\": %lld, \"inserts\": %lld, \"gets\": %lld, \"deletes\": %lld, "
+        "\"nodes_traversed\": %lld, \"mallocs\": %lld, \"frees\": %lld, "
+        "\"bytes_allocated\": %lld, \"peak_length\": %lld}\n",
+        stats.adds, stats.inserts, stats.gets, stats.deletes, stats.nodes_traversed,
+        stats.mallocs, stats.frees, stats.bytes_allocated, stats.peak_length);
+
+    return written > 0;
+}
+
+
+
+// Files written by list_serialize start with these 8 bytes, followed by the
+// number of contents. Each contents is then written as its size and its
+// bytes, padded to a multiple of 8 bytes so that every contents is aligned
+// once the file is mapped. All numbers are 64 bit, in the machine's byte
+// order.
+#define LIST_FILE_MAGIC "DSLIST01"
+
+// Written in place of the size of NULL contents
+#define LIST_FILE_NULL UINT64_MAX
+
+// list_serialize writes the file in blocks of this many bytes
+#define LIST_FILE_BUFFER_SIZE 65536
+
+
+/**
+ * @brief Writes every byte of a buffer to a file, retrying after partial
+ * writes.
+ * 
+ * @param fd - The file to write to.
+ * @param buffer - The bytes to write.
+ * @param num_bytes - The number of bytes to write.
+ * 
+ * @returns 0 on failure (the file could not be written), 1 on success.
+ */
+int write_fully(int fd, const char* buffer, size_t num_bytes) {
+
+    while(num_bytes > 0) {
+        ssize_t written = write(fd, buffer, num_bytes);
+
+        if(written <= 0)
+            return 0;
+
+        buffer += written;
+        num_bytes -= written;
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Adds bytes to the block being written by list_serialize, writing the
+ * block to the file whenever it fills up.
+ * 
+ * @param fd - The file to write to.
+ * @param buffer - The block being written (LIST_FILE_BUFFER_SIZE bytes).
+ * @param used - The number of bytes already in the block.
+ * @param bytes - The bytes to add (NULL to add zeroes).
+ * @param num_bytes - The number of bytes to add.
+ * 
+ * @returns 0 on failure (the file could not be written), 1 on success.
+ */
+int write_buffered(int fd, char* buffer, size_t* used, const void* bytes, size_t num_bytes) {
+
+    while(num_bytes > 0) {
+        size_t space = LIST_FILE_BUFFER_SIZE - *used;
+        size_t copied = num_bytes < space ? num_bytes : space;
+
+        if(bytes != NULL) {
+            memcpy(buffer + *used, bytes, copied);
+            bytes = (const char*) bytes + copied;
+        }
+        else {
+            memset(buffer + *used, 0, copied);
+        }
+
+        *used += copied;
+        num_bytes -= copied;
+
+        if(*used == LIST_FILE_BUFFER_SIZE) {
+            if(!write_fully(fd, buffer, *used))
+                return 0;
+
+            *used = 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/**
+ * @brief Writes the contents of every node in a list to a file, in a compact
+ * format which list_deserialize can load without copying : the number of
+ * contents, followed by the size and bytes of each contents.
+ * 
+ * @remark Writing starts at the current offset of the file. NULL contents are
+ * written as NULL, and loaded as NULL.
+ * 
+ * @param list - The list to write.
+ * @param fd - The file to write to (which must be open for writing).
+ * @param element_size - Gives the number of bytes in a (non NULL) contents.
+ * 
+ * @returns 0 on failure (the file could not be written, or not enough heap),
+ * 1 on success.
+ */
+int list_serialize(struct LinkedList* list, int fd, size_t (*element_size)(void*)) {
+
+    assertf(list != NULL, "Tried to serialize a NULL Linked List.\n");
+
+    char* buffer = allocate(list->allocator, LIST_FILE_BUFFER_SIZE);
+
+    if(buffer == NULL)
+        return 0;
+
+    size_t used = 0;
+
+    uint64_t count = list->length;
+
+    int success = write_buffered(fd, buffer, &used, LIST_FILE_MAGIC, 8) && write_buffered(fd, buffer, &used, &count, sizeof(count));
+
+    for(struct Node* current_node = list->head; current_node != NULL && success; current_node = current_node->next) {
+
+        if(current_node->contents == NULL) {
+            uint64_t size = LIST_FILE_NULL;
+            success = write_buffered(fd, buffer, &used, &size, sizeof(size));
+            continue;
+        }
+
+        uint64_t size = element_size(current_node->contents);
+        size_t padding = (8 - size % 8) % 8;
+
+        success = write_buffered(fd, buffer, &used, &size, sizeof(size))
+            && write_buffered(fd, buffer, &used, current_node->contents, size)
+            && write_buffered(fd, buffer, &used, NULL, padding);
+    }
+
+    if(success && used > 0)
+        success = write_fully(fd, buffer, used);
+
+    deallocate(list->allocator, buffer);
+
+    return success;
+}
+
+
+/**
+ * @brief Loads a list written by list_serialize, by mapping the whole file
+ * into memory. The contents of the new list point straight into the mapping,
+ * so nothing is copied, and its nodes are all allocated from one slab.
+ * 
+ * @remark The file is mapped privately, so the contents can be changed without
+ * changing the file. Contents in the mapping are never freed (as if they
+ * were deleted with delete_keep), and the file is unmapped when the list is
+ * torn down. Other contents added to the list are freed as usual.
+ * 
+ * @param fd - The file to load (which must be open for reading, and is mapped
+ * from its start).
+ * 
+ * @returns The loaded list, or NULL on failure (the file could not be mapped,
+ * is not a valid list file, or not enough heap).
+ */
+LinkedList list_deserialize(int fd) {
+
+    struct stat file_stats;
+
+    if(fstat(fd, &file_stats) != 0 || file_stats.st_size < 16)
+        return NULL;
+
+    size_t mapping_length = file_stats.st_size;
+
+    char* mapping = mmap(NULL, mapping_length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+    if(mapping == MAP_FAILED)
+        return NULL;
+
+    uint64_t count;
+    memcpy(&count, mapping + 8, sizeof(count));
+
+    // Every contents takes at least 8 bytes, which also keeps a corrupted
+    // count from making us allocate a huge pool
+    if(memcmp(mapping, LIST_FILE_MAGIC, 8) != 0 || count > (mapping_length - 16) / 8 || count > INT_MAX) {
+        munmap(mapping, mapping_length);
+        return NULL;
+    }
+
+    LinkedList list = createLinkedListWithPool(count > 0 ? (int) count : 1);
+
+    if(list == NULL) {
+        munmap(mapping, mapping_length);
+        return NULL;
+    }
+
+    list->mapping = mapping;
+    list->mapping_length = mapping_length;
+
+    size_t offset = 16;
+
+    for(uint64_t i = 0; i < count; i++) {
+
+        uint64_t size;
+
+        if(offset + sizeof(size) > mapping_length)
+            break;
+
+        memcpy(&size, mapping + offset, sizeof(size));
+        offset += sizeof(size);
+
+        void* contents = NULL;
+
+        if(size != LIST_FILE_NULL) {
+            if(size > mapping_length - offset)
+                break;
+
+            contents = mapping + offset;
+            offset += size + (8 - size % 8) % 8;
+        }
+
+        if(!add(list, contents))
+            break;
+    }
+
+    // The file was cut short (or we ran out of heap)
+    if(list->length != (int) count) {
+        teardown_keep(list);
+        return NULL;
+    }
+
+    return list;
+}
+
+
+
+/**
+ * @brief Gets size bytes of memory from malloc (for stdlib_allocator).
+ * 
+ * @param ctx - Unused.
+ * @param size - The number of bytes to get.
+ * 
+ * @returns NULL on failure (not enough heap), pointer to the memory on
+ * success.
+ */
+void* stdlib_alloc(void* ctx, size_t size) {
+
+    (void) ctx;
+
+    return malloc(size);
+}
+
+
+/**
+ * @brief Gives memory back to the heap with free (for stdlib_allocator).
+ * 
+ * @param ctx - Unused.
+ * @param pointer - The memory to free.
+ */
+void stdlib_free(void* ctx, void* pointer) {
+
+    (void) ctx;
+
+    free(pointer);
+}
+
+
+/**
+ * @brief Resizes memory from the heap with realloc (for stdlib_allocator).
+ * 
+ * @param ctx - Unused.
+ * @param pointer - The memory to resize.
+ * @param old_size - Unused, since the heap keeps track of it.
+ * @param new_size - The number of bytes to resize the memory to.
+ * 
+ * @returns NULL on failure (not enough heap), pointer to the resized memory
+ * on success.
+ */
+void* stdlib_resize(void* ctx, void* pointer, size_t old_size, size_t new_size) {
+
+    (void) ctx;
+    (void) old_size;
+
+    return realloc(pointer, new_size);
+}
+
+
+/**
+ * @brief Does nothing, since stdlib_allocator is never freed.
+ * 
+ * @param allocator - Unused.
+ * 
+ * @returns 0, since the allocator is not freed.
+ */
+int stdlib_teardown(struct Allocator* allocator) {
+
+    (void) allocator;
+
+    return 0;
+}
+
+
+struct Allocator stdlib_allocator = {
+    .alloc = stdlib_alloc,
+    .free = stdlib_free,
+    .resize = stdlib_resize,
+    .teardown = stdlib_teardown,
+    .ctx = NULL
+};
+
+
+/**
+ * @brief Rounds a number of bytes up to a multiple of the alignment of
+ * memory from malloc.
+ * 
+ * @param size - The number of bytes to round up.
+ * 
+ * @returns The rounded number of bytes.
+ */
+size_t align_size(size_t size) {
+
+    return (size + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+}
+
+
+/**
+ * @brief Gets size bytes of memory from the end of a bump allocator's
+ * current block, getting a new block from malloc if it is full.
+ * 
+ * @remark Allocations bigger than the block size get a block of their own,
+ * which is linked in behind the current block so that the rest of the
+ * current block can still be used.
+ * 
+ * @param ctx - The arena of the bump allocator.
+ * @param size - The number of bytes to get.
+ * 
+ * @returns NULL on failure (not enough heap for a new block), pointer to
+ * the memory on success.
+ */
+void* bump_alloc(void* ctx, size_t size) {
+
+    struct BumpArena* arena = (struct BumpArena*) ctx;
+
+    size = align_size(size == 0 ? 1 : size);
+
+    struct BumpBlock* block = arena->blocks;
+
+    if(block == NULL || block->capacity - block->used < size) {
+
+        size_t capacity = size > arena->block_size ? size : arena->block_size;
+
+        struct BumpBlock* new_block = malloc(sizeof(struct BumpBlock) + capacity);
+
+        if(new_block == NULL)
+            return NULL; //couldn't allocate enough heap for the block.
+
+        new_block->capacity = capacity;
+        new_block->used = 0;
+
+        // Big allocations fill their block, so keep handing out memory from
+        // the current one afterwards
+        if(block != NULL && size > arena->block_size) {
+            new_block->next = block->next;
+            block->next = new_block;
+        }
+        else {
+            new_block->next = block;
+            arena->blocks = new_block;
+        }
+
+        block = new_block;
+    }
+
+    void* pointer = (char*) block->memory + block->used;
+    block->used += size;
+
+    return pointer;
+}
+
+
+/**
+ * @brief Does nothing, since memory from a bump allocator is only freed
+ * when the allocator is torn down.
+ * 
+ * @param ctx - Unused.
+ * @param pointer - Unused.
+ */
+void bump_free(void* ctx, void* pointer) {
+
+    (void) ctx;
+    (void) pointer;
+}
+
+
+/**
+ * @brief Resizes memory from a bump allocator. If it was the last memory
+ * handed out from the current block, and there is room, it is resized in
+ * place. Otherwise, new memory is handed out and the contents are copied.
+ * 
+ * @param ctx - The arena of the bump allocator.
+ * @param pointer - The memory to resize (may be NULL).
+ * @param old_size - The number of bytes the memory was allocated with.
+ * @param new_size - The number of bytes to resize the memory to.
+ * 
+ * @returns NULL on failure (not enough heap for a new block), pointer to
+ * the resized memory on success.
+ */
+void* bump_resize(void* ctx, void* pointer, size_t old_size, size_t new_size) {
+
+    struct BumpArena* arena = (struct BumpArena*) ctx;
+    struct BumpBlock* block = arena->blocks;
+
+    if(pointer != NULL && block != NULL) {
+
+        size_t old_aligned = align_size(old_size == 0 ? 1 : old_size);
+        size_t new_aligned = align_size(new_size == 0 ? 1 : new_size);
+
+        char* end = (char*) block->memory + block->used;
+
+        if((char*) pointer + old_aligned == end && block->capacity - block->used + old_aligned >= new_aligned) {
+            block->used = block->used - old_aligned + new_aligned;
+            return pointer;
+        }
+    }
+
+    void* resized = bump_alloc(ctx, new_size);
+
+    if(resized != NULL && pointer != NULL)
+        memcpy(resized, pointer, old_size < new_size ? old_size : new_size);
+
+    return resized;
+}
+
+
+/**
+ * @brief Frees every block of a bump allocator (and so every structure still
+ * using it), along with the allocator itself.
+ * 
+ * @param allocator - The bump allocator to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int bump_teardown(struct Allocator* allocator) {
+
+    struct BumpArena* arena = (struct BumpArena*) allocator->ctx;
+    struct BumpBlock* block = arena->blocks;
+
+    while(block != NULL) {
+        struct BumpBlock* next_block = block->next;
+        free(block);
+        block = next_block;
+    }
+
+    free(arena);
+    free(allocator);
+
+    return 1;
+}
+
+
+// Every thread has its own cache, shared by all caching allocators (since
+// their memory all comes from malloc).
+_Thread_local struct ThreadCache thread_cache;
+
+// Used to empty a thread's cache when the thread exits
+pthread_key_t thread_cache_key;
+pthread_once_t thread_cache_key_once = PTHREAD_ONCE_INIT;
+
+
+/**
+ * @brief Frees every block in a thread's cache.
+ * 
+ * @param cache - The cache to empty.
+ */
+void empty_thread_cache(void* cache) {
+
+    struct ThreadCache* thread = (struct ThreadCache*) cache;
+
+    for(int i = 0; i < CACHE_SIZE_CLASSES; i++) {
+
+        void* block = thread->free_lists[i];
+
+        while(block != NULL) {
+            void* next_block = *(void**) block;
+            free((union CacheHeader*) block - 1);
+            block = next_block;
+        }
+
+        thread->free_lists[i] = NULL;
+        thread->counts[i] = 0;
+    }
+}
+
+
+/**
+ * @brief Creates the key used to empty threads' caches when they exit.
+ */
+void create_thread_cache_key() {
+
+    pthread_key_create(&thread_cache_key, empty_thread_cache);
+}
+
+
+/**
+ * @brief Gets size bytes of memory from the calling thread's cache, or from
+ * malloc if the cache has no memory of that size.
+ * 
+ * @param ctx - Unused.
+ * @param size - The number of bytes to get.
+ * 
+ * @returns NULL on failure (not enough heap), pointer to the memory on
+ * success.
+ */
+void* caching_alloc(void* ctx, size_t size) {
+
+    (void) ctx;
+
+    int size_class = size == 0 ? 0 : (int) ((size - 1) / 16);
+
+    // Too big to be cached
+    if(size > CACHE_SIZE_CLASSES * 16) {
+
+        union CacheHeader* header = malloc(sizeof(union CacheHeader) + size);
+
+        if(header == NULL)
+            return NULL;
+
+        header->size_class = -1;
+
+        return header + 1;
+    }
+
+    void* block = thread_cache.free_lists[size_class];
+
+    if(block != NULL) {
+        thread_cache.free_lists[size_class] = *(void**) block;
+        thread_cache.counts[size_class]--;
+        return block;
+    }
+
+    union CacheHeader* header = malloc(sizeof(union CacheHeader) + (size_class + 1) * 16);
+
+    if(header == NULL)
+        return NULL;
+
+    header->size_class = size_class;
+
+    return header + 1;
+}
+
+
+/**
+ * @brief Gives memory back to the calling thread's cache, or to the heap if
+ * it is too big to be cached or the cache for its size is full.
+ * 
+ * @remark Memory may be freed by a different thread than the one which
+ * allocated it, in which case it goes into the freeing thread's cache.
+ * 
+ * @param ctx - Unused.
+ * @param pointer - The memory to give back.
+ */
+void caching_free(void* ctx, void* pointer) {
+
+    (void) ctx;
+
+    if(pointer == NULL)
+        return;
+
+    union CacheHeader* header = (union CacheHeader*) pointer - 1;
+    int size_class = header->size_class;
+
+    if(size_class < 0 || thread_cache.counts[size_class] >= CACHE_MAX_BLOCKS) {
+        free(header);
+        return;
+    }
+
+    // Make sure the cache is emptied when this thread exits
+    if(!thread_cache.registered) {
+        pthread_once(&thread_cache_key_once, create_thread_cache_key);
+        pthread_setspecific(thread_cache_key, &thread_cache);
+        thread_cache.registered = 1;
+    }
+
+    *(void**) pointer = thread_cache.free_lists[size_class];
+    thread_cache.free_lists[size_class] = pointer;
+    thread_cache.counts[size_class]++;
+}
+
+
+/**
+ * @brief Resizes memory from a caching allocator. If the new size is in the
+ * same size class, the memory is left where it is. Otherwise, new memory is
+ * allocated and the contents are copied.
+ * 
+ * @param ctx - Unused.
+ * @param pointer - The memory to resize (may be NULL).
+ * @param old_size - The number of bytes the memory was allocated with.
+ * @param new_size - The number of bytes to resize the memory to.
+ * 
+ * @returns NULL on failure (not enough heap), pointer to the resized memory
+ * on success.
+ */
+void* caching_resize(void* ctx, void* pointer, size_t old_size, size_t new_size) {
+
+    if(pointer != NULL) {
+
+        int size_class = ((union CacheHeader*) pointer - 1)->size_class;
+
+        if(size_class >= 0 && new_size > 0 && (new_size - 1) / 16 == (size_t) size_class)
+            return pointer;
+    }
+
+    void* resized = caching_alloc(ctx, new_size);
+
+    if(resized == NULL)
+        return NULL;
+
+    if(pointer != NULL) {
+        memcpy(resized, pointer, old_size < new_size ? old_size : new_size);
+        caching_free(ctx, pointer);
+    }
+
+    return resized;
+}
+
+
+/**
+ * @brief Empties the calling thread's cache, and frees a caching allocator.
+ * The caches of other threads are emptied when those threads exit.
+ * 
+ * @param allocator - The caching allocator to tear down.
+ * 
+ * @returns 1 on success.
+ */
+int caching_teardown(struct Allocator* allocator) {
+
+    empty_thread_cache(&thread_cache);
+
+    free(allocator);
+
+    return 1;
+}
+
+
+
+/**
+ * @brief Gets a node from a pool. Released nodes are reused first, and then
+ * nodes are carved out of the current slab. When the current slab is full,
+ * a new slab twice its size is allocated.
+ * 
+ * @param pool - The pool to allocate the node from.
+ * 
+ * @returns NULL on failure (not enough heap to allocate new slab), pointer to
+ * the new (uninitialized) node on success.
+ */
+void* pool_allocate(struct NodePool* pool) {
+
+    assertf(pool != NULL, "Tried to allocate from a NULL Node Pool.\n");
+
+    // Reuse the most recently released node, if there is one
+    if(pool->free_list != NULL) {
+        void* node = pool->free_list;
+        pool->free_list = *(void**) node;
+        return node;
+    }
+
+    // If the current slab is full, allocate a new one
+    if(pool->slabs->capacity == pool->slab_used) {
+
+        // Double the size of each new slab (up to a limit), so that large
+        // lists need few slabs
+        int capacity = pool->slabs->capacity;
+        if(capacity < 65536)
+            capacity *= 2;
+
+        struct Slab* slab = allocate(pool->allocator, sizeof(struct Slab) + capacity * pool->node_size);
+
+        if(slab == NULL)
+            return NULL; //couldn't allocate enough heap for the slab.
+
+        slab->capacity = capacity;
+        slab->next = pool->slabs;
+
+        pool->slabs = slab;
+        pool->slab_used = 0;
+    }
+
+    // Nodes are laid out one after the other right after the slab header
+    char* node = (char*) (pool->slabs + 1) + pool->slab_used * pool->node_size;
+    pool->slab_used++;
+
+    return node;
+}
+
+
+/**
+ * @brief Gives a node back to a pool, so it can be reused by a later call
+ * to allocate.
+ * 
+ * @param pool - The pool that the node was allocated from.
+ * @param node - The node to release.
+ */
+void pool_release(struct NodePool* pool, void* node) {
+
+    assertf(pool != NULL, "Tried to release a node to a NULL Node Pool.\n");
+
+    // Link the node into the front of the free list
+    *(void**) node = pool->free_list;
+    pool->free_list = node;
+}
+
+
+/**
+ * @brief Makes sure a given number of nodes can be allocated from a pool's
+ * current slab. If there is not enough room left in it, a new slab with room
+ * for all of them is allocated at once.
+ * 
+ * @remark Nodes on the free list are not counted, and any room left in the
+ * old slab goes unused until the pool is torn down.
+ * 
+ * @param pool - The pool to reserve room in.
+ * @param num_nodes - The number of nodes to make room for.
+ * 
+ * @returns 0 on failure (not enough heap to allocate new slab), 1 on success.
+ */
+int pool_reserve(struct NodePool* pool, int num_nodes) {
+
+    assertf(pool != NULL, "Tried to reserve room in a NULL Node Pool.\n");
+
+    if(pool->slabs->capacity - pool->slab_used >= num_nodes)
+        return 1;
+
+    struct Slab* slab = allocate(pool->allocator, sizeof(struct Slab) + num_nodes * pool->node_size);
+
+    if(slab == NULL)
+        return 0; //couldn't allocate enough heap for the slab.
+
+    slab->capacity = num_nodes;
+    slab->next = pool->slabs;
+
+    pool->slabs = slab;
+    pool->slab_used = 0;
+
+    return 1;
+}
+
+
+/**
+ * @brief Drops a reference to a pool. If there are no references left, every
+ * slab in the pool is freed, along with the pool itself.
+ * 
+ * @remark Any nodes still allocated from the pool are freed along with their
+ * slab, but their contents are NOT freed.
+ * 
+ * @param pool - The pool to tear down.
+ * 
+ * @returns 1 if the pool was freed, 0 if it is still referenced.
+ */
+int pool_teardown(struct NodePool* pool) {
+
+    assertf(pool != NULL, "Tried to tear down a NULL Node Pool.\n");
+
+    pool->references--;
+
+    if(pool->references > 0)
+        return 0;
+
+    // Free every slab (and every node within them) at once
+    struct Slab* slab = pool->slabs;
+
+    while(slab != NULL) {
+        struct Slab* next_slab = slab->next;
+        deallocate(pool->allocator, slab);
+        slab = next_slab;
+    }
+
+    deallocate(pool->allocator, pool);
+
+    return 1;
+}
+
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new NodePool with an empty
+ * first slab of capacity_hint nodes.
+ * 
+ * @param node_size - The size, in bytes, of each node in the pool.
+ * @param capacity_hint - The number of nodes to make room for in the first
+ * slab.
+ * 
+ * @returns New NodePool with 1 reference, or NULL on failure.
+ */
+NodePool createNodePool(size_t node_size, int capacity_hint) {
+
+    return createNodePoolWithAllocator(node_size, capacity_hint, &stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new NodePool with an empty
+ * first slab of capacity_hint nodes, which gets itself and its slabs from
+ * a given allocator.
+ * 
+ * @param node_size - The size, in bytes, of each node in the pool.
+ * @param capacity_hint - The number of nodes to make room for in the first
+ * slab.
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the pool.
+ * 
+ * @returns New NodePool with 1 reference, or NULL on failure.
+ */
+NodePool createNodePoolWithAllocator(size_t node_size, int capacity_hint, Allocator allocator) {
+
+    assertf(allocator != NULL, "Tried to create a Node Pool with a NULL Allocator.\n");
+
+    // Nodes must be able to hold the free list link, and must stay aligned
+    // to pointers when laid out one after another.
+    if(node_size < sizeof(void*))
+        node_size = sizeof(void*);
+
+    node_size = (node_size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+    if(capacity_hint < 1)
+        capacity_hint = 1;
+
+    NodePool pool = (NodePool) allocate(allocator, sizeof(struct NodePool));
+
+    if(pool == NULL)
+        return NULL;
+
+    pool->slabs = allocate(allocator, sizeof(struct Slab) + capacity_hint * node_size);
+
+    if(pool->slabs == NULL) {
+        deallocate(allocator, pool);
+        return NULL;
+    }
+
+    pool->slabs->capacity = capacity_hint;
+    pool->slabs->next = NULL;
+
+    pool->node_size = node_size;
+    pool->slab_used = 0;
+    pool->free_list = NULL;
+    pool->references = 1;
+    pool->allocator = allocator;
+    pool->allocate = pool_allocate;
+    pool->release = pool_release;
+    pool->reserve = pool_reserve;
+    pool->teardown = pool_teardown;
+
+    return pool;
+}
+
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new LinkedList, with length
+ * 0 and function pointers to all of the above functions. 
+ * 
+ * @returns New LinkedList with 0 length and default function pointers.
+ */
+LinkedList createLinkedList() {
+    return createLinkedListWithAllocator(&stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new LinkedList which gets
+ * itself and its nodes from a given allocator.
+ * 
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the list.
+ * 
+ * @returns New LinkedList with 0 length, or NULL on failure.
+ */
+LinkedList createLinkedListWithAllocator(Allocator allocator) {
+
+    assertf(allocator != NULL, "Tried to create a Linked List with a NULL Allocator.\n");
+
+    LinkedList list = (LinkedList) allocate(allocator, sizeof(struct LinkedList));
+
+    if(list == NULL)
+        return NULL;
+
+    list->length = 0;
+    list->head = NULL;
+    list->tail = NULL;
+    list->finger = NULL;
+    list->finger_index = 0;
+    list->pool = NULL;
+    list->allocator = allocator;
+    list->auto_free = 1;
+    list->inline_nodes = 0;
+    list->mapping = NULL;
+    list->mapping_length = 0;
+    list->add = add;
+    list->insert = insert;
+    list->get = get;
+    list->get_or_default = get_or_default;
+    list->delete = delete;
+    list->delete_keep = delete_keep;
+    list->teardown = teardown;
+    list->teardown_keep = teardown_keep;
+    list->begin = begin;
+    list->add_many = add_many;
+    list->extend = extend;
+    list->splice = splice;
+    list->delete_range = delete_range;
+    list->add_inline = add_inline;
+    list->get_inline = get_inline;
+    list->sort = sort;
+    list->sort_via_array = sort_via_array;
+
+    #ifdef DS_STATS
+        memset(&list->stats, 0, sizeof(list->stats));
+    #endif
+
+    return list;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new LinkedList which
+ * allocates its nodes from a pool of its own.
+ * 
+ * @remark Tearing down this list frees all of its nodes at once.
+ * 
+ * @param capacity_hint - The number of nodes the list is expected to hold.
+ * 
+ * @returns New LinkedList with 0 length and its own pool, or NULL on failure.
+ */
+LinkedList createLinkedListWithPool(int capacity_hint) {
+    NodePool pool = createNodePool(sizeof(struct Node), capacity_hint);
+
+    if(pool == NULL)
+        return NULL;
+
+    LinkedList list = createLinkedListFromPool(pool);
+
+    // The list now holds the only reference we need to the pool
+    pool->teardown(pool);
+
+    return list;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new LinkedList which
+ * allocates its nodes from a given (possibly shared) pool.
+ * 
+ * @param pool - The pool to allocate nodes from. Its nodes must be at least
+ * as large as a Node.
+ * 
+ * @returns New LinkedList with 0 length which holds a reference to pool.
+ */
+LinkedList createLinkedListFromPool(NodePool pool) {
+
+    assertf(pool != NULL, "Tried to create a Linked List from a NULL Node Pool.\n");
+
+    assertf(pool->node_size >= sizeof(struct Node), "Tried to create a Linked List from a Node Pool with nodes that are too small.\n");
+
+    LinkedList list = createLinkedListWithAllocator(pool->allocator);
+
+    if(list == NULL)
+        return NULL;
+
+    list->pool = pool;
+    pool->references++;
+
+    return list;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new UnrolledList, with length
+ * 0 and function pointers to all of the unrolled list functions above.
+ * 
+ * @param block_size - The maximum number of contents stored in each node.
+ * 
+ * @returns New UnrolledList with 0 length, or NULL on failure.
+ */
+UnrolledList createUnrolledList(int block_size) {
+    return createUnrolledListWithAllocator(block_size, &stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new UnrolledList which gets
+ * itself and its nodes from a given allocator.
+ * 
+ * @param block_size - The maximum number of contents stored in each node.
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the list.
+ * 
+ * @returns New UnrolledList with 0 length, or NULL on failure.
+ */
+UnrolledList createUnrolledListWithAllocator(int block_size, Allocator allocator) {
+
+    assertf(block_size >= 2, "Tried to create an Unrolled List with a block size less than 2.\n");
+
+    assertf(allocator != NULL, "Tried to create an Unrolled List with a NULL Allocator.\n");
+
+    UnrolledList list = (UnrolledList) allocate(allocator, sizeof(struct UnrolledList));
+
+    if(list == NULL)
+        return NULL;
+
+    list->length = 0;
+    list->block_size = block_size;
+    list->head = NULL;
+    list->tail = NULL;
+    list->allocator = allocator;
+    list->auto_free = 1;
+    list->add = unrolled_add;
+    list->insert = unrolled_insert;
+    list->get = unrolled_get;
+    list->get_or_default = unrolled_get_or_default;
+    list->delete = unrolled_delete;
+    list->delete_keep = unrolled_delete_keep;
+    list->teardown = unrolled_teardown;
+    list->teardown_keep = unrolled_teardown_keep;
+    list->add_inline = unrolled_add_inline;
+
+    return list;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new Vector, with length 0,
+ * no array allocated yet, and function pointers to all of the vector
+ * functions above.
+ * 
+ * @returns New Vector with 0 length, or NULL on failure.
+ */
+Vector createVector() {
+    return createVectorWithAllocator(&stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new Vector which gets itself
+ * and its array from a given allocator.
+ * 
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the vector.
+ * 
+ * @returns New Vector with 0 length, or NULL on failure.
+ */
+Vector createVectorWithAllocator(Allocator allocator) {
+
+    assertf(allocator != NULL, "Tried to create a Vector with a NULL Allocator.\n");
+
+    Vector vector = (Vector) allocate(allocator, sizeof(struct Vector));
+
+    if(vector == NULL)
+        return NULL;
+
+    vector->length = 0;
+    vector->capacity = 0;
+    vector->contents = NULL;
+    vector->allocator = allocator;
+    vector->auto_free = 1;
+    vector->add = vector_add;
+    vector->insert = vector_insert;
+    vector->get = vector_get;
+    vector->get_or_default = vector_get_or_default;
+    vector->delete = vector_delete;
+    vector->delete_keep = vector_delete_keep;
+    vector->teardown = vector_teardown;
+    vector->teardown_keep = vector_teardown_keep;
+    vector->add_inline = vector_add_inline;
+    vector->reserve = vector_reserve;
+    vector->shrink_to_fit = vector_shrink_to_fit;
+
+    return vector;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new HashMap, with no keys, no
+ * table allocated yet, and function pointers to all of the hash map
+ * functions above.
+ * 
+ * @param hash - The function used to hash keys.
+ * @param equals - The function used to compare keys.
+ * 
+ * @returns New HashMap with 0 length, or NULL on failure.
+ */
+HashMap createHashMap(unsigned long long (*hash)(void*), int (*equals)(void*, void*)) {
+    return createHashMapWithAllocator(hash, equals, &stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new HashMap which gets itself
+ * and its table from a given allocator.
+ * 
+ * @param hash - The function used to hash keys.
+ * @param equals - The function used to compare keys.
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the map.
+ * 
+ * @returns New HashMap with 0 length, or NULL on failure.
+ */
+HashMap createHashMapWithAllocator(unsigned long long (*hash)(void*), int (*equals)(void*, void*), Allocator allocator) {
+
+    assertf(hash != NULL && equals != NULL, "Tried to create a Hash Map without a hash or equals function.\n");
+
+    assertf(allocator != NULL, "Tried to create a Hash Map with a NULL Allocator.\n");
+
+    HashMap map = (HashMap) allocate(allocator, sizeof(struct HashMap));
+
+    if(map == NULL)
+        return NULL;
+
+    map->length = 0;
+    map->capacity = 0;
+    map->entries = NULL;
+    map->allocator = allocator;
+    map->hash = hash;
+    map->equals = equals;
+    map->free_keys = 1;
+    map->free_values = 1;
+    map->put = hash_map_put;
+    map->get = hash_map_get;
+    map->get_or_default = hash_map_get_or_default;
+    map->remove = hash_map_remove;
+    map->remove_keep = hash_map_remove_keep;
+    map->reserve = hash_map_reserve;
+    map->teardown = hash_map_teardown;
+    map->teardown_keep = hash_map_teardown_keep;
+
+    return map;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new HashMap with C string
+ * keys.
+ * 
+ * @returns New HashMap with 0 length, or NULL on failure.
+ */
+HashMap createStringHashMap() {
+    return createHashMap(hash_string, equals_string);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new HashMap with integer keys.
+ * Keys are stored directly in the key pointers (see int_key()), so they are
+ * never freed.
+ * 
+ * @returns New HashMap with 0 length, or NULL on failure.
+ */
+HashMap createIntHashMap() {
+    HashMap map = createHashMap(hash_int, equals_int);
+
+    if(map != NULL)
+        map->free_keys = 0;
+
+    return map;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new ConcurrentList, with
+ * length 0 and function pointers to all of the concurrent list functions
+ * above.
+ * 
+ * @returns New ConcurrentList with 0 length, or NULL on failure.
+ */
+ConcurrentList createConcurrentList() {
+    return createConcurrentListWithAllocator(&stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new ConcurrentList which gets
+ * itself and its nodes from a given allocator (which must be thread safe).
+ * 
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the list.
+ * 
+ * @returns New ConcurrentList with 0 length, or NULL on failure.
+ */
+ConcurrentList createConcurrentListWithAllocator(Allocator allocator) {
+    ConcurrentList list = (ConcurrentList) allocate(allocator, sizeof(struct ConcurrentList));
+
+    if(list == NULL)
+        return NULL;
+
+    atomic_init(&list->length, 0);
+    list->head.contents = NULL;
+    list->head.next = NULL;
+    pthread_rwlock_init(&list->head.lock, NULL);
+    list->allocator = allocator;
+    list->auto_free = 1;
+    list->add = concurrent_add;
+    list->insert = concurrent_insert;
+    list->get = concurrent_get;
+    list->get_or_default = concurrent_get_or_default;
+    list->delete = concurrent_delete;
+    list->delete_keep = concurrent_delete_keep;
+    list->teardown = concurrent_teardown;
+    list->teardown_keep = concurrent_teardown_keep;
+    list->add_inline = concurrent_add_inline;
+
+    return list;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new LockFreeQueue, holding
+ * only its dummy node, with function pointers to all of the lock free queue
+ * functions above.
+ * 
+ * @returns New LockFreeQueue with 0 length, or NULL on failure.
+ */
+LockFreeQueue createLockFreeQueue() {
+
+    // The head and tail are on separate cache lines, so the queue has to
+    // be aligned to a cache line too
+    LockFreeQueue queue = (LockFreeQueue) aligned_alloc(_Alignof(struct LockFreeQueue), sizeof(struct LockFreeQueue));
+
+    struct QueueNode* dummy = malloc(sizeof(struct QueueNode));
+
+    if(queue == NULL || dummy == NULL) {
+        free(queue);
+        free(dummy);
+        return NULL;
+    }
+
+    dummy->contents = NULL;
+    atomic_init(&dummy->next, NULL);
+
+    atomic_init(&queue->head, dummy);
+    atomic_init(&queue->tail, dummy);
+    atomic_init(&queue->length, 0);
+    queue->auto_free = 1;
+    queue->enqueue = lock_free_enqueue;
+    queue->dequeue = lock_free_dequeue;
+    queue->teardown = lock_free_teardown;
+    queue->teardown_keep = lock_free_teardown_keep;
+
+    return queue;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new DoublyLinkedList, with
+ * length 0 and function pointers to all of the doubly linked list functions
+ * above.
+ * 
+ * @returns New DoublyLinkedList with 0 length, or NULL on failure.
+ */
+DoublyLinkedList createDoublyLinkedList() {
+    return createDoublyLinkedListWithAllocator(&stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new DoublyLinkedList which
+ * gets itself and its nodes from a given allocator.
+ * 
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the list.
+ * 
+ * @returns New DoublyLinkedList with 0 length, or NULL on failure.
+ */
+DoublyLinkedList createDoublyLinkedListWithAllocator(Allocator allocator) {
+    DoublyLinkedList list = (DoublyLinkedList) allocate(allocator, sizeof(struct DoublyLinkedList));
+
+    if(list == NULL)
+        return NULL;
+
+    list->length = 0;
+    list->head = NULL;
+    list->tail = NULL;
+    list->allocator = allocator;
+    list->auto_free = 1;
+    list->add = doubly_add;
+    list->insert = doubly_insert;
+    list->get = doubly_get;
+    list->get_or_default = doubly_get_or_default;
+    list->delete = doubly_delete;
+    list->delete_keep = doubly_delete_keep;
+    list->teardown = doubly_teardown;
+    list->teardown_keep = doubly_teardown_keep;
+    list->push_front = doubly_push_front;
+    list->pop_front = doubly_pop_front;
+    list->pop_back = doubly_pop_back;
+    list->add_inline = doubly_add_inline;
+
+    return list;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new SkipList, with length 0
+ * and function pointers to all of the skip list functions above.
+ * 
+ * @param compare - Compares the contents of two nodes, returning a negative
+ * number, 0, or a positive number if the first is less than, equal to, or
+ * greater than the second.
+ * 
+ * @returns New SkipList with 0 length, or NULL on failure.
+ */
+SkipList createSkipList(int (*compare)(void*, void*)) {
+    return createSkipListWithAllocator(compare, &stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new SkipList which gets
+ * itself, its head, and the pools for its nodes from a given allocator.
+ * 
+ * @param compare - Compares the contents of two nodes, returning a negative
+ * number, 0, or a positive number if the first is less than, equal to, or
+ * greater than the second.
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the list.
+ * 
+ * @returns New SkipList with 0 length, or NULL on failure.
+ */
+SkipList createSkipListWithAllocator(int (*compare)(void*, void*), Allocator allocator) {
+
+    assertf(compare != NULL, "Tried to create a Skip List without a comparator.\n");
+
+    assertf(allocator != NULL, "Tried to create a Skip List with a NULL Allocator.\n");
+
+    SkipList list = (SkipList) allocate(allocator, sizeof(struct SkipList));
+
+    if(list == NULL)
+        return NULL;
+
+    list->head = allocate(allocator, sizeof(struct SkipNode) + SKIP_LIST_MAX_LEVEL * sizeof(struct SkipLevel));
+
+    if(list->head == NULL) {
+        deallocate(allocator, list);
+        return NULL;
+    }
+
+    list->head->contents = NULL;
+    list->head->height = SKIP_LIST_MAX_LEVEL;
+
+    for(int i = 0; i < SKIP_LIST_MAX_LEVEL; i++) {
+        list->head->levels[i].next = NULL;
+        list->head->levels[i].span = 0;
+        list->pools[i] = NULL;
+    }
+
+    list->length = 0;
+    list->level = 1;
+    list->random_state = 0x9e3779b97f4a7c15ULL ^ (unsigned long long) (size_t) list;
+    list->compare = compare;
+    list->allocator = allocator;
+    list->auto_free = 1;
+    list->insert_sorted = skip_insert_sorted;
+    list->find = skip_find;
+    list->get = skip_get;
+    list->get_or_default = skip_get_or_default;
+    list->delete = skip_delete;
+    list->delete_keep = skip_delete_keep;
+    list->teardown = skip_teardown;
+    list->teardown_keep = skip_teardown_keep;
 
     return list;
-}
\ No newline at end of file
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new RingDeque, with length 0,
+ * no array allocated yet, and function pointers to all of the deque functions
+ * above.
+ * 
+ * @returns New RingDeque with 0 length, or NULL on failure.
+ */
+RingDeque createRingDeque() {
+    return createRingDequeWithAllocator(&stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new RingDeque which gets
+ * itself and its array from a given allocator.
+ * 
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the deque.
+ * 
+ * @returns New RingDeque with 0 length, or NULL on failure.
+ */
+RingDeque createRingDequeWithAllocator(Allocator allocator) {
+
+    assertf(allocator != NULL, "Tried to create a Ring Deque with a NULL Allocator.\n");
+
+    RingDeque deque = (RingDeque) allocate(allocator, sizeof(struct RingDeque));
+
+    if(deque == NULL)
+        return NULL;
+
+    deque->length = 0;
+    deque->capacity = 0;
+    deque->head = 0;
+    deque->contents = NULL;
+    deque->allocator = allocator;
+    deque->auto_free = 1;
+    deque->push_back = ring_push_back;
+    deque->push_front = ring_push_front;
+    deque->pop_front = ring_pop_front;
+    deque->pop_back = ring_pop_back;
+    deque->get = ring_get;
+    deque->get_or_default = ring_get_or_default;
+    deque->push_n = ring_push_n;
+    deque->pop_n = ring_pop_n;
+    deque->reserve = ring_reserve;
+    deque->teardown = ring_teardown;
+    deque->teardown_keep = ring_teardown_keep;
+
+    return deque;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new PriorityQueue, with
+ * length 0, no arrays allocated yet, and function pointers to all of the
+ * priority queue functions above.
+ * 
+ * @param compare - The function used to compare contents (the smallest are
+ * popped first).
+ * @param arity - The number of children of each position in the heap (at
+ * least 2).
+ * 
+ * @returns New PriorityQueue with 0 length, or NULL on failure.
+ */
+PriorityQueue createPriorityQueue(int (*compare)(void*, void*), int arity) {
+    return createPriorityQueueWithAllocator(compare, arity, &stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new PriorityQueue which gets
+ * itself and its arrays from a given allocator.
+ * 
+ * @param compare - The function used to compare contents (the smallest are
+ * popped first).
+ * @param arity - The number of children of each position in the heap (at
+ * least 2).
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the queue.
+ * 
+ * @returns New PriorityQueue with 0 length, or NULL on failure.
+ */
+PriorityQueue createPriorityQueueWithAllocator(int (*compare)(void*, void*), int arity, Allocator allocator) {
+
+    assertf(compare != NULL, "Tried to create a Priority Queue without a comparator.\n");
+
+    assertf(arity >= 2, "Tried to create a Priority Queue with arity %d.\n", arity);
+
+    assertf(allocator != NULL, "Tried to create a Priority Queue with a NULL Allocator.\n");
+
+    PriorityQueue queue = (PriorityQueue) allocate(allocator, sizeof(struct PriorityQueue));
+
+    if(queue == NULL)
+        return NULL;
+
+    queue->length = 0;
+    queue->capacity = 0;
+    queue->arity = arity;
+    queue->contents = NULL;
+    queue->handles = NULL;
+    queue->positions = NULL;
+    queue->num_handles = 0;
+    queue->free_handle = -1;
+    queue->allocator = allocator;
+    queue->auto_free = 1;
+    queue->compare = compare;
+    queue->push = priority_queue_push;
+    queue->pop = priority_queue_pop;
+    queue->peek = priority_queue_peek;
+    queue->heapify = priority_queue_heapify;
+    queue->heapify_list = priority_queue_heapify_list;
+    queue->decrease_key = priority_queue_decrease_key;
+    queue->reserve = priority_queue_reserve;
+    queue->teardown = priority_queue_teardown;
+    queue->teardown_keep = priority_queue_teardown_keep;
+
+    return queue;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new BTreeMap, with no keys,
+ * an empty leaf as its root, and function pointers to all of the B+tree map
+ * functions above.
+ * 
+ * @param compare - The function used to order keys.
+ * 
+ * @returns New BTreeMap with 0 length, or NULL on failure.
+ */
+BTreeMap createBTreeMap(int (*compare)(void*, void*)) {
+    return createBTreeMapWithAllocator(compare, &stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new BTreeMap which gets itself
+ * and the pools its nodes come from from a given allocator.
+ * 
+ * @param compare - The function used to order keys.
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the map.
+ * 
+ * @returns New BTreeMap with 0 length, or NULL on failure.
+ */
+BTreeMap createBTreeMapWithAllocator(int (*compare)(void*, void*), Allocator allocator) {
+
+    assertf(compare != NULL, "Tried to create a B+Tree Map without a comparator.\n");
+
+    assertf(allocator != NULL, "Tried to create a B+Tree Map with a NULL Allocator.\n");
+
+    BTreeMap map = (BTreeMap) allocate(allocator, sizeof(struct BTreeMap));
+
+    if(map == NULL)
+        return NULL;
+
+    map->leaf_pool = createNodePoolWithAllocator(sizeof(struct BTreeLeaf), 16, allocator);
+    map->internal_pool = createNodePoolWithAllocator(sizeof(struct BTreeInternal), 4, allocator);
+
+    if(map->leaf_pool == NULL || map->internal_pool == NULL) {
+        if(map->leaf_pool != NULL)
+            map->leaf_pool->teardown(map->leaf_pool);
+
+        if(map->internal_pool != NULL)
+            map->internal_pool->teardown(map->internal_pool);
+
+        deallocate(allocator, map);
+        return NULL;
+    }
+
+    map->length = 0;
+    map->allocator = allocator;
+    map->compare = compare;
+    map->free_keys = 1;
+    map->free_values = 1;
+
+    struct BTreeLeaf* root = allocate_btree_leaf(map);
+
+    if(root == NULL) {
+        map->leaf_pool->teardown(map->leaf_pool);
+        map->internal_pool->teardown(map->internal_pool);
+        deallocate(allocator, map);
+        return NULL;
+    }
+
+    map->root = &root->node;
+    map->put = btree_put;
+    map->get = btree_get;
+    map->get_or_default = btree_get_or_default;
+    map->remove = btree_remove;
+    map->remove_keep = btree_remove_keep;
+    map->bulk_load = btree_bulk_load;
+    map->begin = btree_begin;
+    map->begin_reverse = btree_begin_reverse;
+    map->range = btree_range;
+    map->range_reverse = btree_range_reverse;
+    map->teardown = btree_teardown;
+    map->teardown_keep = btree_teardown_keep;
+
+    return map;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new RadixTree, with no keys
+ * and function pointers to all of the radix tree functions above.
+ * 
+ * @returns New RadixTree with 0 length, or NULL on failure.
+ */
+RadixTree createRadixTree() {
+    return createRadixTreeWithAllocator(&stdlib_allocator);
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new RadixTree which gets
+ * itself, its leaves, and the pools its inner nodes come from from a given
+ * allocator.
+ * 
+ * @param allocator - The allocator to get memory from, which must outlive
+ * the tree.
+ * 
+ * @returns New RadixTree with 0 length, or NULL on failure.
+ */
+RadixTree createRadixTreeWithAllocator(Allocator allocator) {
+
+    assertf(allocator != NULL, "Tried to create a Radix Tree with a NULL Allocator.\n");
+
+    RadixTree tree = (RadixTree) allocate(allocator, sizeof(struct RadixTree));
+
+    if(tree == NULL)
+        return NULL;
+
+    // Small nodes are far more common than big ones
+    size_t node_sizes[4] = {sizeof(struct RadixNode4), sizeof(struct RadixNode16), sizeof(struct RadixNode48), sizeof(struct RadixNode256)};
+    int capacity_hints[4] = {64, 16, 4, 2};
+
+    for(int i = 0; i < 4; i++) {
+        tree->pools[i] = createNodePoolWithAllocator(node_sizes[i], capacity_hints[i], allocator);
+
+        if(tree->pools[i] == NULL) {
+            for(int j = 0; j < i; j++) {
+                tree->pools[j]->teardown(tree->pools[j]);
+            }
+
+            deallocate(allocator, tree);
+            return NULL;
+        }
+    }
+
+    tree->length = 0;
+    tree->root = NULL;
+    tree->allocator = allocator;
+    tree->free_values = 1;
+    tree->put = radix_put;
+    tree->get = radix_get;
+    tree->get_or_default = radix_get_or_default;
+    tree->remove = radix_remove;
+    tree->remove_keep = radix_remove_keep;
+    tree->longest_prefix = radix_longest_prefix;
+    tree->prefix_foreach = radix_prefix_foreach;
+    tree->teardown = radix_teardown;
+    tree->teardown_keep = radix_teardown_keep;
+
+    return tree;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new bump allocator, which
+ * hands out memory from blocks of block_size bytes.
+ * 
+ * @remark Freeing memory from the allocator does nothing. All of it is freed
+ * at once when the allocator is torn down, so structures using it do not
+ * need to be torn down themselves.
+ * 
+ * @param block_size - The number of bytes in each block (bigger allocations
+ * get a block of their own).
+ * 
+ * @returns New bump allocator with no blocks yet, or NULL on failure.
+ */
+Allocator createBumpAllocator(size_t block_size) {
+
+    assertf(block_size > 0, "Tried to create a Bump Allocator with a block size of 0.\n");
+
+    Allocator allocator = (Allocator) malloc(sizeof(struct Allocator));
+    struct BumpArena* arena = malloc(sizeof(struct BumpArena));
+
+    if(allocator == NULL || arena == NULL) {
+        free(allocator);
+        free(arena);
+        return NULL;
+    }
+
+    arena->blocks = NULL;
+    arena->block_size = align_size(block_size);
+
+    allocator->alloc = bump_alloc;
+    allocator->free = bump_free;
+    allocator->resize = bump_resize;
+    allocator->teardown = bump_teardown;
+    allocator->ctx = arena;
+
+    return allocator;
+}
+
+
+/**
+ * @brief Allocates, instantiates, and returns a new caching allocator, which
+ * keeps the memory freed by each thread in a cache for that thread.
+ * 
+ * @returns New caching allocator, or NULL on failure.
+ */
+Allocator createCachingAllocator() {
+
+    Allocator allocator = (Allocator) malloc(sizeof(struct Allocator));
+
+    if(allocator == NULL)
+        return NULL;
+
+    allocator->alloc = caching_alloc;
+    allocator->free = caching_free;
+    allocator->resize = caching_resize;
+    allocator->teardown = caching_teardown;
+    allocator->ctx = NULL;
+
+    return allocator;
+}
@@ -10,6 +10,20 @@
  * primitives. Currently, this includes :
  * 
  *     • LinkedList
+ *     • NodePool (a slab allocator which lists can draw their nodes from)
+ *     • UnrolledList
+ *     • Vector
+ *     • HashMap
+ *     • ConcurrentList (a LinkedList which can be shared between threads)
+ *     • LockFreeQueue (a FIFO queue which can be shared between threads)
+ *     • DoublyLinkedList
+ *     • SkipList (a sorted list with O(log n) access by index)
+ *     • RingDeque (a double ended queue stored in a circular array)
+ *     • PriorityQueue (a d-ary heap, with handles for decrease_key)
+ *     • BTreeMap (an ordered map stored in a B+tree, with range iterators)
+ *     • RadixTree (a map from byte strings to values, with prefix queries)
+ *     • Allocator (where the structures get their memory from)
+ *     • DS_DEFINE_LIST (a list of values of one type, stored inline)
  * 
  * These structs all are designed to accept void pointers to data as their 
  * contents. This means that any type of data can be stored in these data 
@@ -31,7 +45,10 @@
 #include <assert.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <stdatomic.h>
+#include <pthread.h>
 
 // A brilliant little def provided by Mingye Wang 
 //     (https://stackoverflow.com/questions/5867834/assert-with-message)
@@ -44,6 +61,119 @@
 
 
 
+// Every structure gets its own memory (itself, its nodes, and its arrays)
+// from an allocator, which is passed to its constructor (the constructors
+// without an allocator use stdlib_allocator). Contents are always freed
+// with free(), since they are allocated by the user.
+//
+// A structure's allocator must outlive it, and structures which are shared
+// between threads need an allocator which is thread safe.
+struct Allocator {
+    // Get size bytes of memory, aligned like memory from malloc (returns
+    // NULL on failure)
+    void* (*alloc)(void* ctx, size_t size);
+
+    // Give back memory from alloc (NULL is ignored)
+    void (*free)(void* ctx, void* pointer);
+
+    // Grow or shrink memory from alloc, keeping its first bytes, like
+    // realloc (this may be NULL, in which case memory is resized by
+    // allocating, copying, and freeing)
+    void* (*resize)(void* ctx, void* pointer, size_t old_size, size_t new_size);
+
+    // Free the allocator, and any memory it still holds (this frees every
+    // structure still using it, if it is a bump allocator)
+    int (*teardown)(struct Allocator*);
+
+    // Stores the state of the allocator, which is passed to every call
+    void* ctx;
+};
+
+// Allocators are passed around through pointers, just like structures.
+typedef struct Allocator* Allocator;
+
+// Gets memory from malloc(), and gives it back with free(). This is thread
+// safe, and is never torn down.
+extern struct Allocator stdlib_allocator;
+
+// Get memory from, give memory back to, or resize memory from an allocator
+// (memory is resized by allocating, copying and freeing if the allocator
+// has no resize).
+void* allocate(Allocator allocator, size_t size);
+void deallocate(Allocator allocator, void* pointer);
+void* reallocate(Allocator allocator, void* pointer, size_t old_size, size_t new_size);
+
+// A bump allocator hands out memory from the end of its current block,
+// and gets a new block once the current one is full.
+struct BumpBlock {
+    struct BumpBlock* next;
+
+    // Stores the number of bytes in the block, and the number handed out
+    size_t capacity;
+    size_t used;
+
+    max_align_t memory[];
+};
+
+struct BumpArena {
+    // Stores pointer to the current block (blocks are linked together so
+    // they can all be freed at once)
+    struct BumpBlock* blocks;
+
+    // Stores the size of each new block
+    size_t block_size;
+};
+
+// A caching allocator keeps freed memory of up to CACHE_SIZE_CLASSES * 16
+// bytes in a cache for each thread, with one free list for each multiple
+// of 16 bytes, holding at most CACHE_MAX_BLOCKS blocks each.
+#define CACHE_SIZE_CLASSES 16
+#define CACHE_MAX_BLOCKS 256
+
+// Memory from a caching allocator comes right after this header, which
+// stores its size class (or -1 if it is too big to be cached)
+union CacheHeader {
+    int size_class;
+
+    max_align_t alignment;
+};
+
+struct ThreadCache {
+    void* free_lists[CACHE_SIZE_CLASSES];
+    int counts[CACHE_SIZE_CLASSES];
+
+    // Stores whether the cache will be emptied when its thread exits
+    int registered;
+};
+
+
+
+// Counts of what a LinkedList has done since it was created. These are
+// only kept when the library is built with -DDS_STATS (and then every file
+// including this header must be built with it too, since it changes the
+// layout of struct LinkedList). Otherwise, they are always 0.
+struct ListStats {
+    // Stores the number of nodes added to the end of the list, inserted,
+    // looked up, and deleted
+    long long adds;
+    long long inserts;
+    long long gets;
+    long long deletes;
+
+    // Stores the number of nodes walked past to reach the nodes above
+    long long nodes_traversed;
+
+    // Stores the number of allocations and frees made for the list's
+    // nodes and contents, and the number of bytes allocated (nodes
+    // allocated from a pool are not counted)
+    long long mallocs;
+    long long frees;
+    long long bytes_allocated;
+
+    // Stores the longest the list has ever been
+    long long peak_length;
+};
+
 struct LinkedList {
     // Stores length of list
     int length;
@@ -51,6 +181,47 @@ struct LinkedList {
     // Stores pointer to head node - the first node in the list
     struct Node* head;
 
+    // Stores pointer to tail node - the last node in the list (this
+    // makes adding to the end of the list O(1))
+    struct Node* tail;
+
+    // Stores pointer to the node most recently found by index, and its
+    // index (or NULL). Indices at or after it are found by walking on from
+    // it rather than from the head, so looping get over ascending indices
+    // is O(n) overall. This means get writes to the list, so even reads
+    // must not happen from two threads at once.
+    struct Node* finger;
+    int finger_index;
+
+    // Stores pointer to the pool that nodes are allocated from, or NULL
+    // if nodes are allocated with the list's allocator
+    struct NodePool* pool;
+
+    // Stores pointer to the allocator the list and its nodes are
+    // allocated from
+    struct Allocator* allocator;
+
+    // Stores whether delete, delete_range, teardown and iterators free the
+    // contents of the nodes they remove (1 by default). Set this to 0 once
+    // for a list whose contents are owned elsewhere.
+    int auto_free;
+
+    // Stores the number of nodes in the list which hold their contents
+    // inline (these are always allocated from the list's allocator, even
+    // when the list has a pool)
+    int inline_nodes;
+
+    // Stores pointer to the file the list was loaded from (see
+    // list_deserialize), mapped into memory, or NULL. Contents stored in
+    // the mapping are never freed, and the file is unmapped on teardown.
+    void* mapping;
+    size_t mapping_length;
+
+    #ifdef DS_STATS
+        // Stores counts of what the list has done (see list_get_stats)
+        struct ListStats stats;
+    #endif
+
     // Add a new node with contents "contents" to the end of the 
     // list
     int (*add)(struct LinkedList*, void*);
@@ -67,15 +238,57 @@ struct LinkedList {
     // the list (returns pointer to default data on failure).
     void* (*get_or_default)(struct LinkedList*, int, void*);
 
-    // Delete a node at a given index from the list.
-    int (*delete)(struct LinkedList*, int, ...);
+    // Delete a node at a given index from the list, freeing its contents
+    // (unless auto_free is turned off).
+    int (*delete)(struct LinkedList*, int);
+
+    // Delete a node at a given index from the list, without freeing its
+    // contents.
+    int (*delete_keep)(struct LinkedList*, int);
+
+    // Free the list, all of its nodes, AND ALL OF THEIR CONTENTS (unless
+    // auto_free is turned off).
+    int (*teardown)(struct LinkedList*);
+
+    // Free the list and all of its nodes, without freeing their contents.
+    int (*teardown_keep)(struct LinkedList*);
+
+    // Get an iterator positioned before the first node in the list
+    struct ListIterator (*begin)(struct LinkedList*);
+
+    // Add new nodes with the given array of contents to the end of the
+    // list, in a single pass
+    int (*add_many)(struct LinkedList*, void**, int);
+
+    // Move every node of another list onto the end of this list (the
+    // other list is left empty)
+    int (*extend)(struct LinkedList*, struct LinkedList*);
+
+    // Move every node of another list into this list at a given index
+    // (the other list is left empty)
+    int (*splice)(struct LinkedList*, int, struct LinkedList*);
 
-    // Defines flag variable to contraindicate automatic freeing of data
-    // stored in list during teardown and delete
-    #define NO_AUTO_FREE 0x29167d497c28d39d
+    // Delete every node in the index range [from, to) from the list, in
+    // a single pass (freeing their contents unless auto_free is turned off)
+    int (*delete_range)(struct LinkedList*, int, int);
 
-    // Free the list, all of its nodes, AND ALL OF THEIR CONTENTS.
-    int (*teardown)(struct LinkedList*, ...);
+    // Add a new node to the end of the list holding a copy of num_bytes
+    // bytes of "contents" inline, in a single allocation
+    int (*add_inline)(struct LinkedList*, void*, int);
+
+    // Copy num_bytes bytes of the contents of a node at a given index in
+    // the list into "destination" (returns 0 on failure)
+    int (*get_inline)(struct LinkedList*, int, void*, int);
+
+    // Sort the list with a comparator (like the one a SkipList takes), by
+    // relinking its nodes. The sort is stable, and allocates nothing.
+    int (*sort)(struct LinkedList*, int (*)(void*, void*));
+
+    // Sort the list with a comparator, by sorting an array of its contents
+    // and writing them back into the nodes in order. This is stable, and
+    // faster than sort for long lists whose nodes are spread around
+    // memory, but needs room for a temporary array.
+    int (*sort_via_array)(struct LinkedList*, int (*)(void*, void*));
 };
 
 // The standard way a LinkedList is manipulated and traversed
@@ -86,18 +299,1289 @@ struct Node {
     void* contents;
 
     struct Node* next;
+
+    // Nodes created by add_inline() store a copy of their contents right
+    // here, after the node, and point contents at it. The contents of
+    // these nodes are freed along with the node.
+    unsigned char inline_contents[];
 };
 
 // This type definition makes it easier to declare and iterate 
 // over nodes in a list manually.
 typedef struct Node* Node;
 
+// An iterator keeps its position in a list, so that visiting every node
+// is O(n) overall, and removing or inserting at the position is O(1).
+// Iterators are small, and are meant to be kept on the stack :
+//
+//     struct ListIterator it = list->begin(list);
+//     while(it.has_next(&it)) {
+//         void* contents = it.next(&it);
+//         ...
+//     }
+struct ListIterator {
+    // Stores pointer to the list being iterated over
+    struct LinkedList* list;
+
+    // Stores pointer to the node before current (NULL if there is none)
+    struct Node* previous;
+
+    // Stores pointer to the node most recently returned by next (NULL
+    // before the first call to next, or after current is removed)
+    struct Node* current;
+
+    // Stores pointer to the node that next will return
+    struct Node* upcoming;
+
+    // Stores the index of current in the list (-1 before the first call
+    // to next)
+    int index;
+
+    // Check whether there is another node for next to return
+    int (*has_next)(struct ListIterator*);
+
+    // Move to the next node in the list and return its contents
+    void* (*next)(struct ListIterator*);
+
+    // Delete the current node from the list (freeing its contents unless
+    // the list's auto_free is turned off)
+    int (*remove_current)(struct ListIterator*);
+
+    // Insert a new node with contents "contents" right after the current
+    // node. It will be returned by the next call to next.
+    int (*insert_after_current)(struct ListIterator*, void*);
+};
+
+
+
+// A slab is one large block of memory which is carved up into many
+// equally sized nodes by a NodePool.
+struct Slab {
+    // Stores pointer to the slab allocated before this one
+    struct Slab* next;
+
+    // Stores the number of nodes which fit in this slab
+    int capacity;
+};
+
+struct NodePool {
+    // Stores the size of every node handed out by the pool
+    size_t node_size;
+
+    // Stores pointer to the most recently allocated slab (slabs are
+    // linked together so they can all be freed at once)
+    struct Slab* slabs;
+
+    // Stores pointer to the allocator the pool and its slabs are
+    // allocated from
+    struct Allocator* allocator;
+
+    // Stores the number of nodes already handed out from the most
+    // recently allocated slab
+    int slab_used;
+
+    // Stores pointer to the first node which has been released back to
+    // the pool. Released nodes are linked together through their first
+    // bytes, and are reused before any new nodes are carved from a slab.
+    void* free_list;
+
+    // Stores the number of structures (and users) holding on to this
+    // pool. The pool's slabs are freed once this drops to 0.
+    int references;
+
+    // Get a node of node_size bytes from the pool (returns NULL on
+    // failure)
+    void* (*allocate)(struct NodePool*);
+
+    // Give a node back to the pool so that it can be reused
+    void (*release)(struct NodePool*, void*);
+
+    // Make sure a given number of nodes can be allocated from the
+    // current slab, allocating them all in one new slab if not
+    int (*reserve)(struct NodePool*, int);
+
+    // Drop a reference to the pool, freeing all of its slabs (and
+    // therefore every node ever allocated from it) if it was the last.
+    int (*teardown)(struct NodePool*);
+};
+
+// Pools are manipulated through pointers, just like lists.
+typedef struct NodePool* NodePool;
+
+
+
+struct UnrolledList {
+    // Stores length of list (the number of contents, not nodes)
+    int length;
+
+    // Stores the maximum number of contents stored in each node
+    int block_size;
+
+    // Stores pointer to head node - the first node in the list
+    struct UnrolledNode* head;
+
+    // Stores pointer to tail node - the last node in the list
+    struct UnrolledNode* tail;
+
+    // Stores pointer to the allocator the list and its nodes are allocated from
+    struct Allocator* allocator;
+
+    // Stores whether delete and teardown free the contents they remove
+    // (1 by default). Set this to 0 once for a list whose contents are
+    // owned elsewhere.
+    int auto_free;
+
+    // Add new contents "contents" to the end of the list
+    int (*add)(struct UnrolledList*, void*);
+
+    // Insert new contents "contents" into a given index in the list
+    int (*insert)(struct UnrolledList*, int, void*);
+
+    // Get a pointer to the contents at an index in the list (returns
+    // NULL on failure)
+    void* (*get)(struct UnrolledList*, int);
+
+    // Get a pointer to the contents at an index in the list (returns
+    // pointer to default data on failure).
+    void* (*get_or_default)(struct UnrolledList*, int, void*);
+
+    // Delete the contents at a given index from the list, freeing them (unless
+    // auto_free is turned off).
+    int (*delete)(struct UnrolledList*, int);
+
+    // Delete the contents at a given index from the list, without freeing them.
+    int (*delete_keep)(struct UnrolledList*, int);
+
+    // Free the list, all of its nodes, AND ALL OF THEIR CONTENTS (unless
+    // auto_free is turned off).
+    int (*teardown)(struct UnrolledList*);
+
+    // Free the list and all of its nodes, without freeing their contents.
+    int (*teardown_keep)(struct UnrolledList*);
+
+    // Add a copy of num_bytes bytes of "contents" to the end of the
+    // list (the copy is freed like any other contents)
+    int (*add_inline)(struct UnrolledList*, void*, int);
+};
+
+typedef struct UnrolledList* UnrolledList;
+
+// Each node of an unrolled list stores up to block_size contents in
+// an array, so that far fewer pointers are followed during traversal.
+struct UnrolledNode {
+    // Stores the number of contents currently stored in this node
+    int count;
+
+    struct UnrolledNode* next;
+
+    // Stores the contents of this node (with room for block_size)
+    void* contents[];
+};
+
+typedef struct UnrolledNode* UnrolledNode;
+
+
+
+struct Vector {
+    // Stores length of vector (the number of contents in use)
+    int length;
+
+    // Stores the number of contents the array has room for
+    int capacity;
+
+    // Stores pointer to the contiguous array of contents
+    void** contents;
+
+    // Stores pointer to the allocator the vector and its array are allocated from
+    struct Allocator* allocator;
+
+    // Stores whether delete and teardown free the contents they remove
+    // (1 by default). Set this to 0 once for a vector whose contents are
+    // owned elsewhere.
+    int auto_free;
+
+    // Add new contents "contents" to the end of the vector (amortized
+    // O(1))
+    int (*add)(struct Vector*, void*);
+
+    // Insert new contents "contents" into a given index in the vector
+    int (*insert)(struct Vector*, int, void*);
+
+    // Get a pointer to the contents at an index in the vector (returns
+    // NULL on failure)
+    void* (*get)(struct Vector*, int);
+
+    // Get a pointer to the contents at an index in the vector (returns
+    // pointer to default data on failure).
+    void* (*get_or_default)(struct Vector*, int, void*);
+
+    // Delete the contents at a given index from the vector, freeing them (unless
+    // auto_free is turned off).
+    int (*delete)(struct Vector*, int);
+
+    // Delete the contents at a given index from the vector, without freeing them.
+    int (*delete_keep)(struct Vector*, int);
+
+    // Free the vector AND ALL OF ITS CONTENTS (unless auto_free is turned
+    // off).
+    int (*teardown)(struct Vector*);
+
+    // Free the vector, without freeing its contents.
+    int (*teardown_keep)(struct Vector*);
+
+    // Make sure the vector has room for at least a given number of
+    // contents without growing again
+    int (*reserve)(struct Vector*, int);
+
+    // Shrink the array so its capacity matches the vector's length
+    int (*shrink_to_fit)(struct Vector*);
+
+    // Add a copy of num_bytes bytes of "contents" to the end of the
+    // vector (the copy is freed like any other contents)
+    int (*add_inline)(struct Vector*, void*, int);
+};
+
+typedef struct Vector* Vector;
+
+
+
+// Each slot in a hash map's table stores one key and its value.
+struct HashMapEntry {
+    void* key;
+
+    void* value;
+
+    // Stores the full hash of the key, so that keys with different
+    // hashes never have to be compared, and the table can be grown
+    // without hashing every key again
+    unsigned long long hash;
+
+    // Stores how far this entry is from the slot its hash maps to, plus
+    // one (0 means the slot is empty)
+    int probe_length;
+};
+
+struct HashMap {
+    // Stores the number of keys in the map
+    int length;
+
+    // Stores the number of slots in the table (always a power of 2)
+    int capacity;
+
+    // Stores the table of entries (using open addressing, with Robin
+    // Hood probing)
+    struct HashMapEntry* entries;
+
+    // Stores pointer to the allocator the map and its table are allocated from
+    struct Allocator* allocator;
+
+    // Hashes a key
+    unsigned long long (*hash)(void*);
+
+    // Compares two keys (returns nonzero if they are equal)
+    int (*equals)(void*, void*);
+
+    // Stores whether keys are owned (and freed) by the map. This is 0
+    // for maps with integer keys.
+    int free_keys;
+
+    // Stores whether values are owned (and freed) by the map (1 by
+    // default).
+    int free_values;
+
+    // Add a key with a value to the map, or replace the value of a key
+    // already in the map (freeing the replaced key and value, if they are
+    // owned by the map)
+    int (*put)(struct HashMap*, void*, void*);
+
+    // Get the value of a key in the map (returns NULL on failure)
+    void* (*get)(struct HashMap*, void*);
+
+    // Get the value of a key in the map (returns pointer to default
+    // data on failure)
+    void* (*get_or_default)(struct HashMap*, void*, void*);
+
+    // Remove a key and its value from the map (freeing them, if they are
+    // owned by the map)
+    int (*remove)(struct HashMap*, void*);
+
+    // Remove a key and its value from the map, without freeing them
+    int (*remove_keep)(struct HashMap*, void*);
+
+    // Make sure the map has room for a given number of keys without
+    // growing again
+    int (*reserve)(struct HashMap*, int);
+
+    // Free the map, AND ALL OF ITS KEYS AND VALUES (if they are owned by
+    // the map).
+    int (*teardown)(struct HashMap*);
+
+    // Free the map, without freeing its keys and values.
+    int (*teardown_keep)(struct HashMap*);
+};
+
+typedef struct HashMap* HashMap;
+
+
+
+// Each node of a concurrent list has its own lock. Threads lock nodes
+// hand-over-hand (locking the next node before unlocking the current
+// one), so readers share locks with each other, and writers only hold
+// write locks on the nodes around their change.
+struct ConcurrentNode {
+    void* contents;
+
+    struct ConcurrentNode* next;
+
+    // Guards this node's contents and next pointer
+    pthread_rwlock_t lock;
+};
+
+struct ConcurrentList {
+    // Stores length of list (which may change as soon as it is read)
+    _Atomic int length;
+
+    // Stores a sentinel node before the first node in the list, whose
+    // lock guards the link to the first node (head.next)
+    struct ConcurrentNode head;
+
+    // Stores pointer to the allocator the list and its nodes are
+    // allocated from (which must be thread safe)
+    struct Allocator* allocator;
+
+    // Stores whether delete and teardown free the contents they remove
+    // (1 by default). Set this to 0 once for a list whose contents are
+    // owned elsewhere.
+    int auto_free;
+
+    // Add a new node with contents "contents" to the end of the list
+    int (*add)(struct ConcurrentList*, void*);
+
+    // Insert a new node with contents "contents" into a given index in
+    // the list
+    int (*insert)(struct ConcurrentList*, int, void*);
+
+    // Get a pointer to the contents of a node from its index in the
+    // list (returns NULL on failure)
+    void* (*get)(struct ConcurrentList*, int);
+
+    // Get a pointer to the contents of a node from its index in the
+    // list (returns pointer to default data on failure).
+    void* (*get_or_default)(struct ConcurrentList*, int, void*);
+
+    // Delete a node at a given index from the list, freeing its contents (unless
+    // auto_free is turned off).
+    int (*delete)(struct ConcurrentList*, int);
+
+    // Delete a node at a given index from the list, without freeing its contents.
+    int (*delete_keep)(struct ConcurrentList*, int);
+
+    // Free the list, all of its nodes, AND ALL OF THEIR CONTENTS (unless
+    // auto_free is turned off). This is NOT thread safe, and may only be
+    // called once no other thread is using the list.
+    int (*teardown)(struct ConcurrentList*);
+
+    // Free the list and all of its nodes, without freeing their contents
+    // (this is NOT thread safe either).
+    int (*teardown_keep)(struct ConcurrentList*);
+
+    // Add a copy of num_bytes bytes of "contents" to the end of the
+    // list (the copy is freed like any other contents)
+    int (*add_inline)(struct ConcurrentList*, void*, int);
+};
+
+typedef struct ConcurrentList* ConcurrentList;
+
+
+
+// Nodes of a lock free queue are just like the nodes of a LinkedList,
+// except that their links are atomic.
+struct QueueNode {
+    void* contents;
+
+    _Atomic(struct QueueNode*) next;
+};
+
+// A lock free queue is a Michael-Scott queue : a linked list with a dummy
+// node at its head, where threads add nodes at the tail and remove them
+// from the head using compare-and-swap instead of locks. Removed nodes are
+// only freed once no thread holds a hazard pointer to them.
+struct LockFreeQueue {
+    // Stores pointer to the dummy node before the first node in the queue
+    // (on its own cache line, since consumers write it)
+    _Alignas(64) _Atomic(struct QueueNode*) head;
+
+    // Stores pointer to the last (or second to last) node in the queue
+    // (on its own cache line, since producers write it)
+    _Alignas(64) _Atomic(struct QueueNode*) tail;
+
+    // Stores length of queue (which may change as soon as it is read)
+    _Alignas(64) _Atomic int length;
+
+    // Stores whether teardown frees the contents left in the queue (1 by
+    // default)
+    int auto_free;
+
+    // Add a new node with contents "contents" to the end of the queue
+    int (*enqueue)(struct LockFreeQueue*, void*);
+
+    // Remove the first node from the queue, handing its contents over to
+    // the caller (returns NULL if the queue is empty)
+    void* (*dequeue)(struct LockFreeQueue*);
+
+    // Free the queue, all of its nodes, AND ALL OF THEIR CONTENTS (unless
+    // auto_free is turned off). This is NOT thread safe, and may only be
+    // called once no other thread is using the queue.
+    int (*teardown)(struct LockFreeQueue*);
+
+    // Free the queue and all of its nodes, without freeing their contents
+    // (this is NOT thread safe either).
+    int (*teardown_keep)(struct LockFreeQueue*);
+};
+
+typedef struct LockFreeQueue* LockFreeQueue;
+
+// Every thread using a lock free queue owns a hazard record. Before a
+// thread reads a node which another thread could remove, it publishes
+// the node in one of its hazard pointers. Removed nodes are retired
+// rather than freed, and are only freed once no hazard pointer points to
+// them.
+struct HazardRecord {
+    // Stores the nodes this thread is currently reading
+    _Atomic(void*) hazards[2];
+
+    // Stores whether a thread owns this record (records are reused once
+    // their thread exits)
+    _Atomic int active;
+
+    // Stores pointer to the next record (records are never freed, so
+    // this never changes once the record is published)
+    struct HazardRecord* next;
+
+    // Stores the nodes retired by this thread which are not yet freed
+    void** retired;
+    int num_retired;
+    int retired_capacity;
+};
+
+
+
+struct DoublyLinkedList {
+    // Stores length of list
+    int length;
+
+    // Stores pointer to head node - the first node in the list
+    struct DoublyNode* head;
+
+    // Stores pointer to tail node - the last node in the list
+    struct DoublyNode* tail;
+
+    // Stores pointer to the allocator the list and its nodes are allocated from
+    struct Allocator* allocator;
+
+    // Stores whether delete and teardown free the contents they remove
+    // (1 by default). Set this to 0 once for a list whose contents are
+    // owned elsewhere.
+    int auto_free;
+
+    // Add a new node with contents "contents" to the end of the list
+    int (*add)(struct DoublyLinkedList*, void*);
+
+    // Insert a new node with contents "contents" into a given index in
+    // the list (starting from whichever end is closer)
+    int (*insert)(struct DoublyLinkedList*, int, void*);
+
+    // Get a pointer to the contents of a node from its index in the
+    // list, starting from whichever end is closer (returns NULL on
+    // failure)
+    void* (*get)(struct DoublyLinkedList*, int);
+
+    // Get a pointer to the contents of a node from its index in the
+    // list (returns pointer to default data on failure).
+    void* (*get_or_default)(struct DoublyLinkedList*, int, void*);
+
+    // Delete a node at a given index from the list, freeing its contents (unless
+    // auto_free is turned off).
+    int (*delete)(struct DoublyLinkedList*, int);
+
+    // Delete a node at a given index from the list, without freeing its contents.
+    int (*delete_keep)(struct DoublyLinkedList*, int);
+
+    // Free the list, all of its nodes, AND ALL OF THEIR CONTENTS (unless
+    // auto_free is turned off).
+    int (*teardown)(struct DoublyLinkedList*);
+
+    // Free the list and all of its nodes, without freeing their contents.
+    int (*teardown_keep)(struct DoublyLinkedList*);
+
+    // Add a new node with contents "contents" to the front of the list
+    int (*push_front)(struct DoublyLinkedList*, void*);
+
+    // Remove the first node from the list, handing its contents over to
+    // the caller (returns NULL if the list is empty)
+    void* (*pop_front)(struct DoublyLinkedList*);
+
+    // Remove the last node from the list, handing its contents over to
+    // the caller (returns NULL if the list is empty)
+    void* (*pop_back)(struct DoublyLinkedList*);
+
+    // Add a copy of num_bytes bytes of "contents" to the end of the
+    // list (the copy is freed like any other contents)
+    int (*add_inline)(struct DoublyLinkedList*, void*, int);
+};
+
+typedef struct DoublyLinkedList* DoublyLinkedList;
+
+struct DoublyNode {
+    void* contents;
+
+    struct DoublyNode* prev;
+
+    struct DoublyNode* next;
+};
+
+typedef struct DoublyNode* DoublyNode;
+
+
+
+// Nodes in a skip list have between 1 and this many levels
+#define SKIP_LIST_MAX_LEVEL 32
+
+struct SkipList {
+    // Stores length of list
+    int length;
+
+    // Stores the number of levels in use (the height of the tallest node)
+    int level;
+
+    // Stores pointer to the head node, which has SKIP_LIST_MAX_LEVEL levels
+    // and no contents
+    struct SkipNode* head;
+
+    // Stores pointers to the pools that nodes are allocated from, one for
+    // each node height (each pool is created the first time a node of its
+    // height is needed)
+    struct NodePool* pools[SKIP_LIST_MAX_LEVEL];
+
+    // Stores pointer to the allocator the list, its head, and its pools are allocated from
+    struct Allocator* allocator;
+
+    // Stores whether delete and teardown free the contents they remove
+    // (1 by default). Set this to 0 once for a list whose contents are
+    // owned elsewhere.
+    int auto_free;
+
+    // Stores the state of the random number generator used to pick the
+    // height of new nodes
+    unsigned long long random_state;
+
+    // Compares the contents of two nodes, returning a negative number, 0,
+    // or a positive number if the first is less than, equal to, or greater
+    // than the second (just like strcmp)
+    int (*compare)(void*, void*);
+
+    // Insert a new node with contents "contents" into the list, after any
+    // nodes with equal contents, so that the list stays sorted
+    int (*insert_sorted)(struct SkipList*, void*);
+
+    // Get the index of the first node with contents equal to "contents"
+    // (returns -1 if there is none)
+    int (*find)(struct SkipList*, void*);
+
+    // Get a pointer to the contents of a node from its index in 
+    // the list (returns NULL on failure)
+    void* (*get)(struct SkipList*, int);
+
+    // Get a pointer to the contents of a node from its index in 
+    // the list (returns pointer to default data on failure).
+    void* (*get_or_default)(struct SkipList*, int, void*);
+
+    // Delete a node at a given index from the list, freeing its contents (unless
+    // auto_free is turned off).
+    int (*delete)(struct SkipList*, int);
+
+    // Delete a node at a given index from the list, without freeing its contents.
+    int (*delete_keep)(struct SkipList*, int);
+
+    // Free the list, all of its nodes, AND ALL OF THEIR CONTENTS (unless
+    // auto_free is turned off).
+    int (*teardown)(struct SkipList*);
+
+    // Free the list and all of its nodes, without freeing their contents.
+    int (*teardown_keep)(struct SkipList*);
+};
+
+typedef struct SkipList* SkipList;
+
+// Each level of a skip list node links to the next node with at least that
+// many levels, and stores how many positions in the list that link skips
+// over (its span). Adding up the spans along a search gives the index of
+// the node that was reached.
+struct SkipLevel {
+    struct SkipNode* next;
+
+    int span;
+};
+
+struct SkipNode {
+    void* contents;
+
+    int height;
+
+    struct SkipLevel levels[];
+};
+
+
+
+// A double ended queue stored in a circular array. The contents start at
+// head and wrap around the end of the array, and since the capacity is
+// always a power of two, the position of index i is (head + i) & (capacity
+// - 1).
+struct RingDeque {
+    // Stores length of deque (the number of contents in use)
+    int length;
+
+    // Stores the number of contents the array has room for (0, or a power
+    // of two)
+    int capacity;
+
+    // Stores the position of the first contents in the array
+    int head;
+
+    // Stores pointer to the circular array of contents
+    void** contents;
+
+    // Stores pointer to the allocator the deque and its array are allocated from
+    struct Allocator* allocator;
+
+    // Stores whether teardown frees the contents left in the deque (1 by
+    // default). Set this to 0 once for a deque whose contents are owned
+    // elsewhere. Popped contents always belong to the caller.
+    int auto_free;
+
+    // Add new contents "contents" to the back of the deque (amortized
+    // O(1))
+    int (*push_back)(struct RingDeque*, void*);
+
+    // Add new contents "contents" to the front of the deque (amortized
+    // O(1))
+    int (*push_front)(struct RingDeque*, void*);
+
+    // Remove the first contents from the deque, handing them over to the
+    // caller (returns NULL if the deque is empty)
+    void* (*pop_front)(struct RingDeque*);
+
+    // Remove the last contents from the deque, handing them over to the
+    // caller (returns NULL if the deque is empty)
+    void* (*pop_back)(struct RingDeque*);
+
+    // Get a pointer to the contents at an index in the deque, counting
+    // from the front (returns NULL on failure)
+    void* (*get)(struct RingDeque*, int);
+
+    // Get a pointer to the contents at an index in the deque (returns
+    // pointer to default data on failure).
+    void* (*get_or_default)(struct RingDeque*, int, void*);
+
+    // Add num_contents contents from an array to the back of the deque,
+    // in order, copying them in at most two pieces
+    int (*push_n)(struct RingDeque*, void**, int);
+
+    // Remove up to num_contents contents from the front of the deque into
+    // an array, in order, handing them over to the caller (returns the
+    // number removed)
+    int (*pop_n)(struct RingDeque*, void**, int);
+
+    // Make sure the deque has room for at least a given number of
+    // contents without growing again
+    int (*reserve)(struct RingDeque*, int);
+
+    // Free the deque AND ALL OF ITS CONTENTS (unless auto_free is turned
+    // off).
+    int (*teardown)(struct RingDeque*);
+
+    // Free the deque, without freeing its contents.
+    int (*teardown_keep)(struct RingDeque*);
+};
+
+typedef struct RingDeque* RingDeque;
+
+
+
+// A priority queue stored as a d-ary heap in an array: the children of the
+// contents at position i are at positions arity * i + 1 to arity * i +
+// arity. Wider heaps are shallower, and keep each set of children together
+// in one or two cache lines.
+//
+// Each contents pushed can be given a handle, an int which stays the same
+// while the contents move around the heap, so that decrease_key can find
+// them again. Handles are reused once their contents are popped.
+struct PriorityQueue {
+    // Stores length of queue (the number of contents in the heap)
+    int length;
+
+    // Stores the number of contents the arrays have room for
+    int capacity;
+
+    // Stores the number of children of each position in the heap (at least 2)
+    int arity;
+
+    // Stores pointer to the heap of contents, smallest first
+    void** contents;
+
+    // Stores the handle of the contents at each position in the heap
+    int* handles;
+
+    // Stores the position in the heap of the contents with each handle.
+    // Handles which are not in use hold -2 - the next unused handle (so
+    // that they are negative), forming a list starting from free_handle.
+    int* positions;
+
+    // Stores the number of handles ever given out (handles at or past this
+    // have never been used), and the first unused handle before that (or -1)
+    int num_handles;
+    int free_handle;
+
+    // Stores pointer to the allocator the queue and its arrays are allocated from
+    struct Allocator* allocator;
+
+    // Stores whether teardown frees the contents left in the queue (1 by
+    // default). Set this to 0 once for a queue whose contents are owned
+    // elsewhere. Popped contents always belong to the caller.
+    int auto_free;
+
+    // Compares two contents, returning a negative number, 0, or a
+    // positive number if the first is less than, equal to, or greater
+    // than the second (just like strcmp). The smallest contents are
+    // popped first.
+    int (*compare)(void*, void*);
+
+    // Add new contents "contents" to the queue in O(log n), storing its
+    // handle in the int pointed to (unless it is NULL)
+    int (*push)(struct PriorityQueue*, void*, int*);
+
+    // Remove the smallest contents from the queue in O(log n), handing
+    // them over to the caller (returns NULL if the queue is empty)
+    void* (*pop)(struct PriorityQueue*);
+
+    // Get a pointer to the smallest contents in the queue without
+    // removing them (returns NULL if the queue is empty)
+    void* (*peek)(struct PriorityQueue*);
+
+    // Add num_contents contents from an array to the queue, and rebuild
+    // the heap in O(n), storing their handles in an array (unless it is
+    // NULL)
+    int (*heapify)(struct PriorityQueue*, void**, int, int*);
+
+    // Add the contents of every node in a list to the queue, and rebuild
+    // the heap in O(n), storing their handles in an array (unless it is
+    // NULL). The list is left as it was.
+    int (*heapify_list)(struct PriorityQueue*, struct LinkedList*, int*);
+
+    // Move the contents with a given handle up the heap, after they were
+    // changed to compare smaller (returns 0 if the handle is not in use)
+    int (*decrease_key)(struct PriorityQueue*, int);
+
+    // Make sure the queue has room for at least a given number of
+    // contents without growing again
+    int (*reserve)(struct PriorityQueue*, int);
+
+    // Free the queue AND ALL OF ITS CONTENTS (unless auto_free is turned
+    // off).
+    int (*teardown)(struct PriorityQueue*);
+
+    // Free the queue, without freeing its contents.
+    int (*teardown_keep)(struct PriorityQueue*);
+};
+
+typedef struct PriorityQueue* PriorityQueue;
+
+
+
+// Nodes in a B+tree hold up to this many keys (16 keys fill two 64 byte
+// cache lines)
+#define BTREE_NODE_KEYS 16
+
+// Every node of a B+tree starts with its keys, kept apart from its children
+// or values, so that searching a node only reads its keys.
+struct BTreeNode {
+    void* keys[BTREE_NODE_KEYS];
+
+    int num_keys;
+
+    int is_leaf;
+};
+
+// Leaves hold the keys and values of the map, and are linked to the leaves
+// on either side of them, so that ranges can be read without going back up
+// the tree.
+struct BTreeLeaf {
+    struct BTreeNode node;
+
+    void* values[BTREE_NODE_KEYS];
+
+    struct BTreeLeaf* prev;
+    struct BTreeLeaf* next;
+};
+
+// Internal nodes hold num_keys + 1 children. Every key in children[i] is
+// smaller than keys[i], and every key in children[i + 1] is at least
+// keys[i] (each of these keys is also the first key of some leaf).
+struct BTreeInternal {
+    struct BTreeNode node;
+
+    struct BTreeNode* children[BTREE_NODE_KEYS + 1];
+};
+
+// Iterators walk along the leaves of a B+tree, forwards or backwards, until
+// they pass a bound (or the end of the map).
+struct BTreeIterator {
+    // Stores pointer to the map being iterated over
+    struct BTreeMap* map;
+
+    // Stores pointer to the leaf, and the index in it, of the key that
+    // next will return (leaf is NULL once there are no more)
+    struct BTreeLeaf* leaf;
+    int index;
+
+    // Stores the key last returned by next (NULL before the first call)
+    void* key;
+
+    // Stores the last key the iterator may return (if bounded is set), and
+    // whether the iterator walks backwards
+    void* bound;
+    int bounded;
+    int reverse;
+
+    // Check whether there is another key for next to return
+    int (*has_next)(struct BTreeIterator*);
+
+    // Move to the next key in the range, store it in key, and return its
+    // value
+    void* (*next)(struct BTreeIterator*);
+};
+
+// An ordered map of keys to values, stored in a B+tree. Its nodes come from
+// two pools (one for leaves, one for internal nodes).
+struct BTreeMap {
+    // Stores the number of keys in the map
+    int length;
+
+    // Stores pointer to the root of the tree (a leaf while the map is
+    // small)
+    struct BTreeNode* root;
+
+    // Stores pointers to the pools that leaves and internal nodes are
+    // allocated from
+    struct NodePool* leaf_pool;
+    struct NodePool* internal_pool;
+
+    // Stores pointer to the allocator the map and its pools are allocated from
+    struct Allocator* allocator;
+
+    // Compares two keys, returning a negative number, 0, or a positive
+    // number if the first is less than, equal to, or greater than the
+    // second (just like strcmp)
+    int (*compare)(void*, void*);
+
+    // Stores whether keys are owned (and freed) by the map (1 by default).
+    int free_keys;
+
+    // Stores whether values are owned (and freed) by the map (1 by
+    // default).
+    int free_values;
+
+    // Add a key with a value to the map, or replace the value of a key
+    // already in the map (freeing the replaced key and value, if they are
+    // owned by the map)
+    int (*put)(struct BTreeMap*, void*, void*);
+
+    // Get the value of a key in the map (returns NULL on failure)
+    void* (*get)(struct BTreeMap*, void*);
+
+    // Get the value of a key in the map (returns pointer to default
+    // data on failure)
+    void* (*get_or_default)(struct BTreeMap*, void*, void*);
+
+    // Remove a key and its value from the map (freeing them, if they are
+    // owned by the map)
+    int (*remove)(struct BTreeMap*, void*);
+
+    // Remove a key and its value from the map, without freeing them
+    int (*remove_keep)(struct BTreeMap*, void*);
+
+    // Fill an empty map from arrays of num_keys keys (in strictly
+    // increasing order) and their values in O(n), packing the leaves full
+    int (*bulk_load)(struct BTreeMap*, void**, void**, int);
+
+    // Get an iterator over every key in the map, in increasing order
+    struct BTreeIterator (*begin)(struct BTreeMap*);
+
+    // Get an iterator over every key in the map, in decreasing order
+    struct BTreeIterator (*begin_reverse)(struct BTreeMap*);
+
+    // Get an iterator over the keys from "from" to "to" (inclusive), in
+    // increasing order
+    struct BTreeIterator (*range)(struct BTreeMap*, void*, void*);
+
+    // Get an iterator over the keys from "to" down to "from" (inclusive),
+    // in decreasing order
+    struct BTreeIterator (*range_reverse)(struct BTreeMap*, void*, void*);
+
+    // Free the map, AND ALL OF ITS KEYS AND VALUES (if they are owned by
+    // the map).
+    int (*teardown)(struct BTreeMap*);
+
+    // Free the map, without freeing its keys and values.
+    int (*teardown_keep)(struct BTreeMap*);
+};
+
+typedef struct BTreeMap* BTreeMap;
+
+
+
+// The kinds of node in a radix tree. Inner nodes come in four sizes, and
+// grow into the next size up when they run out of room (or shrink into the
+// next size down when they get small).
+#define RADIX_LEAF 0
+#define RADIX_NODE4 1
+#define RADIX_NODE16 2
+#define RADIX_NODE48 3
+#define RADIX_NODE256 4
+
+// Inner nodes of a radix tree store up to this many bytes of their prefix.
+// Longer prefixes are skipped over on the way down, and checked against
+// the full key stored in a leaf instead.
+#define RADIX_MAX_PREFIX 12
+
+// Every inner node of a radix tree starts with this header. A node holds
+// the keys which share the bytes before it (and its prefix), and branches
+// on the byte after its prefix. A key which ends right after the prefix is
+// kept in leaf, rather than under a child.
+struct RadixNode {
+    unsigned char type;
+
+    unsigned short num_children;
+
+    // Stores the length of the prefix (which may be more than the
+    // RADIX_MAX_PREFIX bytes that are stored)
+    int prefix_length;
+    unsigned char prefix[RADIX_MAX_PREFIX];
+
+    struct RadixLeaf* leaf;
+};
+
+// Leaves hold a copy of their whole key, and its value. Children of inner
+// nodes may be leaves or inner nodes, which are told apart by their type.
+struct RadixLeaf {
+    unsigned char type;
+
+    int key_length;
+
+    void* value;
+
+    unsigned char key[];
+};
+
+// Node4 and Node16 keep the bytes of their children sorted in an array,
+// next to an array of the children themselves
+struct RadixNode4 {
+    struct RadixNode node;
+
+    unsigned char keys[4];
+
+    struct RadixNode* children[4];
+};
+
+struct RadixNode16 {
+    struct RadixNode node;
+
+    unsigned char keys[16];
+
+    struct RadixNode* children[16];
+};
+
+// Node48 maps every byte to the index of its child plus one (or 0, if the
+// byte has no child)
+struct RadixNode48 {
+    struct RadixNode node;
+
+    unsigned char child_index[256];
+
+    struct RadixNode* children[48];
+};
+
+// Node256 has a child pointer for every byte
+struct RadixNode256 {
+    struct RadixNode node;
+
+    struct RadixNode* children[256];
+};
+
+// A map from byte strings to values, stored in an adaptive radix tree. Keys
+// are found in O(key length), however many keys there are, and keys with a
+// common prefix are stored together, so they can be found by that prefix.
+struct RadixTree {
+    // Stores the number of keys in the tree
+    int length;
+
+    // Stores pointer to the root of the tree (NULL when the tree is
+    // empty, or a single leaf when it has one key)
+    struct RadixNode* root;
+
+    // Stores pointers to the pools that inner nodes of each size are
+    // allocated from (pools[type - 1])
+    struct NodePool* pools[4];
+
+    // Stores pointer to the allocator the tree, its pools and its leaves
+    // are allocated from
+    struct Allocator* allocator;
+
+    // Stores whether values are owned (and freed) by the tree (1 by
+    // default). Keys are always copied into the tree.
+    int free_values;
+
+    // Add a key of key_length bytes with a value to the tree, or replace
+    // the value of a key already in the tree (freeing the replaced value,
+    // if it is owned by the tree)
+    int (*put)(struct RadixTree*, void*, int, void*);
+
+    // Get the value of a key in the tree (returns NULL on failure)
+    void* (*get)(struct RadixTree*, void*, int);
+
+    // Get the value of a key in the tree (returns pointer to default data
+    // on failure)
+    void* (*get_or_default)(struct RadixTree*, void*, int, void*);
+
+    // Remove a key and its value from the tree (freeing the value, if it
+    // is owned by the tree)
+    int (*remove)(struct RadixTree*, void*, int);
+
+    // Remove a key and its value from the tree, without freeing the value
+    int (*remove_keep)(struct RadixTree*, void*, int);
+
+    // Get the value of the longest key in the tree which is a prefix of a
+    // given key, storing that key's length in the int pointed to (unless
+    // it is NULL). Returns NULL if no key in the tree is a prefix.
+    void* (*longest_prefix)(struct RadixTree*, void*, int, int*);
+
+    // Call fn(key, key_length, value, ctx) for every key in the tree
+    // starting with a given prefix, in order (returns the number of keys)
+    int (*prefix_foreach)(struct RadixTree*, void*, int, void (*)(void*, int, void*, void*), void*);
+
+    // Free the tree AND ALL OF ITS VALUES (if they are owned by the
+    // tree).
+    int (*teardown)(struct RadixTree*);
+
+    // Free the tree, without freeing its values.
+    int (*teardown_keep)(struct RadixTree*);
+};
+
+typedef struct RadixTree* RadixTree;
+
+
+
+// The list_parallel_* functions split a list into chunks of consecutive
+// nodes, and run the chunks on a small pool of threads. Each thread starts
+// with its own share of the chunks, and once it runs out, it steals chunks
+// from the back of the other threads' shares.
+struct ParallelChunk {
+    // Stores pointer to the first node of the chunk, and how many nodes
+    // the chunk has
+    struct Node* first;
+    int count;
+
+    // Stores the nodes produced for this chunk (by map and filter), which
+    // are stitched onto the result list in order
+    struct Node* head;
+    struct Node* tail;
+    int length;
+
+    // Stores the result of reducing this chunk
+    void* result;
+
+    // Stores whether a node could not be allocated for this chunk
+    int failed;
+};
+
+// The chunks still to be run by one thread are the indices in [bottom,
+// top). The owner takes chunks from the bottom, and thieves from the top.
+struct WorkStealingDeque {
+    pthread_mutex_t lock;
+
+    int bottom;
+    int top;
+};
+
+struct ParallelJob {
+    struct ParallelChunk* chunks;
+
+    struct WorkStealingDeque* deques;
+    int num_workers;
+
+    // Runs fn on every node of a chunk
+    void (*process)(struct ParallelJob*, struct ParallelChunk*);
+
+    // Stores the function passed to map, filter, or reduce (only one of
+    // these is set), and the context passed along to every call
+    void* (*map)(void*, void*);
+    int (*filter)(void*, void*);
+    void* (*reduce)(void*, void*, void*);
+    void* ctx;
+};
+
+// Each thread running a job is passed its job and its index
+struct ParallelWorker {
+    struct ParallelJob* job;
+    int index;
+};
+
 
 
 // Create a linked list using a set of functions defined for the
 // pointers in the above struct
 LinkedList createLinkedList();
 
+// Create a linked list which allocates itself and its nodes from the given
+// allocator.
+LinkedList createLinkedListWithAllocator(Allocator allocator);
+
+// Create a linked list which allocates its nodes from its own pool,
+// with room for capacity_hint nodes in the pool's first slab.
+LinkedList createLinkedListWithPool(int capacity_hint);
+
+// Create a linked list which allocates its nodes from a pool that can
+// be shared with other lists. The list holds a reference to the pool, and
+// is allocated from the pool's allocator.
+LinkedList createLinkedListFromPool(NodePool pool);
+
+// Create an unrolled linked list which stores up to block_size contents
+// in each of its nodes (block_size must be at least 2).
+UnrolledList createUnrolledList(int block_size);
+UnrolledList createUnrolledListWithAllocator(int block_size, Allocator allocator);
+
+// Create an empty vector (a growable contiguous array of contents).
+Vector createVector();
+Vector createVectorWithAllocator(Allocator allocator);
+
+// Create an empty hash map, which uses hash and equals to hash and compare
+// its keys.
+HashMap createHashMap(unsigned long long (*hash)(void*), int (*equals)(void*, void*));
+HashMap createHashMapWithAllocator(unsigned long long (*hash)(void*), int (*equals)(void*, void*), Allocator allocator);
+
+// Create an empty hash map with C string keys.
+HashMap createStringHashMap();
+
+// Create an empty hash map with 64 bit integer keys (stored directly in
+// the key pointers, see int_key() below).
+HashMap createIntHashMap();
+
+// Hash and equality functions for C string keys and integer keys
+unsigned long long hash_string(void*);
+int equals_string(void*, void*);
+unsigned long long hash_int(void*);
+int equals_int(void*, void*);
+
+// Create an empty list which can be used by many threads at once.
+ConcurrentList createConcurrentList();
+ConcurrentList createConcurrentListWithAllocator(Allocator allocator);
+
+// Create an empty lock free queue, which can be used by many producer
+// and consumer threads at once. (Its nodes are always allocated with
+// malloc, since they are freed by whichever thread last reads them.)
+LockFreeQueue createLockFreeQueue();
+
+// Create an empty doubly linked list, which can also be used as a deque.
+DoublyLinkedList createDoublyLinkedList();
+DoublyLinkedList createDoublyLinkedListWithAllocator(Allocator allocator);
+
+// Create an empty skip list, kept sorted with the given comparator.
+SkipList createSkipList(int (*compare)(void*, void*));
+SkipList createSkipListWithAllocator(int (*compare)(void*, void*), Allocator allocator);
+
+// Create an empty deque stored in a circular array.
+RingDeque createRingDeque();
+RingDeque createRingDequeWithAllocator(Allocator allocator);
+
+// Create an empty priority queue, kept as a heap with arity children per
+// position (4 is a good default) using the given comparator.
+PriorityQueue createPriorityQueue(int (*compare)(void*, void*), int arity);
+PriorityQueue createPriorityQueueWithAllocator(int (*compare)(void*, void*), int arity, Allocator allocator);
+
+// Create an empty ordered map, stored in a B+tree, which uses compare to
+// order its keys.
+BTreeMap createBTreeMap(int (*compare)(void*, void*));
+BTreeMap createBTreeMapWithAllocator(int (*compare)(void*, void*), Allocator allocator);
+
+// Create an empty radix tree, mapping byte strings to values.
+RadixTree createRadixTree();
+RadixTree createRadixTreeWithAllocator(Allocator allocator);
+
+// Create a pool handing out nodes of node_size bytes, with room for
+// capacity_hint nodes in the first slab. The caller holds a reference
+// to the pool, which is dropped with pool->teardown(pool).
+NodePool createNodePool(size_t node_size, int capacity_hint);
+NodePool createNodePoolWithAllocator(size_t node_size, int capacity_hint, Allocator allocator);
+
+// Create an allocator which hands out memory from blocks of block_size
+// bytes (or bigger, for bigger allocations), one after the other. Freeing
+// does nothing, and all of the memory is freed at once on teardown. This
+// is not thread safe.
+Allocator createBumpAllocator(size_t block_size);
+
+// Create an allocator which keeps memory freed by each thread in a cache
+// of its own (by size), and reuses it for the next allocations of that
+// size by that thread, without calling malloc. This is thread safe.
+Allocator createCachingAllocator();
+
+
+
+// Call fn on the contents of every node in a list, in order, passing
+// ctx along to every call. This is defined here so that the compiler can
+// inline fn into the loop.
+static inline void list_foreach(struct LinkedList* list, void (*fn)(void*, void*), void* ctx) {
+    for(struct Node* node = list->head; node != NULL; node = node->next)
+        fn(node->contents, ctx);
+}
+
+
+
+// Create a new list holding fn(contents, ctx) for the contents of every
+// node in a list, in order, running fn on num_threads threads. The new list
+// owns whatever fn returns (returns NULL on failure).
+LinkedList list_parallel_map(struct LinkedList* list, void* (*fn)(void*, void*), void* ctx, int num_threads);
+
+// Create a new list holding the contents of every node in a list for which
+// fn(contents, ctx) is not 0, in order, running fn on num_threads threads.
+// The contents are shared with the original list (returns NULL on failure).
+LinkedList list_parallel_filter(struct LinkedList* list, int (*fn)(void*, void*), void* ctx, int num_threads);
+
+// Combine the contents of every node in a list, in order, with fn(left,
+// right, ctx), starting from initial, running fn on num_threads threads.
+// fn must be associative, since chunks of the list are combined separately
+// (so its results must be the same kind of value as the contents).
+void* list_parallel_reduce(struct LinkedList* list, void* (*fn)(void*, void*, void*), void* initial, void* ctx, int num_threads);
+
+
+
+// Get counts of what a list has done since it was created (these are all 0
+// unless the library is built with -DDS_STATS).
+struct ListStats list_get_stats(struct LinkedList* list);
+
+// Write the counts of what a list has done to a stream, as a JSON object.
+// Returns 0 on failure, 1 on success.
+int list_dump_stats(struct LinkedList* list, FILE* stream);
+
+// Write the contents of every node in a list to a file, as a count followed
+// by the size and bytes of each contents. element_size gives the number of
+// bytes in a (non NULL) contents. Returns 0 on failure, 1 on success.
+int list_serialize(struct LinkedList* list, int fd, size_t (*element_size)(void*));
+
+// Load a list written by list_serialize by mapping the file into memory.
+// The contents of the new list point straight into the mapping, and are
+// never freed (returns NULL on failure).
+LinkedList list_deserialize(int fd);
+
 
 
 // This allows for a pointer with a given type to be obtained
@@ -117,53 +1601,236 @@ LinkedList createLinkedList();
 
 
 
-// This is used for getting the number of arguments passed to 
-int get_num_args(char*);
+// This allows a 64 bit integer to be used as a key in a hash map
+// created with createIntHashMap()
+#define int_key(value)({\
+    ((void*) (long long) (value));\
+})
+
+
+
+// Works out the number of bytes for the copy macros below at compile time :
+// the number of bytes given, or sizeof(contents) if none is given. Passing
+// more than one number of bytes fails to compile.
+#define copy_num_bytes(macro, contents, ...) ({\
+    __VA_OPT__(_Static_assert(sizeof((char[]) {__VA_ARGS__}) == 1, "Too many arguments (>1) passed to list macro " macro "()");)\
+    \
+    first_copy_arg(__VA_ARGS__ __VA_OPT__(,) sizeof(contents));\
+})
+
+#define first_copy_arg(first, ...) (first)
 
 
 
+// Adds a copy of the data pointed to by contents (sizeof(contents) bytes, or
+// the number of bytes given) to the end of a list. Linked lists store the
+// copy inline in the new node, so each copy costs a single allocation.
 #define add_copy(list, contents, ...) ({\
-    int num_va_args = get_num_args(#__VA_ARGS__);\
+    int num_bytes = copy_num_bytes("add_copy", contents __VA_OPT__(,) __VA_ARGS__);\
     \
-    assertf(num_va_args <= 1, "Too many arguments (>1) passed to list macro add_copy().\n");\
+    list->add_inline(list, contents, num_bytes);\
+})
+
+// Inserts a copy of the data pointed to by contents (sizeof(contents) bytes,
+// or the number of bytes given) into a list at a given index. The copy is
+// freed like any other contents (returns 0 on failure).
+#define insert_copy(list, index, contents, ...) ({\
+    int num_bytes = copy_num_bytes("insert_copy", contents __VA_OPT__(,) __VA_ARGS__);\
     \
-    int num_bytes = 0;\
+    assertf(num_bytes > 0, "Invalid number of bytes (%d) passed to list macro insert_copy().\n", num_bytes);\
     \
-    if(num_va_args > 0) {\
-        __VA_OPT__(num_bytes = __VA_ARGS__); /*evaluate and expand the expression here*/\
-        assertf(num_bytes > 0, "Invalid argument \"%s\" (evaluates to %d) passed to list macro add_copy() for num_bytes (argument 3).\n", num_va_args, num_bytes);\
-    }\
+    void* copy = malloc((size_t) num_bytes);\
+    int inserted = copy != NULL;\
     \
-    else {\
-        num_bytes = sizeof(contents);\
+    if(inserted) {\
+        memcpy(copy, contents, num_bytes);\
+        inserted = list->insert(list, index, copy);\
+        \
+        if(!inserted)\
+            free(copy);\
     }\
     \
-    void* copy = malloc((unsigned int)num_bytes);\
-    memcpy(copy, contents, num_bytes);\
-    \
-    list->add(list,copy);\
+    inserted;\
 })
 
-#define insert_copy(list, contents, ...) ({\
-    int num_va_args = get_num_args(#__VA_ARGS__);\
-    \
-    assertf(num_va_args <= 1, "Too many arguments (>1) passed to list macro insert_copy().\n");\
-    \
-    int num_bytes = 0;\
-    \
-    if(num_va_args > 0) {\
-        __VA_OPT__(num_bytes = __VA_ARGS__); /*evaluate and expand the expression here*/\
-        assertf(num_bytes > 0, "Invalid argument \"%s\" (evaluates to %d) passed to list macro insert_copy() for num_bytes (argument 3).\n", num_va_args, num_bytes);\
+
+// Defines a list of values of one type, stored by value in a single array,
+// for small plain old data types (ints, doubles, small structs). Unlike the
+// structures above, there is no pointer or heap allocation per value, so a
+// list of int32_t costs 4 bytes per value rather than a node plus the value.
+// Every function is static inline, and the values can be read straight out
+// of list->values, so loops over them can be inlined and vectorized. For
+// example,
+//
+//     DS_DEFINE_LIST(int32, int32_t)
+//
+// defines struct int32_list (and int32_list, a pointer to one), along with
+// int32_list_create(), int32_list_add(), int32_list_get(), and so on. Values
+// are copied in and out, and are never freed.
+#define DS_DEFINE_LIST(name, type)\
+\
+struct name##_list {\
+    /* Stores the values in the list, one after another */\
+    type* values;\
+\
+    /* Stores the number of values, and the number there is room for */\
+    int length;\
+    int capacity;\
+\
+    /* Stores pointer to the allocator the list and its array are allocated from */\
+    struct Allocator* allocator;\
+};\
+\
+typedef struct name##_list* name##_list;\
+\
+/* Resizes the array to hold capacity values (returns 0 on failure) */\
+static inline int name##_list_resize(struct name##_list* list, int capacity) {\
+    if(capacity == 0) {\
+        deallocate(list->allocator, list->values);\
+        list->values = NULL;\
+        list->capacity = 0;\
+        return 1;\
     }\
-    \
-    else {\
-        num_bytes = sizeof(contents);\
+\
+    type* values = (type*) reallocate(list->allocator, list->values, (size_t) list->capacity * sizeof(type), (size_t) capacity * sizeof(type));\
+\
+    if(values == NULL)\
+        return 0;\
+\
+    list->values = values;\
+    list->capacity = capacity;\
+\
+    return 1;\
+}\
+\
+/* Create an empty list which gets its memory from an allocator (returns NULL on failure) */\
+static inline struct name##_list* name##_list_create_with_allocator(Allocator allocator) {\
+    assertf(allocator != NULL, "Tried to create a " #name " list with a NULL Allocator.\n");\
+\
+    struct name##_list* list = (struct name##_list*) allocate(allocator, sizeof(struct name##_list));\
+\
+    if(list == NULL)\
+        return NULL;\
+\
+    list->values = NULL;\
+    list->length = 0;\
+    list->capacity = 0;\
+    list->allocator = allocator;\
+\
+    return list;\
+}\
+\
+/* Create an empty list (returns NULL on failure) */\
+static inline struct name##_list* name##_list_create() {\
+    return name##_list_create_with_allocator(&stdlib_allocator);\
+}\
+\
+/* Make sure the list has room for capacity values (returns 0 on failure) */\
+static inline int name##_list_reserve(struct name##_list* list, int capacity) {\
+    if(capacity <= list->capacity)\
+        return 1;\
+\
+    return name##_list_resize(list, capacity);\
+}\
+\
+/* Give any unused room in the array back to the allocator (returns 0 on failure) */\
+static inline int name##_list_shrink_to_fit(struct name##_list* list) {\
+    if(list->length == list->capacity)\
+        return 1;\
+\
+    return name##_list_resize(list, list->length);\
+}\
+\
+/* Add a value to the end of the list (returns 0 on failure) */\
+static inline int name##_list_add(struct name##_list* list, type value) {\
+    if(list->length == list->capacity) {\
+        if(!name##_list_resize(list, list->capacity < 8 ? 8 : list->capacity * 2))\
+            return 0;\
     }\
-    \
-    void* copy = malloc((unsigned int)num_bytes);\
-    memcpy(copy, contents, num_bytes);\
-    \
-    list->add(list,copy);\
-})
+\
+    list->values[list->length++] = value;\
+\
+    return 1;\
+}\
+\
+/* Add count values from an array to the end of the list (returns 0 on failure) */\
+static inline int name##_list_add_many(struct name##_list* list, const type* values, int count) {\
+    if(list->length + count > list->capacity) {\
+        int capacity = list->capacity < 8 ? 8 : list->capacity * 2;\
+\
+        if(!name##_list_resize(list, capacity < list->length + count ? list->length + count : capacity))\
+            return 0;\
+    }\
+\
+    if(count > 0)\
+        memcpy(list->values + list->length, values, (size_t) count * sizeof(type));\
+\
+    list->length += count;\
+\
+    return 1;\
+}\
+\
+/* Insert a value at a given index, shifting the values after it up by one (returns 0 on failure) */\
+static inline int name##_list_insert(struct name##_list* list, int index, type value) {\
+    if(index < 0 || index > list->length)\
+        return 0;\
+\
+    if(list->length == list->capacity) {\
+        if(!name##_list_resize(list, list->capacity < 8 ? 8 : list->capacity * 2))\
+            return 0;\
+    }\
+\
+    memmove(list->values + index + 1, list->values + index, (size_t) (list->length - index) * sizeof(type));\
+\
+    list->values[index] = value;\
+    list->length++;\
+\
+    return 1;\
+}\
+\
+/* Get the value at a given index (which must exist) */\
+static inline type name##_list_get(struct name##_list* list, int index) {\
+    assertf(index >= 0 && index < list->length, "Tried to get index %d of a " #name " list of length %d.\n", index, list->length);\
+\
+    return list->values[index];\
+}\
+\
+/* Get the value at a given index (returns _default if the index does not exist) */\
+static inline type name##_list_get_or_default(struct name##_list* list, int index, type _default) {\
+    if(index < 0 || index >= list->length)\
+        return _default;\
+\
+    return list->values[index];\
+}\
+\
+/* Replace the value at a given index (returns 0 if the index does not exist) */\
+static inline int name##_list_set(struct name##_list* list, int index, type value) {\
+    if(index < 0 || index >= list->length)\
+        return 0;\
+\
+    list->values[index] = value;\
+\
+    return 1;\
+}\
+\
+/* Delete the value at a given index, shifting the values after it down by one (returns 0 on failure) */\
+static inline int name##_list_delete(struct name##_list* list, int index) {\
+    if(index < 0 || index >= list->length)\
+        return 0;\
+\
+    memmove(list->values + index, list->values + index + 1, (size_t) (list->length - index - 1) * sizeof(type));\
+\
+    list->length--;\
+\
+    return 1;\
+}\
+\
+/* Free the list and its array */\
+static inline int name##_list_teardown(struct name##_list* list) {\
+    deallocate(list->allocator, list->values);\
+    deallocate(list->allocator, list);\
+\
+    return 1;\
+}
 
 #endif
\ No newline at end of file
@@ -152,6 +152,6 @@ int main(int argc, char** argv) {
 
 
     // destroy the list
-    //list->teardown(list, NO_AUTO_FREE);
+    //list->teardown_keep(list);
     list->teardown(list);
 }
\ No newline at end of file